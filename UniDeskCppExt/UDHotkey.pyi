@@ -0,0 +1,41 @@
+from typing import Callable
+
+import UniDeskCppExt.UDHotkey
+
+# Event kinds in (id, kind, timestamp_ns) tuples; timestamp_ns is on the
+# time.monotonic_ns() clock.
+ACTIVATED: int
+RELEASED: int
+
+# On X11 the hotkeys use an X connection of their own with detectable
+# auto-repeat, so releases are reported as they happen and Qt's own key events
+# are unaffected. QHOTKEY_DETECTABLE_AUTOREPEAT=0 in the environment before the
+# first register() reports releases through a 50 ms timer instead.
+def isSupported() -> bool: ...
+
+# shortcut: a QKeySequence string such as "Ctrl+Alt+K". Raises ValueError if
+# it cannot be registered, including when called from another thread while
+# the QGuiApplication event loop is not running. Requires a QGuiApplication.
+def register(shortcut: str, activated: Callable[[], object] | None = None,
+             released: Callable[[], object] | None = None) -> int: ...
+
+def unregister(id: int) -> bool: ...
+
+# Queued events, oldest first, without blocking. poll() and wait() raise
+# RuntimeError while start() is dispatching.
+def poll(max: int = 256) -> list[tuple[int, int, int]]: ...
+
+# Block until an event is queued or timeout seconds pass.
+def wait(timeout: float | None = None, max: int = 256) -> list[tuple[int, int, int]]: ...
+
+# Deliver events on a background thread, one GIL acquisition per batch:
+# handler (if any) gets the whole batch, then the per-hotkey callbacks run.
+# Raises RuntimeError while another thread is in poll() or wait().
+def start(handler: Callable[[list[tuple[int, int, int]]], object] | None = None) -> None: ...
+
+# Callable from a handler or callback too: the rest of that batch is still
+# delivered, later events stay queued for the next start() or poll().
+def stop() -> None: ...
+
+# Events lost because the queue was full.
+def dropped() -> int: ...
@@ -0,0 +1,47 @@
+from typing import Callable, Literal, overload
+
+from collections.abc import Buffer
+
+import UniDeskCppExt.UDTools
+
+class MappedFile:
+    @property
+    def path(self) -> str: ...
+    def __len__(self) -> int: ...
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+
+# Raises ValueError if path cannot be mapped: missing files, and every file of
+# size 0, which includes /proc and sysfs files whatever they hold. Read those.
+def mapFile(path: str) -> memoryview: ...
+
+def removeTree(path: str, progress: Callable[[int], bool | None] | None = None) -> bool: ...
+
+def htmlToText(html: str) -> str: ...
+
+def htmlToTexts(htmls: list[str]) -> list[str]: ...
+
+def platformInfo() -> dict[str, str | int | bool]: ...
+
+def uuid() -> str: ...
+
+@overload
+def uuids(count: int, raw: Literal[False] = False) -> list[str]: ...
+@overload
+def uuids(count: int, raw: Literal[True]) -> list[bytes]: ...
+
+# pixels: any C-contiguous uint8 buffer of shape (height, width, 3) holding RGB
+# or (height, width, 4) holding RGBA, e.g. a numpy array; read without copying.
+@overload
+def imagePalette(path: str, count: int = 5) -> list[tuple[tuple[int, int, int], float]]: ...
+@overload
+def imagePalette(pixels: Buffer, count: int = 5) -> list[tuple[tuple[int, int, int], float]]: ...
+
+def imageMainColor(pixels: Buffer, bright: float = 1.0) -> tuple[int, int, int] | None: ...
+
+def imageAverageColor(pixels: Buffer, step: int = 1, bright: float = 1.0) -> tuple[int, int, int] | None: ...
+
+def hashFile(path: str, algorithm: str = "sha256") -> str: ...
+
+def hashFiles(paths: list[str], algorithm: str = "sha256") -> list[str]: ...
+
+def hashBytes(data: bytes | bytearray | memoryview, algorithm: str = "sha256") -> str: ...
@@ -0,0 +1,21 @@
+"""The C++ extension for Uniquenium.
+
+Submodules are imported on first attribute access, so importing the package
+loads no Qt library, and each submodule only loads the ones it links.
+"""
+
+import importlib
+
+__all__ = ["UDFrameless", "UDHotkey", "UDTools"]
+
+
+def __getattr__(name):
+    if name in __all__:
+        module = importlib.import_module(f".{name}", __name__)
+        globals()[name] = module
+        return module
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+
+
+def __dir__():
+    return sorted(set(globals()) | set(__all__))
@@ -1 +1,3 @@
-import UniDeskCppExt.UDFrameless as UDFrameless
\ No newline at end of file
+import UniDeskCppExt.UDFrameless as UDFrameless
+import UniDeskCppExt.UDTools as UDTools
+import UniDeskCppExt.UDHotkey as UDHotkey
\ No newline at end of file
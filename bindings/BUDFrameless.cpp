@@ -3,7 +3,7 @@
 #include<pybind11/pybind11.h>
 
 namespace py=pybind11;
-PYBIND11_MODULE(UDFrameless, mod) {
+PYBIND11_MODULE(UDFrameless, mod, py::mod_gil_not_used()) {
     mod.doc() = "cxxtestpy module";
     mod.def("setWindowEffect",&setWindowEffect,py::arg("hwnd"),py::arg("key"),py::arg("enable"));
 
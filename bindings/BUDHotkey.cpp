@@ -0,0 +1,326 @@
+#include <UDHotkey.h>
+#include<pybind11/pybind11.h>
+#include<pybind11/stl.h>
+
+#include <QCoreApplication>
+#include <QKeySequence>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace py=pybind11;
+
+namespace {
+
+struct Callbacks {
+    py::object activated;
+    py::object released;
+};
+
+// The module runs without the GIL on free-threaded builds, so nothing here
+// may rely on it. Neither mutex is held across a call into Python or the
+// release of a Python object, which could re-enter this module.
+struct DispatchState {
+    // Guards callbacks and batchHandler.
+    std::mutex mutex;
+    std::unordered_map<int, Callbacks> callbacks;
+    py::object batchHandler;
+
+    // Guards the dispatcher thread and consumers; held across start() and
+    // stop(). The ring has either a dispatcher or poll()/wait() callers.
+    std::mutex controlMutex;
+    std::thread dispatcher;
+    std::shared_ptr<HotkeyEventRing> dispatcherRing;
+    // Each dispatcher thread gets its own flag, so one that was detached by
+    // stop() from a callback cannot be revived by a later start().
+    std::shared_ptr<std::atomic<bool>> dispatcherStop;
+    int consumers = 0;
+
+    // Serialises consumers of the ring; never taken while holding the GIL.
+    std::mutex drainMutex;
+};
+
+// Never destroyed: the py::objects in it must not be released after the
+// interpreter is gone. stopDispatch() empties it from an atexit hook.
+DispatchState& state()
+{
+    static auto* dispatchState = new DispatchState;
+    return *dispatchState;
+}
+
+constexpr std::size_t maxBatch = 256;
+
+// Lock mutex without holding the GIL while waiting for it, so a thread that
+// owns it can still take the GIL on the way out.
+std::unique_lock<std::mutex> lockReleasingGil(std::mutex& mutex)
+{
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        py::gil_scoped_release release;
+        lock.lock();
+    }
+    return lock;
+}
+
+// Held by poll() and wait() while they use the ring.
+class ConsumerGuard {
+public:
+    ConsumerGuard()
+    {
+        DispatchState& dispatch = state();
+        const auto control = lockReleasingGil(dispatch.controlMutex);
+        if (dispatch.dispatcher.joinable()) {
+            throw std::runtime_error("poll() and wait() cannot be used while start() is dispatching; call stop() first");
+        }
+        ++dispatch.consumers;
+    }
+    ~ConsumerGuard()
+    {
+        DispatchState& dispatch = state();
+        const auto control = lockReleasingGil(dispatch.controlMutex);
+        --dispatch.consumers;
+    }
+    ConsumerGuard(const ConsumerGuard&) = delete;
+    ConsumerGuard& operator=(const ConsumerGuard&) = delete;
+};
+
+} // namespace
+
+static LingmoHotkeys* hotkeys()
+{
+    if (!QCoreApplication::instance()) {
+        throw std::runtime_error("UDHotkey needs a QGuiApplication running its event loop");
+    }
+    return LingmoHotkeys::getInstance();
+}
+
+// Called without the GIL.
+static std::vector<HotkeyEvent> drainEvents(HotkeyEventRing& ring, std::size_t max)
+{
+    std::vector<HotkeyEvent> batch;
+    std::lock_guard<std::mutex> lock(state().drainMutex);
+    ring.drain(batch, max);
+    return batch;
+}
+
+static py::list eventList(const std::vector<HotkeyEvent>& batch)
+{
+    py::list result;
+    for (const HotkeyEvent& event : batch) {
+        result.append(py::make_tuple(event.id, int(event.kind), event.timestamp));
+    }
+    return result;
+}
+
+// One pass over a drained batch, under a single GIL acquisition. Exceptions
+// from callbacks are reported as unraisable so later events still run.
+static void deliver(const std::vector<HotkeyEvent>& batch)
+{
+    DispatchState& dispatch = state();
+    py::object handler;
+    std::vector<py::object> calls;
+    {
+        const auto lock = lockReleasingGil(dispatch.mutex);
+        handler = dispatch.batchHandler;
+        for (const HotkeyEvent& event : batch) {
+            const auto it = dispatch.callbacks.find(event.id);
+            if (it == dispatch.callbacks.end()) {
+                continue;
+            }
+            const py::object& callback = event.kind == HotkeyEvent::Activated ? it->second.activated : it->second.released;
+            if (!callback.is_none()) {
+                calls.push_back(callback);
+            }
+        }
+    }
+    if (handler) {
+        try {
+            handler(eventList(batch));
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable("UDHotkey batch handler");
+        }
+    }
+    for (const py::object& callback : calls) {
+        try {
+            callback();
+        } catch (py::error_already_set& e) {
+            e.discard_as_unraisable("UDHotkey callback");
+        }
+    }
+}
+
+static int registerHotkey(const std::string& shortcut, const py::object& activated, const py::object& released)
+{
+    LingmoHotkeys* hub = hotkeys();
+    const QKeySequence sequence(QString::fromStdString(shortcut));
+    QString error;
+    int id = -1;
+    {
+        // add() hops to the Qt thread, which may itself be waiting for the GIL.
+        py::gil_scoped_release release;
+        id = hub->add(sequence, &error);
+    }
+    if (id < 0) {
+        throw py::value_error(error.toStdString());
+    }
+    DispatchState& dispatch = state();
+    const auto lock = lockReleasingGil(dispatch.mutex);
+    dispatch.callbacks[id] = { activated, released };
+    return id;
+}
+
+static bool unregisterHotkey(int id)
+{
+    LingmoHotkeys* hub = hotkeys();
+    bool removed = false;
+    {
+        py::gil_scoped_release release;
+        removed = hub->remove(id);
+    }
+    DispatchState& dispatch = state();
+    Callbacks callbacks; // released after the lock
+    const auto lock = lockReleasingGil(dispatch.mutex);
+    if (const auto it = dispatch.callbacks.find(id); it != dispatch.callbacks.end()) {
+        callbacks = std::move(it->second);
+        dispatch.callbacks.erase(it);
+    }
+    return removed;
+}
+
+static py::list pollRing(HotkeyEventRing& ring, std::size_t max)
+{
+    std::vector<HotkeyEvent> batch;
+    {
+        py::gil_scoped_release release;
+        batch = drainEvents(ring, max);
+    }
+    return eventList(batch);
+}
+
+static py::list pollEvents(std::size_t max)
+{
+    const std::shared_ptr<HotkeyEventRing> ring = hotkeys()->events();
+    const ConsumerGuard consumer;
+    return pollRing(*ring, max);
+}
+
+// Sleeps without the GIL, waking every 100 ms so Ctrl+C still works.
+static py::list waitEvents(std::optional<double> timeout, std::size_t max)
+{
+    const std::shared_ptr<HotkeyEventRing> ring = hotkeys()->events();
+    const ConsumerGuard consumer;
+    const auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::milliseconds(qint64(timeout.value_or(0) * 1000));
+    for (;;) {
+        int slice = 100;
+        if (timeout) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            slice = int(std::clamp<qint64>(left.count(), 0, 100));
+        }
+        bool ready = false;
+        {
+            py::gil_scoped_release release;
+            ready = ring->wait(slice);
+        }
+        if (ready || (timeout && std::chrono::steady_clock::now() >= deadline)) {
+            break;
+        }
+        if (PyErr_CheckSignals() != 0) {
+            throw py::error_already_set();
+        }
+    }
+    return pollRing(*ring, max);
+}
+
+static void dispatchLoop(std::shared_ptr<HotkeyEventRing> ring, std::shared_ptr<std::atomic<bool>> stop)
+{
+    while (!*stop) {
+        ring->wait();
+        const std::vector<HotkeyEvent> batch = drainEvents(*ring, maxBatch);
+        if (batch.empty() || *stop) {
+            continue;
+        }
+        py::gil_scoped_acquire gil;
+        deliver(batch);
+    }
+}
+
+static void startDispatch(const py::object& handler)
+{
+    DispatchState& dispatch = state();
+    LingmoHotkeys* hub = hotkeys();
+    py::object previous; // released after the locks
+    const auto control = lockReleasingGil(dispatch.controlMutex);
+    if (dispatch.consumers > 0) {
+        throw std::runtime_error("start() cannot be used while poll() or wait() is in progress");
+    }
+    {
+        const auto lock = lockReleasingGil(dispatch.mutex);
+        previous = std::exchange(dispatch.batchHandler, handler.is_none() ? py::object() : handler);
+    }
+    if (dispatch.dispatcher.joinable()) {
+        return;
+    }
+    dispatch.dispatcherRing = hub->events();
+    dispatch.dispatcherStop = std::make_shared<std::atomic<bool>>(false);
+    dispatch.dispatcher = std::thread(&dispatchLoop, dispatch.dispatcherRing, dispatch.dispatcherStop);
+}
+
+static void stopDispatch()
+{
+    DispatchState& dispatch = state();
+    py::object previous; // released after the locks
+    const auto control = lockReleasingGil(dispatch.controlMutex);
+    if (dispatch.dispatcher.joinable()) {
+        *dispatch.dispatcherStop = true;
+        if (dispatch.dispatcher.get_id() == std::this_thread::get_id()) {
+            // Called from a callback, on the dispatcher itself: it cannot be
+            // joined, and leaves its loop once the callbacks return. It is
+            // not waiting on the ring, so there is nothing to interrupt.
+            dispatch.dispatcher.detach();
+        } else {
+            dispatch.dispatcherRing->interrupt();
+            {
+                py::gil_scoped_release release;
+                dispatch.dispatcher.join();
+            }
+            dispatch.dispatcherRing->resume();
+        }
+        dispatch.dispatcherRing.reset();
+        dispatch.dispatcherStop.reset();
+    }
+    const auto lock = lockReleasingGil(dispatch.mutex);
+    previous = std::move(dispatch.batchHandler);
+}
+
+PYBIND11_MODULE(UDHotkey, mod, py::mod_gil_not_used()) {
+    mod.doc() = "System-wide hotkeys (QHotkey) with batched event delivery";
+    mod.attr("ACTIVATED") = int(HotkeyEvent::Activated);
+    mod.attr("RELEASED") = int(HotkeyEvent::Released);
+    mod.def("isSupported",&LingmoHotkeys::isSupported);
+    mod.def("register",&registerHotkey,py::arg("shortcut"),py::arg("activated")=py::none(),py::arg("released")=py::none());
+    mod.def("unregister",&unregisterHotkey,py::arg("id"));
+    mod.def("poll",&pollEvents,py::arg("max")=maxBatch);
+    mod.def("wait",&waitEvents,py::arg("timeout")=py::none(),py::arg("max")=maxBatch);
+    mod.def("start",&startDispatch,py::arg("handler")=py::none());
+    mod.def("stop",&stopDispatch);
+    mod.def("dropped",[] { return hotkeys()->events()->dropped(); });
+
+    py::module_::import("atexit").attr("register")(py::cpp_function([] {
+        stopDispatch();
+        std::unordered_map<int, Callbacks> callbacks; // released after the lock
+        DispatchState& dispatch = state();
+        const auto lock = lockReleasingGil(dispatch.mutex);
+        callbacks.swap(dispatch.callbacks);
+    }));
+}
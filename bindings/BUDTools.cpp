@@ -0,0 +1,296 @@
+#include <UDHash.h>
+#include <UDHtmlText.h>
+#include <UDImageColor.h>
+#include <UDMappedFile.h>
+#include <UDPlatform.h>
+#include <UDRemoveTree.h>
+#include <UDUuid.h>
+#include<pybind11/pybind11.h>
+#include<pybind11/stl.h>
+
+#include <chrono>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace py=pybind11;
+
+using PyColor = std::tuple<int, int, int>;
+using PyPaletteColor = std::pair<PyColor, double>;
+
+// A QImage over the pixels of a uint8 HxWx3 (RGB) or HxWx4 (RGBA) buffer such
+// as a numpy array. Nothing is copied: the image is only valid while info is.
+// Rows may be padded, but each row must be packed pixels.
+static QImage wrapImageBuffer(const py::buffer_info& info)
+{
+    if (info.format != py::format_descriptor<unsigned char>::format() || info.ndim != 3
+        || (info.shape[2] != 3 && info.shape[2] != 4)) {
+        throw py::value_error("expected a uint8 buffer of shape (height, width, 3 or 4)");
+    }
+    const py::ssize_t height = info.shape[0];
+    const py::ssize_t width = info.shape[1];
+    const py::ssize_t channels = info.shape[2];
+    if ((channels > 1 && info.strides[2] != 1) || (width > 1 && info.strides[1] != channels)
+        || (height > 1 && info.strides[0] < width * channels)) {
+        throw py::value_error("expected a C-contiguous image buffer");
+    }
+    if (width == 0 || height == 0) {
+        return QImage();
+    }
+    const qsizetype bytesPerLine = height > 1 ? qsizetype(info.strides[0]) : qsizetype(width * channels);
+    return QImage(static_cast<const uchar*>(info.ptr), int(width), int(height), bytesPerLine,
+        channels == 3 ? QImage::Format_RGB888 : QImage::Format_RGBA8888);
+}
+
+static std::optional<PyColor> toPyColor(const QColor& color)
+{
+    if (!color.isValid()) {
+        return std::nullopt;
+    }
+    return PyColor { color.red(), color.green(), color.blue() };
+}
+
+static std::vector<PyPaletteColor> toPyPalette(const QList<PaletteColor>& palette)
+{
+    std::vector<PyPaletteColor> result;
+    for (const PaletteColor& entry : palette) {
+        result.push_back({ { entry.color.red(), entry.color.green(), entry.color.blue() }, entry.weight });
+    }
+    return result;
+}
+
+static std::vector<PyPaletteColor> imagePalette(const std::string& path, int count)
+{
+    const QImage image(QString::fromStdString(path));
+    return toPyPalette(extractPalette(image, count));
+}
+
+static std::vector<PyPaletteColor> bufferPalette(const py::buffer& pixels, int count)
+{
+    const py::buffer_info info = pixels.request();
+    const QImage image = wrapImageBuffer(info);
+    py::gil_scoped_release release;
+    return toPyPalette(extractPalette(image, count));
+}
+
+static std::optional<PyColor> bufferAverageColor(const py::buffer& pixels, int step, double bright)
+{
+    const py::buffer_info info = pixels.request();
+    const QImage image = wrapImageBuffer(info);
+    py::gil_scoped_release release;
+    return toPyColor(averageImageColor(image, step, bright));
+}
+
+static HashAlgorithm algorithmFromName(const std::string& name)
+{
+    const std::optional<HashAlgorithm> algorithm = hashAlgorithmFromName(QString::fromStdString(name));
+    if (!algorithm) {
+        throw py::value_error("unknown hash algorithm: " + name);
+    }
+    return *algorithm;
+}
+
+static std::string hashFileHex(const std::string& path, const std::string& algorithm)
+{
+    const HashAlgorithm algo = algorithmFromName(algorithm);
+    py::gil_scoped_release release;
+    return hashFile(QString::fromStdString(path), algo).toHex().toStdString();
+}
+
+static std::vector<std::string> hashFilesHex(const std::vector<std::string>& paths, const std::string& algorithm)
+{
+    const HashAlgorithm algo = algorithmFromName(algorithm);
+    QStringList list;
+    for (const std::string& path : paths) {
+        list.append(QString::fromStdString(path));
+    }
+    std::vector<std::string> result;
+    {
+        py::gil_scoped_release release;
+        for (const QByteArray& digest : hashFiles(list, algo)) {
+            result.push_back(digest.toHex().toStdString());
+        }
+    }
+    return result;
+}
+
+// Hashes any C-contiguous buffer (bytes, bytearray, memoryview, numpy) in
+// place, without copying it into a Python bytes object first.
+static std::string hashBytesHex(const py::buffer& data, const std::string& algorithm)
+{
+    const HashAlgorithm algo = algorithmFromName(algorithm);
+    const py::buffer_info info = data.request();
+    py::ssize_t expected = info.itemsize;
+    for (py::ssize_t dim = info.ndim - 1; dim >= 0; --dim) {
+        if (info.shape[dim] > 1 && info.strides[dim] != expected) {
+            throw py::value_error("hashBytes requires a C-contiguous buffer");
+        }
+        expected *= info.shape[dim];
+    }
+    const auto size = qsizetype(info.size * info.itemsize);
+    py::gil_scoped_release release;
+    return hashBytes(QByteArrayView(static_cast<const char*>(info.ptr), size), algo).toHex().toStdString();
+}
+
+// A read-only memoryview straight over the mapping. The view holds a reference
+// to the MappedFile, so the file stays mapped until the last view is released.
+static py::memoryview mapFileView(const std::string& path)
+{
+    std::shared_ptr<const MappedFile> mapped;
+    {
+        py::gil_scoped_release release;
+        mapped = mapFile(QString::fromStdString(path));
+    }
+    if (!mapped) {
+        throw py::value_error("cannot map file: " + path);
+    }
+    return py::memoryview(py::cast(std::const_pointer_cast<MappedFile>(mapped)));
+}
+
+// Removal runs on its own thread; this one keeps the GIL free except for the
+// periodic progress callback. A callback returning False, or Ctrl+C, cancels.
+static bool removeTreeWithProgress(const std::string& path, const py::object& progress)
+{
+    RemoveTreeState state;
+    std::promise<bool> result;
+    std::future<bool> finished = result.get_future();
+    std::thread worker([&] {
+        result.set_value(removeTree(QString::fromStdString(path), state));
+    });
+
+    // Woken as soon as the removal ends, or every 100 ms for progress.
+    auto wait = [&finished] {
+        py::gil_scoped_release release;
+        return finished.wait_for(std::chrono::milliseconds(100)) == std::future_status::ready;
+    };
+    bool interrupted = false;
+    while (!wait()) {
+        if (state.cancelled) {
+            continue;
+        }
+        if (PyErr_CheckSignals() != 0) {
+            interrupted = true;
+            state.cancelled = true;
+            continue;
+        }
+        if (!progress.is_none()) {
+            try {
+                const py::object keepGoing = progress(qint64(state.removed));
+                if (!keepGoing.is_none() && !keepGoing.cast<bool>()) {
+                    state.cancelled = true;
+                }
+            } catch (...) {
+                state.cancelled = true;
+                py::gil_scoped_release release;
+                worker.join();
+                throw;
+            }
+        }
+    }
+    {
+        py::gil_scoped_release release;
+        worker.join();
+    }
+    if (interrupted) {
+        throw py::error_already_set();
+    }
+    if (!progress.is_none()) {
+        progress(qint64(state.removed));
+    }
+    return finished.get();
+}
+
+static std::string htmlToText(const std::string& html)
+{
+    return htmlToPlainText(QString::fromStdString(html)).toStdString();
+}
+
+static std::vector<std::string> htmlToTexts(const std::vector<std::string>& htmls)
+{
+    QStringList list;
+    list.reserve(qsizetype(htmls.size()));
+    for (const std::string& html : htmls) {
+        list.append(QString::fromStdString(html));
+    }
+    std::vector<std::string> result;
+    result.reserve(htmls.size());
+    for (const QString& text : htmlToPlainTexts(list)) {
+        result.push_back(text.toStdString());
+    }
+    return result;
+}
+
+// raw=True gives 16-byte bytes objects instead of 32-digit hex strings.
+static py::list uuidList(qsizetype count, bool raw)
+{
+    QByteArray bytes;
+    {
+        py::gil_scoped_release release;
+        bytes = uuidBytes(count);
+    }
+    py::list result;
+    for (qsizetype offset = 0; offset < bytes.size(); offset += 16) {
+        const char* uuid = bytes.constData() + offset;
+        if (raw) {
+            result.append(py::bytes(uuid, 16));
+            continue;
+        }
+        char hex[32];
+        uuidToHex(reinterpret_cast<const uchar*>(uuid), hex);
+        result.append(py::str(hex, 32));
+    }
+    return result;
+}
+
+static py::dict platformDict()
+{
+    py::dict dict;
+    const QVariantMap map = platformInfoToVariant(platformInfo());
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        const QVariant& value = it.value();
+        const py::str key(it.key().toStdString());
+        switch (value.typeId()) {
+        case QMetaType::Bool:
+            dict[key] = value.toBool();
+            break;
+        case QMetaType::Int:
+            dict[key] = value.toInt();
+            break;
+        default:
+            dict[key] = value.toString().toStdString();
+            break;
+        }
+    }
+    return dict;
+}
+
+PYBIND11_MODULE(UDTools, mod, py::mod_gil_not_used()) {
+    mod.doc() = "LingmoTools utilities";
+    py::class_<MappedFile, std::shared_ptr<MappedFile>>(mod, "MappedFile", py::buffer_protocol())
+        .def_property_readonly("path", [](const MappedFile& self) { return self.path().toStdString(); })
+        .def("__len__", &MappedFile::size)
+        .def_buffer([](MappedFile& self) {
+            return py::buffer_info(const_cast<char*>(self.data()), 1, py::format_descriptor<unsigned char>::format(), 1,
+                { py::ssize_t(self.size()) }, { py::ssize_t(1) }, true);
+        });
+    mod.def("mapFile",&mapFileView,py::arg("path"));
+    mod.def("htmlToText",&htmlToText,py::arg("html"),py::call_guard<py::gil_scoped_release>());
+    mod.def("htmlToTexts",&htmlToTexts,py::arg("htmls"),py::call_guard<py::gil_scoped_release>());
+    mod.def("platformInfo",&platformDict);
+    mod.def("uuid",[] { return uuidHex().toStdString(); });
+    mod.def("uuids",&uuidList,py::arg("count"),py::arg("raw")=false);
+    mod.def("removeTree",&removeTreeWithProgress,py::arg("path"),py::arg("progress")=py::none());
+    mod.def("imagePalette",&imagePalette,py::arg("path"),py::arg("count")=5,
+        py::call_guard<py::gil_scoped_release>());
+    mod.def("imagePalette",&bufferPalette,py::arg("pixels"),py::arg("count")=5);
+    mod.def("imageMainColor",[](const py::buffer& pixels, double bright) {
+        return bufferAverageColor(pixels, mainColorStep, bright);
+    },py::arg("pixels"),py::arg("bright")=1.0);
+    mod.def("imageAverageColor",&bufferAverageColor,py::arg("pixels"),py::arg("step")=1,py::arg("bright")=1.0);
+    mod.def("hashFile",&hashFileHex,py::arg("path"),py::arg("algorithm")="sha256");
+    mod.def("hashFiles",&hashFilesHex,py::arg("paths"),py::arg("algorithm")="sha256");
+    mod.def("hashBytes",&hashBytesHex,py::arg("data"),py::arg("algorithm")="sha256");
+}
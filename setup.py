@@ -150,6 +150,6 @@ setup(
     cmdclass={"build_ext": CMakeBuild},
     packages=["UniDeskCppExt"],
     zip_safe=False,
-    extras_require={"test": ["pytest>=6.0"]},
+    extras_require={"test": ["pytest>=6.0", "numpy", "pytest-benchmark", "xxhash"]},
     python_requires=">=3.7",
 )
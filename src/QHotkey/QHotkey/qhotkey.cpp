@@ -5,6 +5,7 @@
 #include <QMetaMethod>
 #include <QThread>
 #include <QDebug>
+#include <utility>
 
 Q_LOGGING_CATEGORY(logQHotkey, "QHotkey")
 
@@ -27,6 +28,11 @@ bool QHotkey::isPlatformSupported()
 	return QHotkeyPrivate::isPlatformSupported();
 }
 
+QList<bool> QHotkey::registerAll(const QList<QHotkey*> &hotkeys)
+{
+	return QHotkeyPrivate::instance()->addShortcuts(hotkeys);
+}
+
 QHotkey::QHotkey(QObject *parent) :
 	QObject(parent),
 	_keyCode(Qt::Key_unknown),
@@ -185,6 +191,8 @@ bool QHotkey::setRegistered(bool registered)
 {
 	if(_registered && !registered)
 		return QHotkeyPrivate::instance()->removeShortcut(this);
+	if(!_registered && !registered)
+		QHotkeyPrivate::instance()->forgetLostShortcut(this);
 	if(!_registered && registered) {
 		if(!_nativeShortcut.isValid())
 			return false;
@@ -246,6 +254,23 @@ bool QHotkeyPrivate::addShortcut(QHotkey *hotkey)
 	return res;
 }
 
+QList<bool> QHotkeyPrivate::addShortcuts(const QList<QHotkey*> &hotkeys)
+{
+	// a single thread hop for the whole batch
+	Qt::ConnectionType conType = (QThread::currentThread() == thread() ?
+									  Qt::DirectConnection :
+									  Qt::BlockingQueuedConnection);
+	QList<bool> res;
+	if(!QMetaObject::invokeMethod(this, [&] { res = addShortcutsInvoked(hotkeys); }, conType))
+		return QList<bool>(hotkeys.size(), false);
+
+	for(int i = 0; i < hotkeys.size(); ++i) {
+		if(res[i])
+			emit hotkeys[i]->registeredChanged(true);
+	}
+	return res;
+}
+
 bool QHotkeyPrivate::removeShortcut(QHotkey *hotkey)
 {
 	if(!hotkey->_registered)
@@ -266,18 +291,42 @@ bool QHotkeyPrivate::removeShortcut(QHotkey *hotkey)
 	return res;
 }
 
+void QHotkeyPrivate::forgetLostShortcut(QHotkey *hotkey)
+{
+	// not blocking: queued ahead of any later keymap refresh anyway
+	QMetaObject::invokeMethod(this, [this, hotkey] {
+		lostShortcuts.removeIf([hotkey](const LostShortcut &lost) { return lost.hotkey == hotkey; });
+	}, QThread::currentThread() == thread() ? Qt::DirectConnection : Qt::QueuedConnection);
+}
+
 void QHotkeyPrivate::activateShortcut(QHotkey::NativeShortcut shortcut)
 {
-	QMetaMethod signal = QMetaMethod::fromSignal(&QHotkey::activated);
-	for(QHotkey *hkey : shortcuts.values(shortcut))
-		signal.invoke(hkey, Qt::QueuedConnection);
+	dispatchShortcut(shortcut, &QHotkey::activated);
 }
 
 void QHotkeyPrivate::releaseShortcut(QHotkey::NativeShortcut shortcut)
 {
-	QMetaMethod signal = QMetaMethod::fromSignal(&QHotkey::released);
-	for(QHotkey *hkey : shortcuts.values(shortcut))
-		signal.invoke(hkey, Qt::QueuedConnection);
+	dispatchShortcut(shortcut, &QHotkey::released);
+}
+
+void QHotkeyPrivate::dispatchShortcut(QHotkey::NativeShortcut shortcut, void (QHotkey::*signal)(QHotkey::QPrivateSignal))
+{
+	// Hotkeys living on this thread are signalled in place, without allocating
+	// a queued call each. Their slots may add or remove hotkeys: the slot count
+	// is fixed up front and removed listeners read as nullptr until the table
+	// compacts after the outermost dispatch.
+	shortcuts.beginDispatch();
+	const int end = shortcuts.slotCount(shortcut);
+	for(int i = 0; i < end; ++i) {
+		QHotkey *hkey = shortcuts.listener(shortcut, i);
+		if(!hkey)
+			continue;
+		if(hkey->thread() == QThread::currentThread())
+			emit (hkey->*signal)(QHotkey::QPrivateSignal());
+		else
+			QMetaMethod::fromSignal(signal).invoke(hkey, Qt::QueuedConnection);
+	}
+	shortcuts.endDispatch();
 }
 
 void QHotkeyPrivate::addMappingInvoked(Qt::Key keycode, Qt::KeyboardModifiers modifiers, QHotkey::NativeShortcut nativeShortcut)
@@ -289,7 +338,7 @@ bool QHotkeyPrivate::addShortcutInvoked(QHotkey *hotkey)
 {
 	QHotkey::NativeShortcut shortcut = hotkey->_nativeShortcut;
 
-	if(!shortcuts.contains(shortcut)) {
+	if(shortcuts.count(shortcut) == 0) {
 		if(!registerShortcut(shortcut)) {
 			qCWarning(logQHotkey) << QHotkey::tr("Failed to register %1. Error: %2").arg(hotkey->shortcut().toString(), error);
 			return false;
@@ -301,11 +350,64 @@ bool QHotkeyPrivate::addShortcutInvoked(QHotkey *hotkey)
 	return true;
 }
 
+QList<bool> QHotkeyPrivate::addShortcutsInvoked(const QList<QHotkey*> &hotkeys)
+{
+	// native shortcuts no hotkey listens on yet, each once
+	QVector<QHotkey::NativeShortcut> pending;
+	QHash<QHotkey::NativeShortcut, int> pendingIndex;
+	for(QHotkey *hotkey : hotkeys) {
+		const QHotkey::NativeShortcut shortcut = hotkey->_nativeShortcut;
+		if(hotkey->_registered || !shortcut.isValid())
+			continue;
+		if(shortcuts.count(shortcut) == 0 && !pendingIndex.contains(shortcut)) {
+			pendingIndex.insert(shortcut, int(pending.size()));
+			pending.append(shortcut);
+		}
+	}
+
+	QStringList errors;
+	const QVector<bool> registered = pending.isEmpty() ?
+										 QVector<bool>() :
+										 registerShortcuts(pending, errors);
+
+	QList<bool> res;
+	res.reserve(hotkeys.size());
+	for(QHotkey *hotkey : hotkeys) {
+		const QHotkey::NativeShortcut shortcut = hotkey->_nativeShortcut;
+		if(hotkey->_registered || !shortcut.isValid()) {
+			res.append(false);
+			continue;
+		}
+		const auto it = pendingIndex.constFind(shortcut);
+		if(it != pendingIndex.constEnd() && !registered[*it]) {
+			qCWarning(logQHotkey) << QHotkey::tr("Failed to register %1. Error: %2").arg(hotkey->shortcut().toString(), errors[*it]);
+			res.append(false);
+			continue;
+		}
+		shortcuts.insert(shortcut, hotkey);
+		hotkey->_registered = true;
+		res.append(true);
+	}
+	return res;
+}
+
+QVector<bool> QHotkeyPrivate::registerShortcuts(const QVector<QHotkey::NativeShortcut> &nativeShortcuts, QStringList &errors)
+{
+	QVector<bool> res;
+	res.reserve(nativeShortcuts.size());
+	for(QHotkey::NativeShortcut shortcut : nativeShortcuts) {
+		error.clear();
+		res.append(registerShortcut(shortcut));
+		errors.append(error);
+	}
+	return res;
+}
+
 bool QHotkeyPrivate::removeShortcutInvoked(QHotkey *hotkey)
 {
 	QHotkey::NativeShortcut shortcut = hotkey->_nativeShortcut;
 
-	if(shortcuts.remove(shortcut, hotkey) == 0)
+	if(!shortcuts.remove(shortcut, hotkey))
 		return false;
 	hotkey->_registered = false;
 	emit hotkey->registeredChanged(true);
@@ -319,6 +421,60 @@ bool QHotkeyPrivate::removeShortcutInvoked(QHotkey *hotkey)
 	return true;
 }
 
+void QHotkeyPrivate::remapShortcuts()
+{
+	// hotkeys lost on an earlier change, unless they were deleted, registered
+	// again or given another key since
+	const QVector<LostShortcut> lost = std::exchange(lostShortcuts, {});
+	for(const LostShortcut &entry : lost) {
+		QHotkey *hotkey = entry.hotkey;
+		if(!hotkey || hotkey->_registered ||
+		   hotkey->_keyCode != entry.keyCode || hotkey->_modifiers != entry.modifiers)
+			continue;
+		if(remapShortcut(hotkey, hotkey->_nativeShortcut)) {
+			hotkey->_registered = true;
+			emit hotkey->registeredChanged(true);
+		}
+	}
+
+	for(QHotkey *hotkey : shortcuts.hotkeys()) {
+		// hotkeys set from a native shortcut have no key to map again
+		if(hotkey->_keyCode == Qt::Key_unknown)
+			continue;
+		const QHotkey::NativeShortcut current = hotkey->_nativeShortcut;
+		if(nativeShortcutInvoked(hotkey->_keyCode, hotkey->_modifiers) == current)
+			continue;
+
+		error.clear();
+		shortcuts.remove(current, hotkey);
+		if(shortcuts.count(current) == 0 && !unregisterShortcut(current))
+			qCWarning(logQHotkey) << QHotkey::tr("Failed to unregister %1. Error: %2").arg(hotkey->shortcut().toString(), error);
+		if(!remapShortcut(hotkey, current)) {
+			hotkey->_registered = false;
+			emit hotkey->registeredChanged(false);
+		}
+	}
+}
+
+// Registers hotkey on the native shortcut its key maps to now. On failure it is
+// kept in lostShortcuts to be tried again; current only avoids repeating the
+// warning while the target stays the same.
+bool QHotkeyPrivate::remapShortcut(QHotkey *hotkey, QHotkey::NativeShortcut current)
+{
+	const QHotkey::NativeShortcut remapped = nativeShortcutInvoked(hotkey->_keyCode, hotkey->_modifiers);
+	hotkey->_nativeShortcut = remapped;
+	error.clear();
+	if(!remapped.isValid() ||
+	   (shortcuts.count(remapped) == 0 && !registerShortcut(remapped))) {
+		if(remapped != current)
+			qCWarning(logQHotkey) << QHotkey::tr("Failed to register %1 after a keymap change. Error: %2").arg(hotkey->shortcut().toString(), error);
+		lostShortcuts.append({hotkey, hotkey->_keyCode, hotkey->_modifiers});
+		return false;
+	}
+	shortcuts.insert(remapped, hotkey);
+	return true;
+}
+
 QHotkey::NativeShortcut QHotkeyPrivate::nativeShortcutInvoked(Qt::Key keycode, Qt::KeyboardModifiers modifiers)
 {
 	if(mapping.contains({keycode, modifiers}))
@@ -366,12 +522,192 @@ bool QHotkey::NativeShortcut::operator !=(QHotkey::NativeShortcut other) const
 		   valid != other.valid;
 }
 
+// Hashing key and modifier separately and xor-ing them collided whenever two
+// shortcuts swapped values, e.g. dense keycodes under dense modifier masks.
 QHOTKEY_HASH_SEED qHash(QHotkey::NativeShortcut key)
 {
-	return qHash(key.key) ^ qHash(key.modifier);
+	return qHash((quint64(key.key) << 32) | key.modifier);
 }
 
 QHOTKEY_HASH_SEED qHash(QHotkey::NativeShortcut key, QHOTKEY_HASH_SEED seed)
 {
-	return qHash(key.key, seed) ^ qHash(key.modifier, seed);
+	return qHash((quint64(key.key) << 32) | key.modifier, seed);
+}
+
+
+
+// ---------- QHotkeyShortcutTable implementation ----------
+
+int QHotkeyShortcutTable::count(QHotkey::NativeShortcut shortcut) const
+{
+	const int index = find(pack(shortcut));
+	return index < 0 ? 0 : buckets[index].live;
+}
+
+bool QHotkeyShortcutTable::isEmpty() const
+{
+	for(const Entry &entry : buckets) {
+		if(entry.live > 0)
+			return false;
+	}
+	return true;
+}
+
+QList<QHotkey*> QHotkeyShortcutTable::hotkeys() const
+{
+	QList<QHotkey*> res;
+	for(const Entry &entry : buckets) {
+		for(QHotkey *hotkey : entry.listeners) {
+			if(hotkey)
+				res.append(hotkey);
+		}
+	}
+	return res;
+}
+
+void QHotkeyShortcutTable::insert(QHotkey::NativeShortcut shortcut, QHotkey *hotkey)
+{
+	const quint64 key = pack(shortcut);
+	int index = find(key);
+	if(index < 0) {
+		// keep the load factor at or below one half, so probes stay short
+		if((used + 1) * 2 > buckets.size())
+			rehash(qMax(16, int(buckets.size()) * 2));
+		const int mask = int(buckets.size()) - 1;
+		index = home(key);
+		while(!buckets[index].listeners.isEmpty())
+			index = (index + 1) & mask;
+		buckets[index].key = key;
+		++used;
+	}
+	Entry &entry = buckets[index];
+	entry.listeners.append(hotkey);
+	++entry.live;
+}
+
+bool QHotkeyShortcutTable::remove(QHotkey::NativeShortcut shortcut, QHotkey *hotkey)
+{
+	const int index = find(pack(shortcut));
+	if(index < 0)
+		return false;
+	Entry &entry = buckets[index];
+	const int slot = int(entry.listeners.indexOf(hotkey));
+	if(slot < 0)
+		return false;
+	--entry.live;
+	if(dispatchDepth > 0) {
+		entry.listeners[slot] = nullptr;
+		dirty = true;
+	} else if(entry.live == 0)
+		erase(index);
+	else
+		entry.listeners.remove(slot);
+	return true;
+}
+
+int QHotkeyShortcutTable::slotCount(QHotkey::NativeShortcut shortcut) const
+{
+	const int index = find(pack(shortcut));
+	return index < 0 ? 0 : int(buckets[index].listeners.size());
+}
+
+QHotkey *QHotkeyShortcutTable::listener(QHotkey::NativeShortcut shortcut, int index) const
+{
+	// looked up again every time, a listener may have grown the table
+	const int bucket = find(pack(shortcut));
+	if(bucket < 0 || index >= buckets[bucket].listeners.size())
+		return nullptr;
+	return buckets[bucket].listeners[index];
+}
+
+void QHotkeyShortcutTable::beginDispatch()
+{
+	++dispatchDepth;
+}
+
+void QHotkeyShortcutTable::endDispatch()
+{
+	if(--dispatchDepth == 0 && dirty)
+		compact();
+}
+
+quint64 QHotkeyShortcutTable::pack(QHotkey::NativeShortcut shortcut)
+{
+	return (quint64(shortcut.key) << 32) | shortcut.modifier;
+}
+
+int QHotkeyShortcutTable::home(quint64 key) const
+{
+	// murmur3 finalizer, so neighbouring keycodes and modifiers spread out
+	key ^= key >> 33;
+	key *= Q_UINT64_C(0xff51afd7ed558ccd);
+	key ^= key >> 33;
+	key *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+	key ^= key >> 33;
+	return int(key & quint64(buckets.size() - 1));
+}
+
+int QHotkeyShortcutTable::find(quint64 key) const
+{
+	if(buckets.isEmpty())
+		return -1;
+	const int mask = int(buckets.size()) - 1;
+	for(int index = home(key); !buckets[index].listeners.isEmpty(); index = (index + 1) & mask) {
+		if(buckets[index].key == key)
+			return index;
+	}
+	return -1;
+}
+
+void QHotkeyShortcutTable::rehash(int capacity)
+{
+	QVector<Entry> old(capacity);
+	old.swap(buckets);
+	const int mask = capacity - 1;
+	for(Entry &entry : old) {
+		if(entry.listeners.isEmpty())
+			continue;
+		int index = home(entry.key);
+		while(!buckets[index].listeners.isEmpty())
+			index = (index + 1) & mask;
+		buckets[index] = std::move(entry);
+	}
+}
+
+void QHotkeyShortcutTable::erase(int index)
+{
+	// backward shift deletion: pull later entries of the probe run into the
+	// hole, so lookups never need tombstones
+	const int mask = int(buckets.size()) - 1;
+	int hole = index;
+	for(int next = (hole + 1) & mask; !buckets[next].listeners.isEmpty(); next = (next + 1) & mask) {
+		const int wanted = home(buckets[next].key);
+		const bool movable = hole <= next ?
+								 (wanted <= hole || wanted > next) :
+								 (wanted <= hole && wanted > next);
+		if(movable) {
+			buckets[hole] = std::move(buckets[next]);
+			hole = next;
+		}
+	}
+	buckets[hole] = Entry();
+	--used;
+}
+
+void QHotkeyShortcutTable::compact()
+{
+	dirty = false;
+	int kept = 0;
+	for(Entry &entry : buckets) {
+		if(entry.listeners.isEmpty())
+			continue;
+		entry.listeners.removeAll(nullptr);
+		if(entry.live == 0)
+			entry = Entry();
+		else
+			++kept;
+	}
+	// dropped entries may have broken probe runs, so place the rest again
+	used = kept;
+	rehash(int(buckets.size()));
 }
@@ -66,6 +66,9 @@ public:
 	//! Checks if global shortcuts are supported by the current platform
 	static bool isPlatformSupported();
 
+	//! Registers all hotkeys in one batch and returns, per hotkey, whether it was registered
+	static QList<bool> registerAll(const QList<QHotkey*> &hotkeys);
+
 	//! Default Constructor
 	explicit QHotkey(QObject *parent = nullptr);
 	//! Constructs a hotkey with a shortcut and optionally registers it
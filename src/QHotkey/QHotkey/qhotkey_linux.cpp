@@ -4,7 +4,10 @@
 
 #include <QAction>
 #include <QCoreApplication>
+#include <array>
+#include <bitset>
 #include <cmath>
+#include <cstdlib>
 #include <kglobalaccel.h>
 #include <qcoreapplication.h>
 #include <qkeysequence.h>
@@ -28,10 +31,13 @@
 #include "kglobalaccel_component_interface.h"
 #include "kglobalaccel_interface.h"
 
+#include <QSocketNotifier>
 #include <QThreadStorage>
 #include <QTimer>
+#include <X11/XKBlib.h>
 #include <X11/Xlib.h>
 #include <xcb/xcb.h>
+#include <xcb/xkb.h>
 
 // compatibility to pre Qt 5.8
 #ifndef Q_FALLTHROUGH
@@ -77,6 +83,7 @@ protected:
     quint32 nativeModifiers(Qt::KeyboardModifiers modifiers, bool& ok) Q_DECL_OVERRIDE;
     static QString getX11String(Qt::Key keycode);
     bool registerShortcut(QHotkey::NativeShortcut shortcut) Q_DECL_OVERRIDE;
+    QVector<bool> registerShortcuts(const QVector<QHotkey::NativeShortcut>& nativeShortcuts, QStringList& errors) Q_DECL_OVERRIDE;
     bool unregisterShortcut(QHotkey::NativeShortcut shortcut) Q_DECL_OVERRIDE;
 
 private:
@@ -87,6 +94,41 @@ private:
 
     bool isX11;
     bool isWayland;
+    // The grabs live on an X connection of their own, read through a socket
+    // notifier, so that per client settings made for them leave Qt's key
+    // events alone. Null if it could not be opened: the grabs then go on
+    // Qt's connection and its events through nativeEventFilter()
+    xcb_connection_t* hotkeyConnection = nullptr;
+    xcb_window_t hotkeyRoot = XCB_NONE;
+    QSocketNotifier* hotkeyNotifier = nullptr;
+    // XKB detectable auto-repeat, set on hotkeyConnection: a held key repeats
+    // as presses only and is released once, so releases need no timer to be
+    // told apart from repeats. QHOTKEY_DETECTABLE_AUTOREPEAT=0 turns it off
+    bool detectableAutoRepeat = false;
+    // Keycodes held down, to skip the repeated presses
+    std::bitset<256> pressedKeys;
+    // The server's keymap, read through xcb: Xlib's copy behind XKeysymToKeycode
+    // goes stale, as Qt takes the MappingNotify events that would refresh it
+    QHash<quint32, quint32> keysymKeycodes;
+    QHash<Qt::Key, quint32> keycodeCache; // 0 for keys without a keycode
+    bool keymapLoaded = false;
+    bool keymapRefreshPending = false;
+    int xkbEventBase = -1;
+
+    void loadKeymap();
+    bool isKeymapChange(const xcb_generic_event_t* event) const;
+    void refreshKeymap();
+
+    void openHotkeyConnection(Display* display);
+    void readHotkeyEvents();
+    void handleKeyEvent(const xcb_generic_event_t* event);
+    // The connection the grabs are made on and its root window
+    xcb_connection_t* grabConnection(xcb_window_t& root) const;
+
+    // Keycodes with at least one grab; the event filter drops every other
+    // key event before looking at it. grabCounts covers shared keycodes.
+    std::bitset<256> grabbedKeys;
+    std::array<quint16, 256> grabCounts {};
 
     // Used by KGlobalAccel
     const QString m_token;
@@ -107,21 +149,7 @@ private:
     QString getShorctIdentifier(const QString& shorctStr);
 
     // For X11
-    static QString formatX11Error(Display* display, int errorCode);
-
-    class HotkeyErrorHandler {
-    public:
-        HotkeyErrorHandler();
-        ~HotkeyErrorHandler();
-
-        static bool hasError;
-        static QString errorString;
-
-    private:
-        XErrorHandler prevHandler;
-
-        static int handleError(Display* display, XErrorEvent* error);
-    };
+    static QString formatX11Error(int errorCode);
 };
 NATIVE_INSTANCE(QHotkeyPrivateLinux)
 
@@ -143,6 +171,10 @@ const quint32 QHotkeyPrivateLinux::validModsMask = ShiftMask | ControlMask | Mod
 
 QHotkeyPrivateLinux::~QHotkeyPrivateLinux()
 {
+    if (hotkeyConnection) {
+        delete hotkeyNotifier;
+        xcb_disconnect(hotkeyConnection);
+    }
     if (isWayland) {
         qCDebug(logQHotkey_Linux) << "Unregistering shortcuts";
         // We can forget the shortcuts that aren't around anymore
@@ -179,6 +211,26 @@ QHotkeyPrivateLinux::QHotkeyPrivateLinux()
 {
     qCDebug(logQHotkey_Linux) << "Called by " << QCoreApplication::applicationFilePath();
     qCDebug(logQHotkey_Linux) << "appID:" << m_appId;
+    if (isX11) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+        const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        Display* display = x11Interface ? x11Interface->display() : nullptr;
+#else
+        Display* display = QX11Info::display();
+#endif
+        openHotkeyConnection(display);
+        qCDebug(logQHotkey_Linux) << "Own connection:" << (hotkeyConnection != nullptr)
+                                  << "detectable auto-repeat:" << detectableAutoRepeat;
+
+        // Qt selects XKB keymap events, and the server then sends those
+        // instead of core MappingNotify
+        int opcode = 0;
+        int errorBase = 0;
+        int major = XkbMajorVersion;
+        int minor = XkbMinorVersion;
+        if (!display || !XkbQueryExtension(display, &opcode, &xkbEventBase, &errorBase, &major, &minor))
+            xkbEventBase = -1;
+    }
     if (isWayland) {
         qCDebug(logQHotkey_Linux) << "Wayland detected";
         qDBusRegisterMetaType<KGlobalShortcutInfo>();
@@ -257,29 +309,78 @@ bool QHotkeyPrivateLinux::nativeEventFilter(const QByteArray& eventType, void* m
     Q_UNUSED(result)
 
     if (isX11) {
+        // Sees every event of Qt's connection, so reject anything that is not
+        // a key event first
         auto* genericEvent = static_cast<xcb_generic_event_t*>(message);
-        if (genericEvent->response_type == XCB_KEY_PRESS) {
-            xcb_key_press_event_t keyEvent = *static_cast<xcb_key_press_event_t*>(message);
-            this->prevEvent = keyEvent;
-            if (this->prevHandledEvent.response_type == XCB_KEY_RELEASE) {
-                if (this->prevHandledEvent.time == keyEvent.time)
-                    return false;
+        if (genericEvent->response_type != XCB_KEY_PRESS && genericEvent->response_type != XCB_KEY_RELEASE) {
+            // Refresh once a burst of keymap events is over, outside of the filter
+            if (!keymapRefreshPending && isKeymapChange(genericEvent)) {
+                keymapRefreshPending = true;
+                QMetaObject::invokeMethod(this, [this] { refreshKeymap(); }, Qt::QueuedConnection);
             }
-            this->activateShortcut({ keyEvent.detail, keyEvent.state & QHotkeyPrivateLinux::validModsMask });
-        } else if (genericEvent->response_type == XCB_KEY_RELEASE) {
-            xcb_key_release_event_t keyEvent = *static_cast<xcb_key_release_event_t*>(message);
-            this->prevEvent = keyEvent;
-            QTimer::singleShot(50, [this, keyEvent] {
-                if (this->prevEvent.time == keyEvent.time && this->prevEvent.response_type == keyEvent.response_type && this->prevEvent.detail == keyEvent.detail) {
-                    this->releaseShortcut({ keyEvent.detail, keyEvent.state & QHotkeyPrivateLinux::validModsMask });
-                }
-            });
-            this->prevHandledEvent = keyEvent;
+            return false;
         }
+        // The key events of grabs on a connection of their own never come here
+        if (!hotkeyConnection)
+            handleKeyEvent(genericEvent);
     }
     return false;
 }
 
+void QHotkeyPrivateLinux::readHotkeyEvents()
+{
+    while (xcb_generic_event_t* event = xcb_poll_for_event(hotkeyConnection)) {
+        // Keymap changes are followed on Qt's connection
+        if (event->response_type == XCB_KEY_PRESS || event->response_type == XCB_KEY_RELEASE)
+            handleKeyEvent(event);
+        free(event);
+    }
+    if (xcb_connection_has_error(hotkeyConnection)) {
+        qCWarning(logQHotkey_Linux) << "Lost the X connection of the hotkeys";
+        hotkeyNotifier->setEnabled(false);
+    }
+}
+
+void QHotkeyPrivateLinux::handleKeyEvent(const xcb_generic_event_t* genericEvent)
+{
+    // Press and release events share the layout
+    if (!grabbedKeys.test(reinterpret_cast<const xcb_key_press_event_t*>(genericEvent)->detail))
+        return;
+
+    if (genericEvent->response_type == XCB_KEY_PRESS) {
+        xcb_key_press_event_t keyEvent = *reinterpret_cast<const xcb_key_press_event_t*>(genericEvent);
+        if (detectableAutoRepeat) {
+            if (pressedKeys.test(keyEvent.detail))
+                return;
+            pressedKeys.set(keyEvent.detail);
+            this->activateShortcut({ keyEvent.detail, keyEvent.state & QHotkeyPrivateLinux::validModsMask });
+            return;
+        }
+        this->prevEvent = keyEvent;
+        if (this->prevHandledEvent.response_type == XCB_KEY_RELEASE) {
+            if (this->prevHandledEvent.time == keyEvent.time)
+                return;
+        }
+        this->activateShortcut({ keyEvent.detail, keyEvent.state & QHotkeyPrivateLinux::validModsMask });
+    } else {
+        xcb_key_release_event_t keyEvent = *reinterpret_cast<const xcb_key_release_event_t*>(genericEvent);
+        if (detectableAutoRepeat) {
+            pressedKeys.reset(keyEvent.detail);
+            this->releaseShortcut({ keyEvent.detail, keyEvent.state & QHotkeyPrivateLinux::validModsMask });
+            return;
+        }
+        // Without detectable auto-repeat every repeat is a release and a
+        // press with the same time, so wait whether a press follows
+        this->prevEvent = keyEvent;
+        QTimer::singleShot(50, [this, keyEvent] {
+            if (this->prevEvent.time == keyEvent.time && this->prevEvent.response_type == keyEvent.response_type && this->prevEvent.detail == keyEvent.detail) {
+                this->releaseShortcut({ keyEvent.detail, keyEvent.state & QHotkeyPrivateLinux::validModsMask });
+            }
+        });
+        this->prevHandledEvent = keyEvent;
+    }
+}
+
 QString QHotkeyPrivateLinux::getX11String(Qt::Key keycode)
 {
     switch (keycode) {
@@ -305,6 +406,13 @@ QString QHotkeyPrivateLinux::getX11String(Qt::Key keycode)
 quint32 QHotkeyPrivateLinux::nativeKeycode(Qt::Key keycode, bool& ok)
 {
     if (isX11) {
+        if (!keymapLoaded)
+            loadKeymap();
+        if (const auto it = keycodeCache.constFind(keycode); it != keycodeCache.constEnd()) {
+            ok = *it != 0;
+            return *it;
+        }
+
         QString keyString = getX11String(keycode);
 
         KeySym keysym = XStringToKeysym(keyString.toLatin1().constData());
@@ -316,19 +424,25 @@ quint32 QHotkeyPrivateLinux::nativeKeycode(Qt::Key keycode, bool& ok)
                 return 0;
         }
 
-#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
-        const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
-#else
-        const bool x11Interface = QX11Info::isPlatformX11();
-#endif
+        if (keymapLoaded) {
+            const quint32 res = keysymKeycodes.value(quint32(keysym), 0);
+            keycodeCache.insert(keycode, res);
+            if (res != 0)
+                ok = true;
+            return res;
+        }
 
-        if (x11Interface) {
+        // The keymap could not be read through xcb; Xlib's copy may be stale,
+        // but still beats failing every hotkey. Not cached, so the next call
+        // tries the keymap again
 #if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
-            Display* display = x11Interface->display();
+        const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+        Display* display = x11Interface ? x11Interface->display() : nullptr;
 #else
-            Display* display = QX11Info::display();
+        Display* display = QX11Info::display();
 #endif
-            auto res = XKeysymToKeycode(display, keysym);
+        if (display) {
+            const quint32 res = XKeysymToKeycode(display, keysym);
             if (res != 0)
                 ok = true;
             return res;
@@ -344,6 +458,132 @@ quint32 QHotkeyPrivateLinux::nativeKeycode(Qt::Key keycode, bool& ok)
     return 0;
 }
 
+void QHotkeyPrivateLinux::loadKeymap()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+    const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    xcb_connection_t* connection = x11Interface ? x11Interface->connection() : nullptr;
+#else
+    xcb_connection_t* connection = QX11Info::connection();
+#endif
+
+    keysymKeycodes.clear();
+    keycodeCache.clear();
+    keymapLoaded = false;
+    if (!connection)
+        return;
+
+    const xcb_setup_t* setup = xcb_get_setup(connection);
+    const int count = setup->max_keycode - setup->min_keycode + 1;
+    xcb_get_keyboard_mapping_reply_t* reply = xcb_get_keyboard_mapping_reply(connection,
+        xcb_get_keyboard_mapping(connection, setup->min_keycode, count),
+        nullptr);
+    if (!reply) {
+        qCWarning(logQHotkey_Linux) << "Failed to read the keyboard mapping";
+        return;
+    }
+
+    const xcb_keysym_t* keysyms = xcb_get_keyboard_mapping_keysyms(reply);
+    const int perKeycode = reply->keysyms_per_keycode;
+    // Same search order as XKeysymToKeycode: column by column, lowest keycode
+    // first. Like Xlib, a key listing no upper case symbol gets the converted one.
+    for (int column = 0; perKeycode > 0 && column < qMax(perKeycode, 2); ++column) {
+        for (int i = 0; i < count; ++i) {
+            const xcb_keysym_t* symbols = keysyms + i * perKeycode;
+            KeySym keysym = column < perKeycode ? symbols[column] : NoSymbol;
+            if (column < 2 && (perKeycode < 2 || symbols[1] == NoSymbol)) {
+                KeySym lower = NoSymbol;
+                KeySym upper = NoSymbol;
+                XConvertCase(symbols[0], &lower, &upper);
+                keysym = column == 0 ? lower : upper;
+            }
+            if (keysym != NoSymbol && !keysymKeycodes.contains(quint32(keysym)))
+                keysymKeycodes.insert(quint32(keysym), quint32(setup->min_keycode + i));
+        }
+    }
+    free(reply);
+    keymapLoaded = true;
+}
+
+bool QHotkeyPrivateLinux::isKeymapChange(const xcb_generic_event_t* event) const
+{
+    const quint8 type = event->response_type & ~0x80;
+    if (type == XCB_MAPPING_NOTIFY)
+        return reinterpret_cast<const xcb_mapping_notify_event_t*>(event)->request == XCB_MAPPING_KEYBOARD;
+    if (xkbEventBase >= 0 && type == xkbEventBase) {
+        // All XKB events share the base code; the second byte tells them apart
+        const quint8 xkbType = reinterpret_cast<const quint8*>(event)[1];
+        return xkbType == XkbNewKeyboardNotify || xkbType == XkbMapNotify;
+    }
+    return false;
+}
+
+void QHotkeyPrivateLinux::refreshKeymap()
+{
+    keymapRefreshPending = false;
+    qCDebug(logQHotkey_Linux) << "Keymap changed, mapping hotkeys again";
+    loadKeymap();
+    remapShortcuts();
+}
+
+void QHotkeyPrivateLinux::openHotkeyConnection(Display* display)
+{
+    int screen = 0;
+    xcb_connection_t* connection = xcb_connect(display ? DisplayString(display) : nullptr, &screen);
+    if (xcb_connection_has_error(connection)) {
+        qCWarning(logQHotkey_Linux) << "Failed to open an X connection for the hotkeys, grabbing on Qt's";
+        xcb_disconnect(connection);
+        return;
+    }
+    xcb_screen_iterator_t roots = xcb_setup_roots_iterator(xcb_get_setup(connection));
+    for (int i = 0; i < screen && roots.rem > 1; ++i)
+        xcb_screen_next(&roots);
+    hotkeyConnection = connection;
+    hotkeyRoot = roots.data->root;
+    hotkeyNotifier = new QSocketNotifier(xcb_get_file_descriptor(connection), QSocketNotifier::Read, this);
+    connect(hotkeyNotifier, &QSocketNotifier::activated, this, [this] { readHotkeyEvents(); });
+
+    // Left off only to compare with the timer
+    if (qEnvironmentVariable("QHOTKEY_DETECTABLE_AUTOREPEAT") == QLatin1String("0"))
+        return;
+    const xcb_query_extension_reply_t* xkb = xcb_get_extension_data(connection, &xcb_xkb_id);
+    if (!xkb || !xkb->present)
+        return;
+    xcb_xkb_use_extension_reply_t* use = xcb_xkb_use_extension_reply(connection,
+        xcb_xkb_use_extension(connection, XCB_XKB_MAJOR_VERSION, XCB_XKB_MINOR_VERSION),
+        nullptr);
+    const bool supported = use && use->supported;
+    free(use);
+    if (!supported)
+        return;
+    const uint32_t flag = XCB_XKB_PER_CLIENT_FLAG_DETECTABLE_AUTO_REPEAT;
+    xcb_xkb_per_client_flags_reply_t* flags = xcb_xkb_per_client_flags_reply(connection,
+        xcb_xkb_per_client_flags(connection, XCB_XKB_ID_USE_CORE_KBD, flag, flag, 0, 0, 0),
+        nullptr);
+    detectableAutoRepeat = flags && (flags->value & flag);
+    free(flags);
+}
+
+xcb_connection_t* QHotkeyPrivateLinux::grabConnection(xcb_window_t& root) const
+{
+    if (hotkeyConnection) {
+        root = hotkeyRoot;
+        return hotkeyConnection;
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+    const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    Display* display = x11Interface ? x11Interface->display() : nullptr;
+    xcb_connection_t* connection = x11Interface ? x11Interface->connection() : nullptr;
+#else
+    Display* display = QX11Info::display();
+    xcb_connection_t* connection = QX11Info::connection();
+#endif
+    if (!display || !connection)
+        return nullptr;
+    root = DefaultRootWindow(display);
+    return connection;
+}
+
 quint32 QHotkeyPrivateLinux::nativeModifiers(Qt::KeyboardModifiers modifiers, bool& ok)
 {
     quint32 nMods = 0;
@@ -418,35 +658,10 @@ void QHotkeyPrivateLinux::setActionsInAccel(const Shortcuts& shortcuts)
 bool QHotkeyPrivateLinux::registerShortcut(QHotkey::NativeShortcut shortcut)
 {
     if (isX11) {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
-        const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
-        Display* display = x11Interface->display();
-#else
-        const bool x11Interface = QX11Info::isPlatformX11();
-        Display* display = QX11Info::display();
-#endif
-
-        if (!display || !x11Interface)
-            return false;
-
-        HotkeyErrorHandler errorHandler;
-        for (quint32 specialMod : QHotkeyPrivateLinux::specialModifiers) {
-            XGrabKey(display,
-                shortcut.key,
-                shortcut.modifier | specialMod,
-                DefaultRootWindow(display),
-                True,
-                GrabModeAsync,
-                GrabModeAsync);
-        }
-        XSync(display, False);
-
-        if (errorHandler.hasError) {
-            error = errorHandler.errorString;
-            this->unregisterShortcut(shortcut);
-            return false;
-        }
-        return true;
+        QStringList errors;
+        const bool grabbed = registerShortcuts({ shortcut }, errors).value(0);
+        error = errors.value(0);
+        return grabbed;
     }
 
     if (isWayland) {
@@ -493,29 +708,102 @@ bool QHotkeyPrivateLinux::registerShortcut(QHotkey::NativeShortcut shortcut)
     return false;
 }
 
+QVector<bool> QHotkeyPrivateLinux::registerShortcuts(const QVector<QHotkey::NativeShortcut>& nativeShortcuts, QStringList& errors)
+{
+    if (!isX11)
+        return QHotkeyPrivate::registerShortcuts(nativeShortcuts, errors);
+
+    xcb_window_t root = XCB_NONE;
+    xcb_connection_t* connection = grabConnection(root);
+    if (!connection) {
+        for (int i = 0; i < nativeShortcuts.size(); ++i)
+            errors.append(QStringLiteral("No X11 connection"));
+        return QVector<bool>(nativeShortcuts.size(), false);
+    }
+
+    // Send every grab before checking any of them: the first check syncs once
+    // for the whole batch, instead of one round trip per shortcut
+    const int modifierCount = int(QHotkeyPrivateLinux::specialModifiers.size());
+    QVector<xcb_void_cookie_t> cookies;
+    cookies.reserve(nativeShortcuts.size() * modifierCount);
+    for (const QHotkey::NativeShortcut& shortcut : nativeShortcuts) {
+        // Counted before grabbing; a failed grab undoes it in unregisterShortcut()
+        const quint32 keycode = shortcut.key & 0xFF;
+        ++grabCounts[keycode];
+        grabbedKeys.set(keycode);
+        for (quint32 specialMod : QHotkeyPrivateLinux::specialModifiers) {
+            cookies.append(xcb_grab_key_checked(connection,
+                true,
+                root,
+                static_cast<uint16_t>(shortcut.modifier | specialMod),
+                static_cast<xcb_keycode_t>(shortcut.key),
+                XCB_GRAB_MODE_ASYNC,
+                XCB_GRAB_MODE_ASYNC));
+        }
+    }
+
+    QVector<bool> res;
+    res.reserve(nativeShortcuts.size());
+    for (int i = 0; i < nativeShortcuts.size(); ++i) {
+        QString message;
+        for (int j = 0; j < modifierCount; ++j) {
+            if (xcb_generic_error_t* grabError = xcb_request_check(connection, cookies[i * modifierCount + j])) {
+                if (message.isEmpty())
+                    message = formatX11Error(grabError->error_code);
+                free(grabError);
+            }
+        }
+        const bool grabbed = message.isEmpty();
+        if (!grabbed) {
+            // Drops the grabs that did succeed
+            this->unregisterShortcut(nativeShortcuts[i]);
+        }
+        res.append(grabbed);
+        errors.append(message);
+    }
+    // Waiting for the replies may have queued key events without the socket
+    // becoming readable again
+    if (hotkeyConnection)
+        QMetaObject::invokeMethod(this, [this] { readHotkeyEvents(); }, Qt::QueuedConnection);
+    return res;
+}
+
 bool QHotkeyPrivateLinux::unregisterShortcut(QHotkey::NativeShortcut shortcut)
 {
     if (isX11) {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
-        Display* display = qGuiApp->nativeInterface<QNativeInterface::QX11Application>()->display();
-#else
-        Display* display = QX11Info::display();
-#endif
-
-        if (!display)
+        xcb_window_t root = XCB_NONE;
+        xcb_connection_t* connection = grabConnection(root);
+        if (!connection)
             return false;
 
-        HotkeyErrorHandler errorHandler;
+        const quint32 keycode = shortcut.key & 0xFF;
+        if (grabCounts[keycode] > 0 && --grabCounts[keycode] == 0) {
+            grabbedKeys.reset(keycode);
+            // The release of a key held while it is ungrabbed may go elsewhere
+            pressedKeys.reset(keycode);
+        }
+
+        QVector<xcb_void_cookie_t> cookies;
+        cookies.reserve(QHotkeyPrivateLinux::specialModifiers.size());
         for (quint32 specialMod : QHotkeyPrivateLinux::specialModifiers) {
-            XUngrabKey(display,
-                shortcut.key,
-                shortcut.modifier | specialMod,
-                XDefaultRootWindow(display));
+            cookies.append(xcb_ungrab_key_checked(connection,
+                static_cast<xcb_keycode_t>(shortcut.key),
+                root,
+                static_cast<uint16_t>(shortcut.modifier | specialMod)));
         }
-        XSync(display, False);
+        QString message;
+        for (const xcb_void_cookie_t& cookie : cookies) {
+            if (xcb_generic_error_t* ungrabError = xcb_request_check(connection, cookie)) {
+                if (message.isEmpty())
+                    message = formatX11Error(ungrabError->error_code);
+                free(ungrabError);
+            }
+        }
+        if (hotkeyConnection)
+            QMetaObject::invokeMethod(this, [this] { readHotkeyEvents(); }, Qt::QueuedConnection);
 
-        if (HotkeyErrorHandler::hasError) {
-            error = HotkeyErrorHandler::errorString;
+        if (!message.isEmpty()) {
+            error = message;
             return false;
         }
         return true;
@@ -554,45 +842,17 @@ bool QHotkeyPrivateLinux::unregisterShortcut(QHotkey::NativeShortcut shortcut)
     return false;
 }
 
-QString QHotkeyPrivateLinux::formatX11Error(Display* display, int errorCode)
+QString QHotkeyPrivateLinux::formatX11Error(int errorCode)
 {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+    const QNativeInterface::QX11Application* x11Interface = qGuiApp->nativeInterface<QNativeInterface::QX11Application>();
+    Display* display = x11Interface ? x11Interface->display() : nullptr;
+#else
+    Display* display = QX11Info::display();
+#endif
+    if (!display)
+        return QStringLiteral("X11 error %1").arg(errorCode);
     char errStr[256];
     XGetErrorText(display, errorCode, errStr, 256);
     return QString::fromLatin1(errStr);
 }
-
-// ---------- HotkeyErrorHandler::HotkeyErrorHandler implementation ----------
-
-bool QHotkeyPrivateLinux::HotkeyErrorHandler::hasError = false;
-QString QHotkeyPrivateLinux::HotkeyErrorHandler::errorString;
-
-QHotkeyPrivateLinux::HotkeyErrorHandler::HotkeyErrorHandler()
-{
-    prevHandler = XSetErrorHandler(&HotkeyErrorHandler::handleError);
-}
-
-QHotkeyPrivateLinux::HotkeyErrorHandler::~HotkeyErrorHandler()
-{
-    XSetErrorHandler(prevHandler);
-    hasError = false;
-    errorString.clear();
-}
-
-int QHotkeyPrivateLinux::HotkeyErrorHandler::handleError(Display* display, XErrorEvent* error)
-{
-    switch (error->error_code) {
-    case BadAccess:
-    case BadValue:
-    case BadWindow:
-        if (error->request_code == 33 || // grab key
-            error->request_code == 34) { // ungrab key
-            hasError = true;
-            errorString = QHotkeyPrivateLinux::formatX11Error(display, error->error_code);
-            return 1;
-        }
-        Q_FALLTHROUGH();
-        // fall through
-    default:
-        return 0;
-    }
-}
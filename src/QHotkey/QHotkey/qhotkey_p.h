@@ -3,9 +3,13 @@
 
 #include "qhotkey.h"
 #include <QAbstractNativeEventFilter>
-#include <QMultiHash>
+#include <QHash>
 #include <QMutex>
+#include <QPointer>
+#include <QStringList>
 #include <QGlobalStatic>
+#include <QVarLengthArray>
+#include <QVector>
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
 	#define _NATIVE_EVENT_RESULT qintptr
@@ -13,6 +17,50 @@
 	#define _NATIVE_EVENT_RESULT long
 #endif
 
+//! Open addressing map from native shortcuts to the hotkeys listening on them
+class QHotkeyShortcutTable
+{
+public:
+	//! Returns the number of hotkeys registered for shortcut
+	int count(QHotkey::NativeShortcut shortcut) const;
+	//! Checks whether no hotkey is registered at all
+	bool isEmpty() const;
+	//! Returns all registered hotkeys
+	QList<QHotkey*> hotkeys() const;
+
+	void insert(QHotkey::NativeShortcut shortcut, QHotkey *hotkey);
+	bool remove(QHotkey::NativeShortcut shortcut, QHotkey *hotkey);
+
+	//! Returns the number of listener slots of shortcut, including emptied ones
+	int slotCount(QHotkey::NativeShortcut shortcut) const;
+	//! Returns the hotkey in slot index, or nullptr if it was removed meanwhile
+	QHotkey *listener(QHotkey::NativeShortcut shortcut, int index) const;
+
+	//! While dispatching, removed listeners only leave an empty slot behind
+	void beginDispatch();
+	void endDispatch();
+
+private:
+	struct Entry {
+		quint64 key = 0;
+		int live = 0;
+		//! Empty for unused buckets
+		QVarLengthArray<QHotkey*, 2> listeners;
+	};
+
+	QVector<Entry> buckets;
+	int used = 0;
+	int dispatchDepth = 0;
+	bool dirty = false;
+
+	static quint64 pack(QHotkey::NativeShortcut shortcut);
+	int home(quint64 key) const;
+	int find(quint64 key) const;
+	void rehash(int capacity);
+	void erase(int index);
+	void compact();
+};
+
 class QHOTKEY_EXPORT QHotkeyPrivate : public QObject, public QAbstractNativeEventFilter
 {
 	Q_OBJECT
@@ -27,7 +75,10 @@ public:
 	QHotkey::NativeShortcut nativeShortcut(Qt::Key keycode, Qt::KeyboardModifiers modifiers);
 
 	bool addShortcut(QHotkey *hotkey);
+	QList<bool> addShortcuts(const QList<QHotkey*> &hotkeys);
 	bool removeShortcut(QHotkey *hotkey);
+	//! Stops trying to register hotkey again after it was lost on a keymap change
+	void forgetLostShortcut(QHotkey *hotkey);
 
 protected:
 	void activateShortcut(QHotkey::NativeShortcut shortcut);
@@ -37,16 +88,34 @@ protected:
 	virtual quint32 nativeModifiers(Qt::KeyboardModifiers modifiers, bool &ok) = 0;//platform implement
 
 	virtual bool registerShortcut(QHotkey::NativeShortcut shortcut) = 0;//platform implement
+	//! Registers several shortcuts; errors gets one entry per shortcut. Defaults to registerShortcut() for each
+	virtual QVector<bool> registerShortcuts(const QVector<QHotkey::NativeShortcut> &nativeShortcuts, QStringList &errors);
 	virtual bool unregisterShortcut(QHotkey::NativeShortcut shortcut) = 0;//platform implement
 
+	//! Moves registered hotkeys to the native shortcuts their keys map to now, e.g. after a keymap change.
+	//! Hotkeys that cannot be registered there are retried on every later call
+	void remapShortcuts();
+
 	QString error;
 
 private:
 	QHash<QPair<Qt::Key, Qt::KeyboardModifiers>, QHotkey::NativeShortcut> mapping;
-	QMultiHash<QHotkey::NativeShortcut, QHotkey*> shortcuts;
+	QHotkeyShortcutTable shortcuts;
+
+	//! A hotkey unregistered by remapShortcuts(), with the key it had then
+	struct LostShortcut {
+		QPointer<QHotkey> hotkey;
+		Qt::Key keyCode;
+		Qt::KeyboardModifiers modifiers;
+	};
+	QVector<LostShortcut> lostShortcuts;
+	bool remapShortcut(QHotkey *hotkey, QHotkey::NativeShortcut current);
+
+	void dispatchShortcut(QHotkey::NativeShortcut shortcut, void (QHotkey::*signal)(QHotkey::QPrivateSignal));
 
 	Q_INVOKABLE void addMappingInvoked(Qt::Key keycode, Qt::KeyboardModifiers modifiers, QHotkey::NativeShortcut nativeShortcut);
 	Q_INVOKABLE bool addShortcutInvoked(QHotkey *hotkey);
+	QList<bool> addShortcutsInvoked(const QList<QHotkey*> &hotkeys);
 	Q_INVOKABLE bool removeShortcutInvoked(QHotkey *hotkey);
 	Q_INVOKABLE QHotkey::NativeShortcut nativeShortcutInvoked(Qt::Key keycode, Qt::KeyboardModifiers modifiers);
 };
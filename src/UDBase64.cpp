@@ -0,0 +1,406 @@
+#include "UDBase64.h"
+#include "UDSimd.h"
+
+#include <array>
+
+namespace {
+
+constexpr char encodeTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr std::array<qint8, 256> makeDecodeTable()
+{
+    std::array<qint8, 256> table {};
+    for (int i = 0; i < 256; ++i) {
+        table[i] = -1;
+    }
+    for (int i = 0; i < 64; ++i) {
+        table[uchar(encodeTable[i])] = qint8(i);
+    }
+    return table;
+}
+
+constexpr std::array<qint8, 256> decodeTable = makeDecodeTable();
+
+inline bool isBase64Space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline void encodeGroup(const uchar* in, char* out)
+{
+    const quint32 bits = (quint32(in[0]) << 16) | (quint32(in[1]) << 8) | in[2];
+    out[0] = encodeTable[(bits >> 18) & 63];
+    out[1] = encodeTable[(bits >> 12) & 63];
+    out[2] = encodeTable[(bits >> 6) & 63];
+    out[3] = encodeTable[bits & 63];
+}
+
+// An encode kernel turns whole 3-byte groups of in into out and returns how
+// many input bytes it consumed; the caller finishes the rest.
+using EncodeKernel = qsizetype (*)(const uchar* in, qsizetype length, char* out);
+
+// A decode kernel turns whole, valid 4-character groups of in into out and
+// returns how many characters it consumed, stopping early at anything it
+// cannot handle (padding, whitespace, garbage). It may write up to 32 bytes
+// past the decoded data.
+using DecodeKernel = qsizetype (*)(const char* in, qsizetype length, uchar* out);
+
+qsizetype encodeNone(const uchar*, qsizetype, char*)
+{
+    return 0;
+}
+
+qsizetype decodeNone(const char*, qsizetype, uchar*)
+{
+    return 0;
+}
+
+#if defined(UD_HAVE_SSE2)
+// Vector kernels after Wojciech Muła's and Daniel Lemire's pshufb-based base64.
+
+// 12 input bytes (of 16 loaded) to 16 sextet indices, one per byte.
+UD_TARGET_SSSE3 inline __m128i unpackSextets(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Sextet indices to ASCII: pick a per-range offset with one table lookup.
+UD_TARGET_SSSE3 inline __m128i sextetsToAscii(__m128i indices)
+{
+    const __m128i shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftLut, range), indices);
+}
+
+// 16 ASCII characters to sextets; false if any of them is not in the alphabet.
+UD_TARGET_SSSE3 inline bool asciiToSextets(__m128i& chars)
+{
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+
+    const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), nibbleMask);
+    const __m128i loNibbles = _mm_and_si128(chars, nibbleMask);
+    const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+    const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+    const __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+    if (_mm_movemask_epi8(invalid) != 0xFFFF) {
+        return false;
+    }
+    const __m128i eqSlash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+    const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eqSlash, hiNibbles));
+    chars = _mm_add_epi8(chars, roll);
+    return true;
+}
+
+// 16 sextets to 12 bytes in the low part of the register.
+UD_TARGET_SSSE3 inline __m128i packSextets(__m128i sextets)
+{
+    const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+    const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+UD_TARGET_SSSE3 qsizetype encodeSsse3(const uchar* in, qsizetype length, char* out)
+{
+    qsizetype i = 0;
+    // Each step loads 16 bytes but only consumes 12.
+    for (; i + 16 <= length; i += 12, out += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), sextetsToAscii(unpackSextets(block)));
+    }
+    return i;
+}
+
+UD_TARGET_SSSE3 qsizetype decodeSsse3(const char* in, qsizetype length, uchar* out)
+{
+    qsizetype i = 0;
+    for (; i + 16 <= length; i += 16, out += 12) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (!asciiToSextets(block)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packSextets(block));
+    }
+    return i;
+}
+
+UD_TARGET_AVX2 qsizetype encodeAvx2(const uchar* in, qsizetype length, char* out)
+{
+    const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shiftLut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    qsizetype i = 0;
+    // 24 bytes per step, as two 12-byte halves; the upper load reads 4 bytes past them.
+    for (; i + 28 <= length; i += 24, out += 32) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        __m256i block = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        block = _mm256_shuffle_epi8(block, shuffle);
+        const __m256i t0 = _mm256_and_si256(block, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(block, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        const __m256i ascii = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, range), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), ascii);
+    }
+    return i + encodeSsse3(in + i, length - i, out);
+}
+
+UD_TARGET_AVX2 qsizetype decodeAvx2(const char* in, qsizetype length, uchar* out)
+{
+    const __m256i lutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    qsizetype i = 0;
+    for (; i + 32 <= length; i += 32, out += 24) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(block, 4), nibbleMask);
+        const __m256i loNibbles = _mm256_and_si256(block, nibbleMask);
+        const __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+        const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+        const __m256i eqSlash = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('/'));
+        block = _mm256_add_epi8(block, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eqSlash, hiNibbles)));
+
+        const __m256i pairs = _mm256_maddubs_epi16(block, _mm256_set1_epi32(0x01400140));
+        const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const __m256i bytes = _mm256_shuffle_epi8(words, pack);
+        // Close the 4-byte gap between the two 12-byte lane results.
+        const __m256i packed = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+    }
+    return i + decodeSsse3(in + i, length - i, out);
+}
+#endif
+
+EncodeKernel selectEncodeKernel()
+{
+#if defined(UD_HAVE_SSE2)
+    if (cpuHasAvx2())
+        return &encodeAvx2;
+    if (cpuHasSsse3())
+        return &encodeSsse3;
+#endif
+    return &encodeNone;
+}
+
+DecodeKernel selectDecodeKernel()
+{
+#if defined(UD_HAVE_SSE2)
+    if (cpuHasAvx2())
+        return &decodeAvx2;
+    if (cpuHasSsse3())
+        return &decodeSsse3;
+#endif
+    return &decodeNone;
+}
+
+// Vector kernels need a full block to be worth calling.
+constexpr qsizetype minDecodeBlock = 16;
+// Largest overshoot of a decode kernel store past its real output.
+constexpr qsizetype decodeSlack = 32;
+
+} // namespace
+
+void Base64Encoder::update(QByteArrayView input, QByteArray& output)
+{
+    static const EncodeKernel kernel = selectEncodeKernel();
+
+    const auto* in = reinterpret_cast<const uchar*>(input.data());
+    qsizetype length = input.size();
+    const qsizetype groups = (_pendingLength + length) / 3;
+    if (groups == 0) {
+        for (qsizetype i = 0; i < length; ++i) {
+            _pending[_pendingLength++] = in[i];
+        }
+        return;
+    }
+
+    const qsizetype start = output.size();
+    output.resize(start + groups * 4);
+    char* out = output.data() + start;
+
+    if (_pendingLength > 0) {
+        uchar group[3] = { _pending[0], _pending[1], 0 };
+        const int take = 3 - _pendingLength;
+        for (int i = 0; i < take; ++i) {
+            group[_pendingLength + i] = in[i];
+        }
+        encodeGroup(group, out);
+        out += 4;
+        in += take;
+        length -= take;
+        _pendingLength = 0;
+    }
+
+    const qsizetype whole = length - length % 3;
+    qsizetype done = kernel(in, whole, out);
+    out += done / 3 * 4;
+    for (; done < whole; done += 3, out += 4) {
+        encodeGroup(in + done, out);
+    }
+    for (qsizetype i = whole; i < length; ++i) {
+        _pending[_pendingLength++] = in[i];
+    }
+}
+
+void Base64Encoder::finish(QByteArray& output)
+{
+    if (_pendingLength == 0) {
+        return;
+    }
+    uchar group[3] = { _pending[0], _pendingLength == 2 ? _pending[1] : uchar(0), 0 };
+    char chars[4];
+    encodeGroup(group, chars);
+    chars[3] = '=';
+    if (_pendingLength == 1) {
+        chars[2] = '=';
+    }
+    output.append(chars, 4);
+    _pendingLength = 0;
+}
+
+bool Base64Decoder::update(QByteArrayView input, QByteArray& output)
+{
+    static const DecodeKernel kernel = selectDecodeKernel();
+
+    if (_failed) {
+        return false;
+    }
+    const char* in = input.data();
+    const qsizetype length = input.size();
+    const qsizetype start = output.size();
+    output.resize(start + (_count + length) / 4 * 3 + decodeSlack);
+    char* out = output.data() + start;
+
+    qsizetype i = 0;
+    while (i < length) {
+        if (_count == 0 && _padding == 0 && length - i >= minDecodeBlock) {
+            const qsizetype consumed = kernel(in + i, length - i, reinterpret_cast<uchar*>(out));
+            i += consumed;
+            out += consumed / 4 * 3;
+            if (consumed > 0) {
+                continue;
+            }
+        }
+        // Something the kernel stopped at: go one block at a time until the
+        // groups line up again.
+        const qsizetype chunk = qMin(minDecodeBlock, length - i);
+        if (!decodeScalar(in + i, chunk, out)) {
+            output.resize(start);
+            return false;
+        }
+        i += chunk;
+    }
+    output.resize(out - output.constData());
+    return true;
+}
+
+bool Base64Decoder::finish(QByteArray& output)
+{
+    if (_failed) {
+        return false;
+    }
+    const int chars = _count - _padding;
+    if (_count == 0) {
+        return true;
+    }
+    if (chars < 2) {
+        _failed = true;
+        return false;
+    }
+    // Unpadded tail: 2 characters carry one byte, 3 carry two.
+    const quint32 bits = _bits << (6 * (4 - _count));
+    const char bytes[2] = { char(bits >> 16), char(bits >> 8) };
+    output.append(bytes, chars - 1);
+    _bits = 0;
+    _count = 0;
+    return true;
+}
+
+bool Base64Decoder::decodeScalar(const char* input, qsizetype length, char*& output)
+{
+    for (qsizetype i = 0; i < length; ++i) {
+        const char c = input[i];
+        if (isBase64Space(c)) {
+            continue;
+        }
+        if (c == '=') {
+            if (_count < 2) {
+                _failed = true;
+                return false;
+            }
+            _bits <<= 6;
+            ++_padding;
+        } else {
+            const qint8 value = decodeTable[uchar(c)];
+            if (value < 0 || _padding > 0) {
+                _failed = true;
+                return false;
+            }
+            _bits = (_bits << 6) | quint32(value);
+        }
+        if (++_count == 4) {
+            const char bytes[3] = { char(_bits >> 16), char(_bits >> 8), char(_bits) };
+            for (int b = 0; b < 3 - _padding; ++b) {
+                *output++ = bytes[b];
+            }
+            _bits = 0;
+            _count = 0;
+        }
+    }
+    return true;
+}
+
+QByteArray base64Encode(QByteArrayView data)
+{
+    QByteArray output;
+    output.reserve((data.size() + 2) / 3 * 4);
+    Base64Encoder encoder;
+    encoder.update(data, output);
+    encoder.finish(output);
+    return output;
+}
+
+std::optional<QByteArray> base64Decode(QByteArrayView text)
+{
+    QByteArray output;
+    Base64Decoder decoder;
+    if (!decoder.update(text, output) || !decoder.finish(output)) {
+        return std::nullopt;
+    }
+    return output;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+/**
+ * @brief Incremental base64 encoder (standard alphabet, padded). Feed input
+ * in chunks of any size; output for complete 3-byte groups is appended as
+ * soon as it is available, the rest once finish() is called.
+ */
+class Base64Encoder {
+public:
+    void update(QByteArrayView input, QByteArray& output);
+
+    void finish(QByteArray& output);
+
+private:
+    uchar _pending[2] = {};
+    int _pendingLength = 0;
+};
+
+/**
+ * @brief Incremental base64 decoder. Accepts the standard alphabet with or
+ * without padding and skips ASCII whitespace, so line-wrapped input works;
+ * anything else is an error. Once update() or finish() returned false the
+ * decoder stays failed.
+ */
+class Base64Decoder {
+public:
+    bool update(QByteArrayView input, QByteArray& output);
+
+    bool finish(QByteArray& output);
+
+private:
+    bool decodeScalar(const char* input, qsizetype length, char*& output);
+
+    quint32 _bits = 0;
+    int _count = 0; // characters of the current 4-character group seen so far
+    int _padding = 0;
+    bool _failed = false;
+};
+
+// One-shot helpers over the streaming classes. Decoding returns nullopt on
+// malformed input instead of silently dropping characters.
+QByteArray base64Encode(QByteArrayView data);
+
+std::optional<QByteArray> base64Decode(QByteArrayView text);
@@ -1,21 +1,7 @@
-#include <QAbstractNativeEventFilter>
-#include <QObject>
-#include <QQmlProperty>
-#include <QQuickItem>
-
-
 #include "UDFrameless.h"
 
-#include "UDTools.h"
-#include <QDateTime>
-#include <QGuiApplication>
-#include <QQuickWindow>
-#include <QScreen>
-#include <optional>
-
-
-
-
+#include <QByteArray>
+#include <QDebug>
 
 static DwmSetWindowAttributeFunc pDwmSetWindowAttribute = nullptr;
 static DwmExtendFrameIntoClientAreaFunc pDwmExtendFrameIntoClientArea = nullptr;
@@ -101,7 +87,9 @@ static inline QByteArray qtNativeEventType()
     return result;
 }
 
-static inline bool initializeFunctionPointers()
+// Only called through initializeFunctionPointers(), so the pointers above are
+// written once, before any thread can read them.
+static bool resolveFunctionPointers()
 {
     HMODULE module = LoadLibraryW(L"dwmapi.dll");
     if (module) {
@@ -136,7 +124,7 @@ static inline bool initializeFunctionPointers()
     }
 
     HMODULE user32 = LoadLibraryW(L"user32.dll");
-    if (module) {
+    if (user32) {
         if (!pSetWindowCompositionAttribute) {
             pSetWindowCompositionAttribute = reinterpret_cast<SetWindowCompositionAttributeFunc>(
                 GetProcAddress(user32, "SetWindowCompositionAttribute"));
@@ -164,6 +152,12 @@ static inline bool initializeFunctionPointers()
     return true;
 }
 
+static inline bool initializeFunctionPointers()
+{
+    static const bool resolved = resolveFunctionPointers();
+    return resolved;
+}
+
 static inline bool isCompositionEnabled()
 {
     if (initializeFunctionPointers()) {
@@ -375,19 +369,3 @@ bool setWindowEffect(long long hwndint, const int key, const bool& enable)
     }
     return false;
 }
-
-
-
-bool containsCursorToItem(QQuickItem* item)
-{
-    if (!item || !item->isVisible()) {
-        return false;
-    }
-    auto point = item->window()->mapFromGlobal(QCursor::pos());
-    auto rect = QRectF(item->mapToItem(item->window()->contentItem(), QPointF(0, 0)), item->size());
-    if (rect.contains(point)) {
-        return true;
-    }
-    return false;
-}
-
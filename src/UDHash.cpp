@@ -0,0 +1,648 @@
+#include "UDHash.h"
+#include "UDParallel.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+inline quint32 readLe32(const uchar* p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+inline quint64 readLe64(const uchar* p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+inline quint64 rotl64(quint64 v, int r)
+{
+    return (v << r) | (v >> (64 - r));
+}
+
+inline quint32 rotr32(quint32 v, int r)
+{
+    return (v >> r) | (v << (32 - r));
+}
+
+// ---------- XXH3-64 (seed 0, default secret) ----------
+
+constexpr quint32 prime32_1 = 0x9E3779B1U;
+constexpr quint32 prime32_2 = 0x85EBCA77U;
+constexpr quint32 prime32_3 = 0xC2B2AE3DU;
+constexpr quint64 prime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 prime64_3 = 0x165667B19E3779F9ULL;
+constexpr quint64 prime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 prime64_5 = 0x27D4EB2F165667C5ULL;
+
+constexpr size_t xxhStripeLen = 64;
+constexpr size_t xxhSecretConsumeRate = 8;
+constexpr size_t xxhAccCount = 8;
+constexpr size_t xxhSecretSize = 192;
+constexpr size_t xxhSecretMergeAccsStart = 11;
+constexpr size_t xxhSecretLastAccStart = 7;
+constexpr size_t xxhMidSizeMax = 240;
+constexpr size_t xxhSecretSizeMin = 136;
+constexpr size_t xxhBufferSize = 256;
+constexpr size_t xxhStripesPerBlock = (xxhSecretSize - xxhStripeLen) / xxhSecretConsumeRate;
+
+alignas(64) constexpr uchar xxhSecret[xxhSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+inline quint64 mul128Fold64(quint64 lhs, quint64 rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return quint64(product) ^ quint64(product >> 64);
+#else
+    const quint64 loLo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+    const quint64 hiLo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+    const quint64 loHi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+    const quint64 hiHi = (lhs >> 32) * (rhs >> 32);
+    const quint64 cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+    const quint64 upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+    const quint64 lower = (cross << 32) | (loLo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+inline quint64 xxh64Avalanche(quint64 h)
+{
+    h ^= h >> 33;
+    h *= prime64_2;
+    h ^= h >> 29;
+    h *= prime64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 xxh3Avalanche(quint64 h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+inline quint64 xxh3Rrmxmx(quint64 h, quint64 len)
+{
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= 0x9FB21C651E98DF25ULL;
+    h ^= (h >> 35) + len;
+    h *= 0x9FB21C651E98DF25ULL;
+    h ^= h >> 28;
+    return h;
+}
+
+inline quint64 xxh3Mix16(const uchar* input, const uchar* secret)
+{
+    return mul128Fold64(readLe64(input) ^ readLe64(secret), readLe64(input + 8) ^ readLe64(secret + 8));
+}
+
+quint64 xxh3Len0To16(const uchar* input, size_t len)
+{
+    const uchar* secret = xxhSecret;
+    if (len > 8) {
+        const quint64 lo = readLe64(input) ^ (readLe64(secret + 24) ^ readLe64(secret + 32));
+        const quint64 hi = readLe64(input + len - 8) ^ (readLe64(secret + 40) ^ readLe64(secret + 48));
+        const quint64 acc = len + qbswap(lo) + hi + mul128Fold64(lo, hi);
+        return xxh3Avalanche(acc);
+    }
+    if (len >= 4) {
+        const quint32 in1 = readLe32(input);
+        const quint32 in2 = readLe32(input + len - 4);
+        const quint64 flip = readLe64(secret + 8) ^ readLe64(secret + 16);
+        const quint64 keyed = (quint64(in2) + (quint64(in1) << 32)) ^ flip;
+        return xxh3Rrmxmx(keyed, len);
+    }
+    if (len > 0) {
+        const quint32 combined = (quint32(input[0]) << 16) | (quint32(input[len >> 1]) << 24)
+            | quint32(input[len - 1]) | (quint32(len) << 8);
+        const quint64 flip = readLe32(secret) ^ readLe32(secret + 4);
+        return xxh64Avalanche(quint64(combined) ^ flip);
+    }
+    return xxh64Avalanche(readLe64(secret + 56) ^ readLe64(secret + 64));
+}
+
+quint64 xxh3Len17To128(const uchar* input, size_t len)
+{
+    const uchar* secret = xxhSecret;
+    quint64 acc = len * prime64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += xxh3Mix16(input + 48, secret + 96);
+                acc += xxh3Mix16(input + len - 64, secret + 112);
+            }
+            acc += xxh3Mix16(input + 32, secret + 64);
+            acc += xxh3Mix16(input + len - 48, secret + 80);
+        }
+        acc += xxh3Mix16(input + 16, secret + 32);
+        acc += xxh3Mix16(input + len - 32, secret + 48);
+    }
+    acc += xxh3Mix16(input, secret);
+    acc += xxh3Mix16(input + len - 16, secret + 16);
+    return xxh3Avalanche(acc);
+}
+
+quint64 xxh3Len129To240(const uchar* input, size_t len)
+{
+    const uchar* secret = xxhSecret;
+    const size_t rounds = len / 16;
+    quint64 acc = len * prime64_1;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += xxh3Mix16(input + 16 * i, secret + 16 * i);
+    }
+    acc = xxh3Avalanche(acc);
+    for (size_t i = 8; i < rounds; ++i) {
+        acc += xxh3Mix16(input + 16 * i, secret + 16 * (i - 8) + 3);
+    }
+    acc += xxh3Mix16(input + len - 16, secret + xxhSecretSizeMin - 17);
+    return xxh3Avalanche(acc);
+}
+
+quint64 xxh3Short(const uchar* input, size_t len)
+{
+    if (len <= 16)
+        return xxh3Len0To16(input, len);
+    if (len <= 128)
+        return xxh3Len17To128(input, len);
+    return xxh3Len129To240(input, len);
+}
+
+inline void xxh3Accumulate512(quint64* acc, const uchar* input, const uchar* secret)
+{
+    for (size_t i = 0; i < xxhAccCount; ++i) {
+        const quint64 value = readLe64(input + 8 * i);
+        const quint64 key = value ^ readLe64(secret + 8 * i);
+        acc[i ^ 1] += value;
+        acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+    }
+}
+
+inline void xxh3Scramble(quint64* acc, const uchar* secret)
+{
+    for (size_t i = 0; i < xxhAccCount; ++i) {
+        quint64 a = acc[i];
+        a ^= a >> 47;
+        a ^= readLe64(secret + 8 * i);
+        acc[i] = a * prime32_1;
+    }
+}
+
+inline void xxh3AccumulateStripes(quint64* acc, const uchar* input, const uchar* secret, size_t stripes)
+{
+    for (size_t n = 0; n < stripes; ++n) {
+        xxh3Accumulate512(acc, input + n * xxhStripeLen, secret + n * xxhSecretConsumeRate);
+    }
+}
+
+quint64 xxh3MergeAccs(const quint64* acc, const uchar* secret, quint64 start)
+{
+    quint64 result = start;
+    for (size_t i = 0; i < 4; ++i) {
+        result += mul128Fold64(acc[2 * i] ^ readLe64(secret + 16 * i),
+            acc[2 * i + 1] ^ readLe64(secret + 16 * i + 8));
+    }
+    return xxh3Avalanche(result);
+}
+
+/**
+ * @brief Streaming XXH3-64 with the default secret and seed 0, bit-for-bit
+ * the same as XXH3_64bits() from the reference xxHash library.
+ */
+class Xxh3State {
+public:
+    void update(const uchar* input, size_t len)
+    {
+        _totalLen += len;
+        if (_buffered + len <= xxhBufferSize) {
+            std::memcpy(_buffer + _buffered, input, len);
+            _buffered += len;
+            return;
+        }
+
+        if (_buffered > 0) {
+            const size_t fill = xxhBufferSize - _buffered;
+            std::memcpy(_buffer + _buffered, input, fill);
+            input += fill;
+            len -= fill;
+            consumeStripes(_acc, _stripesSoFar, _buffer, xxhBufferSize / xxhStripeLen);
+            _buffered = 0;
+        }
+
+        if (len > xxhBufferSize) {
+            do {
+                consumeStripes(_acc, _stripesSoFar, input, xxhBufferSize / xxhStripeLen);
+                input += xxhBufferSize;
+                len -= xxhBufferSize;
+            } while (len > xxhBufferSize);
+            // Keep the last consumed stripe around for digest()'s catch-up.
+            std::memcpy(_buffer + xxhBufferSize - xxhStripeLen, input - xxhStripeLen, xxhStripeLen);
+        }
+
+        std::memcpy(_buffer, input, len);
+        _buffered = len;
+    }
+
+    quint64 digest() const
+    {
+        if (_totalLen <= xxhMidSizeMax) {
+            return xxh3Short(_buffer, _buffered);
+        }
+
+        quint64 acc[xxhAccCount];
+        std::memcpy(acc, _acc, sizeof(acc));
+        const uchar* lastSecret = xxhSecret + xxhSecretSize - xxhStripeLen - xxhSecretLastAccStart;
+        if (_buffered >= xxhStripeLen) {
+            size_t stripesSoFar = _stripesSoFar;
+            consumeStripes(acc, stripesSoFar, _buffer, (_buffered - 1) / xxhStripeLen);
+            xxh3Accumulate512(acc, _buffer + _buffered - xxhStripeLen, lastSecret);
+        } else {
+            uchar lastStripe[xxhStripeLen];
+            const size_t catchup = xxhStripeLen - _buffered;
+            std::memcpy(lastStripe, _buffer + xxhBufferSize - catchup, catchup);
+            std::memcpy(lastStripe + catchup, _buffer, _buffered);
+            xxh3Accumulate512(acc, lastStripe, lastSecret);
+        }
+        return xxh3MergeAccs(acc, xxhSecret + xxhSecretMergeAccsStart, _totalLen * prime64_1);
+    }
+
+private:
+    static void consumeStripes(quint64* acc, size_t& stripesSoFar, const uchar* input, size_t stripes)
+    {
+        if (xxhStripesPerBlock - stripesSoFar <= stripes) {
+            const size_t toEnd = xxhStripesPerBlock - stripesSoFar;
+            xxh3AccumulateStripes(acc, input, xxhSecret + stripesSoFar * xxhSecretConsumeRate, toEnd);
+            xxh3Scramble(acc, xxhSecret + xxhSecretSize - xxhStripeLen);
+            xxh3AccumulateStripes(acc, input + toEnd * xxhStripeLen, xxhSecret, stripes - toEnd);
+            stripesSoFar = stripes - toEnd;
+        } else {
+            xxh3AccumulateStripes(acc, input, xxhSecret + stripesSoFar * xxhSecretConsumeRate, stripes);
+            stripesSoFar += stripes;
+        }
+    }
+
+    quint64 _acc[xxhAccCount] = { prime32_3, prime64_1, prime64_2, prime64_3, prime64_4, prime32_2, prime64_5, prime32_1 };
+    alignas(64) uchar _buffer[xxhBufferSize] = {};
+    size_t _buffered = 0;
+    size_t _stripesSoFar = 0;
+    quint64 _totalLen = 0;
+};
+
+// ---------- BLAKE3 (unkeyed hash, 32 byte output) ----------
+
+constexpr size_t blake3BlockLen = 64;
+constexpr size_t blake3ChunkLen = 1024;
+constexpr quint32 blake3ChunkStart = 1 << 0;
+constexpr quint32 blake3ChunkEnd = 1 << 1;
+constexpr quint32 blake3Parent = 1 << 2;
+constexpr quint32 blake3Root = 1 << 3;
+
+constexpr quint32 blake3Iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+constexpr int blake3Permutation[16] = { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 };
+
+inline void blake3G(quint32* s, int a, int b, int c, int d, quint32 mx, quint32 my)
+{
+    s[a] = s[a] + s[b] + mx;
+    s[d] = rotr32(s[d] ^ s[a], 16);
+    s[c] = s[c] + s[d];
+    s[b] = rotr32(s[b] ^ s[c], 12);
+    s[a] = s[a] + s[b] + my;
+    s[d] = rotr32(s[d] ^ s[a], 8);
+    s[c] = s[c] + s[d];
+    s[b] = rotr32(s[b] ^ s[c], 7);
+}
+
+void blake3Compress(const quint32 cv[8], const quint32 block[16], quint64 counter, quint32 blockLen,
+    quint32 flags, quint32 out[16])
+{
+    quint32 s[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        blake3Iv[0], blake3Iv[1], blake3Iv[2], blake3Iv[3],
+        quint32(counter), quint32(counter >> 32), blockLen, flags
+    };
+    quint32 m[16];
+    std::memcpy(m, block, sizeof(m));
+    for (int round = 0; round < 7; ++round) {
+        blake3G(s, 0, 4, 8, 12, m[0], m[1]);
+        blake3G(s, 1, 5, 9, 13, m[2], m[3]);
+        blake3G(s, 2, 6, 10, 14, m[4], m[5]);
+        blake3G(s, 3, 7, 11, 15, m[6], m[7]);
+        blake3G(s, 0, 5, 10, 15, m[8], m[9]);
+        blake3G(s, 1, 6, 11, 12, m[10], m[11]);
+        blake3G(s, 2, 7, 8, 13, m[12], m[13]);
+        blake3G(s, 3, 4, 9, 14, m[14], m[15]);
+        quint32 permuted[16];
+        for (int i = 0; i < 16; ++i) {
+            permuted[i] = m[blake3Permutation[i]];
+        }
+        std::memcpy(m, permuted, sizeof(m));
+    }
+    for (int i = 0; i < 8; ++i) {
+        out[i] = s[i] ^ s[i + 8];
+        out[i + 8] = s[i + 8] ^ cv[i];
+    }
+}
+
+// Input to a compression that is either chained further or becomes the root.
+struct Blake3Output {
+    quint32 cv[8];
+    quint32 block[16];
+    quint64 counter;
+    quint32 blockLen;
+    quint32 flags;
+
+    void chainingValue(quint32 out[8]) const
+    {
+        quint32 full[16];
+        blake3Compress(cv, block, counter, blockLen, flags, full);
+        std::memcpy(out, full, 8 * sizeof(quint32));
+    }
+
+    void rootBytes(uchar out[32]) const
+    {
+        quint32 full[16];
+        blake3Compress(cv, block, 0, blockLen, flags | blake3Root, full);
+        for (int i = 0; i < 8; ++i) {
+            qToLittleEndian(full[i], out + 4 * i);
+        }
+    }
+};
+
+inline void blake3BlockWords(const uchar* bytes, quint32 words[16])
+{
+    for (int i = 0; i < 16; ++i) {
+        words[i] = readLe32(bytes + 4 * i);
+    }
+}
+
+Blake3Output blake3ParentOutput(const quint32 left[8], const quint32 right[8])
+{
+    Blake3Output output;
+    std::memcpy(output.cv, blake3Iv, sizeof(output.cv));
+    std::memcpy(output.block, left, 8 * sizeof(quint32));
+    std::memcpy(output.block + 8, right, 8 * sizeof(quint32));
+    output.counter = 0;
+    output.blockLen = blake3BlockLen;
+    output.flags = blake3Parent;
+    return output;
+}
+
+/**
+ * @brief Streaming BLAKE3 following the reference implementation's chunk
+ * state and chaining-value stack.
+ */
+class Blake3State {
+public:
+    Blake3State() { resetChunk(0); }
+
+    void update(const uchar* input, size_t len)
+    {
+        while (len > 0) {
+            if (chunkLength() == blake3ChunkLen) {
+                quint32 chunkCv[8];
+                chunkOutput().chainingValue(chunkCv);
+                const quint64 totalChunks = _chunkCounter + 1;
+                pushChunkCv(chunkCv, totalChunks);
+                resetChunk(totalChunks);
+            }
+            const size_t take = std::min(blake3ChunkLen - chunkLength(), len);
+            updateChunk(input, take);
+            input += take;
+            len -= take;
+        }
+    }
+
+    void finalize(uchar out[32]) const
+    {
+        Blake3Output output = chunkOutput();
+        for (size_t i = _stackLen; i > 0; --i) {
+            quint32 cv[8];
+            output.chainingValue(cv);
+            output = blake3ParentOutput(_stack[i - 1], cv);
+        }
+        output.rootBytes(out);
+    }
+
+private:
+    size_t chunkLength() const { return blake3BlockLen * _blocksCompressed + _blockLen; }
+
+    quint32 startFlag() const { return _blocksCompressed == 0 ? blake3ChunkStart : 0; }
+
+    void resetChunk(quint64 counter)
+    {
+        std::memcpy(_cv, blake3Iv, sizeof(_cv));
+        _chunkCounter = counter;
+        std::memset(_block, 0, sizeof(_block));
+        _blockLen = 0;
+        _blocksCompressed = 0;
+    }
+
+    void updateChunk(const uchar* input, size_t len)
+    {
+        while (len > 0) {
+            if (_blockLen == blake3BlockLen) {
+                quint32 words[16];
+                quint32 out[16];
+                blake3BlockWords(_block, words);
+                blake3Compress(_cv, words, _chunkCounter, blake3BlockLen, startFlag(), out);
+                std::memcpy(_cv, out, sizeof(_cv));
+                ++_blocksCompressed;
+                std::memset(_block, 0, sizeof(_block));
+                _blockLen = 0;
+            }
+            const size_t take = std::min(blake3BlockLen - _blockLen, len);
+            std::memcpy(_block + _blockLen, input, take);
+            _blockLen += take;
+            input += take;
+            len -= take;
+        }
+    }
+
+    Blake3Output chunkOutput() const
+    {
+        Blake3Output output;
+        std::memcpy(output.cv, _cv, sizeof(output.cv));
+        blake3BlockWords(_block, output.block);
+        output.counter = _chunkCounter;
+        output.blockLen = quint32(_blockLen);
+        output.flags = startFlag() | blake3ChunkEnd;
+        return output;
+    }
+
+    // Merge completed subtrees: one parent per trailing zero bit of totalChunks.
+    void pushChunkCv(const quint32 chunkCv[8], quint64 totalChunks)
+    {
+        quint32 cv[8];
+        std::memcpy(cv, chunkCv, sizeof(cv));
+        while ((totalChunks & 1) == 0) {
+            blake3ParentOutput(_stack[--_stackLen], cv).chainingValue(cv);
+            totalChunks >>= 1;
+        }
+        std::memcpy(_stack[_stackLen++], cv, sizeof(cv));
+    }
+
+    quint32 _cv[8];
+    quint64 _chunkCounter = 0;
+    uchar _block[blake3BlockLen];
+    size_t _blockLen = 0;
+    size_t _blocksCompressed = 0;
+    quint32 _stack[54][8];
+    size_t _stackLen = 0;
+};
+
+// Large enough to amortise syscalls, small enough to stay in L2.
+constexpr qint64 readChunkSize = 1 << 20;
+// Map big files piecewise so 32-bit builds and huge files both work.
+constexpr qint64 mapWindowSize = qint64(256) << 20;
+
+} // namespace
+
+std::optional<HashAlgorithm> hashAlgorithmFromName(QStringView name)
+{
+    if (name.compare(u"md5", Qt::CaseInsensitive) == 0)
+        return HashAlgorithm::Md5;
+    if (name.compare(u"sha256", Qt::CaseInsensitive) == 0)
+        return HashAlgorithm::Sha256;
+    if (name.compare(u"xxh3", Qt::CaseInsensitive) == 0)
+        return HashAlgorithm::Xxh3;
+    if (name.compare(u"blake3", Qt::CaseInsensitive) == 0)
+        return HashAlgorithm::Blake3;
+    return std::nullopt;
+}
+
+struct StreamHasher::Private {
+    HashAlgorithm algorithm;
+    std::unique_ptr<QCryptographicHash> crypto;
+    std::unique_ptr<Xxh3State> xxh3;
+    std::unique_ptr<Blake3State> blake3;
+};
+
+StreamHasher::StreamHasher(HashAlgorithm algorithm)
+    : d(new Private { algorithm, nullptr, nullptr, nullptr })
+{
+    switch (algorithm) {
+    case HashAlgorithm::Md5:
+        d->crypto.reset(new QCryptographicHash(QCryptographicHash::Md5));
+        break;
+    case HashAlgorithm::Sha256:
+        d->crypto.reset(new QCryptographicHash(QCryptographicHash::Sha256));
+        break;
+    case HashAlgorithm::Xxh3:
+        d->xxh3.reset(new Xxh3State);
+        break;
+    case HashAlgorithm::Blake3:
+        d->blake3.reset(new Blake3State);
+        break;
+    }
+}
+
+StreamHasher::~StreamHasher() = default;
+
+void StreamHasher::addData(QByteArrayView data)
+{
+    const auto* bytes = reinterpret_cast<const uchar*>(data.data());
+    const size_t len = size_t(data.size());
+    if (d->crypto) {
+        d->crypto->addData(data);
+    } else if (d->xxh3) {
+        d->xxh3->update(bytes, len);
+    } else {
+        d->blake3->update(bytes, len);
+    }
+}
+
+QByteArray StreamHasher::result() const
+{
+    if (d->crypto) {
+        return d->crypto->result();
+    }
+    if (d->xxh3) {
+        QByteArray digest(8, Qt::Uninitialized);
+        qToBigEndian(d->xxh3->digest(), digest.data());
+        return digest;
+    }
+    QByteArray digest(32, Qt::Uninitialized);
+    d->blake3->finalize(reinterpret_cast<uchar*>(digest.data()));
+    return digest;
+}
+
+QByteArray hashBytes(QByteArrayView data, HashAlgorithm algorithm)
+{
+    StreamHasher hasher(algorithm);
+    hasher.addData(data);
+    return hasher.result();
+}
+
+QByteArray hashFile(const QString& path, HashAlgorithm algorithm)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    StreamHasher hasher(algorithm);
+    const qint64 size = file.size();
+    qint64 offset = 0;
+    while (offset < size) {
+        const qint64 window = qMin(mapWindowSize, size - offset);
+        uchar* mapped = file.map(offset, window);
+        if (!mapped) {
+            break;
+        }
+        hasher.addData(QByteArrayView(mapped, window));
+        file.unmap(mapped);
+        offset += window;
+    }
+
+    // Pipes, procfs and friends cannot be mapped (and report no size).
+    if (offset < size || file.isSequential() || size == 0) {
+        if (!file.seek(offset) && !file.isSequential()) {
+            return {};
+        }
+        QByteArray buffer(readChunkSize, Qt::Uninitialized);
+        qint64 read = 0;
+        while ((read = file.read(buffer.data(), buffer.size())) > 0) {
+            hasher.addData(QByteArrayView(buffer.constData(), read));
+        }
+        if (read < 0) {
+            return {};
+        }
+    }
+    return hasher.result();
+}
+
+QList<QByteArray> hashFiles(const QStringList& paths, HashAlgorithm algorithm)
+{
+    QList<QByteArray> results(paths.size());
+    std::atomic<qsizetype> next { 0 };
+    parallelFor(parallelTasks(paths.size()), [&](int) {
+        for (qsizetype i = next++; i < paths.size(); i = next++) {
+            results[i] = hashFile(paths[i], algorithm);
+        }
+    });
+    return results;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QStringList>
+
+enum class HashAlgorithm {
+    Md5,
+    Sha256,
+    Xxh3, // XXH3-64, non-cryptographic, 8 byte digest
+    Blake3, // BLAKE3, 32 byte digest
+};
+
+// Parse "md5", "sha256", "xxh3" or "blake3" (case-insensitive).
+std::optional<HashAlgorithm> hashAlgorithmFromName(QStringView name);
+
+/**
+ * @brief Incremental hasher over any HashAlgorithm. Digests are raw bytes;
+ * XXH3 is returned in its canonical big-endian form, as xxhsum prints it.
+ */
+class StreamHasher {
+public:
+    explicit StreamHasher(HashAlgorithm algorithm);
+    ~StreamHasher();
+
+    void addData(QByteArrayView data);
+
+    QByteArray result() const;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> d;
+};
+
+QByteArray hashBytes(QByteArrayView data, HashAlgorithm algorithm);
+
+// Hash a file without reading it into memory: the file is mmap'd in windows
+// and fed straight to the hasher, falling back to chunked reads where mapping
+// is not possible. Returns an empty array if the file cannot be read.
+QByteArray hashFile(const QString& path, HashAlgorithm algorithm);
+
+// hashFile() for many files, spread across the global thread pool.
+QList<QByteArray> hashFiles(const QStringList& paths, HashAlgorithm algorithm);
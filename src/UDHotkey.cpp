@@ -0,0 +1,223 @@
+#include "UDHotkey.h"
+
+#include <QGuiApplication>
+#include <QHotkey>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace {
+
+std::size_t ringCapacity(std::size_t requested)
+{
+    std::size_t capacity = 2;
+    while (capacity < requested) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+qint64 monotonicNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+HotkeyEventRing::HotkeyEventRing(std::size_t capacity)
+    : _slots(ringCapacity(capacity))
+    , _mask(_slots.size() - 1)
+{
+}
+
+bool HotkeyEventRing::push(const HotkeyEvent& event)
+{
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == _slots.size()) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _slots[head & _mask] = event;
+    // seq_cst pairs with wait(): either it sees this event or we see it asleep.
+    _head.store(head + 1);
+    if (_sleepers.load() > 0) {
+        wake();
+    }
+    return true;
+}
+
+std::size_t HotkeyEventRing::drain(std::vector<HotkeyEvent>& out, std::size_t max)
+{
+    const std::size_t tail = _tail.load(std::memory_order_relaxed);
+    const std::size_t count = std::min(_head.load(std::memory_order_acquire) - tail, max);
+    for (std::size_t i = 0; i < count; ++i) {
+        out.push_back(_slots[(tail + i) & _mask]);
+    }
+    _tail.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+bool HotkeyEventRing::wait(int timeoutMs)
+{
+    if (!isEmpty() || _interrupted.load()) {
+        return !isEmpty();
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    _sleepers.fetch_add(1);
+    const auto ready = [this] { return !isEmpty() || _interrupted.load(); };
+    if (timeoutMs < 0) {
+        _ready.wait(lock, ready);
+    } else {
+        _ready.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+    }
+    _sleepers.fetch_sub(1);
+    return !isEmpty();
+}
+
+void HotkeyEventRing::interrupt()
+{
+    _interrupted.store(true);
+    wake();
+}
+
+void HotkeyEventRing::resume()
+{
+    _interrupted.store(false);
+}
+
+bool HotkeyEventRing::isEmpty() const
+{
+    return _head.load() == _tail.load();
+}
+
+void HotkeyEventRing::wake()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _ready.notify_all();
+}
+
+LingmoHotkeys::LingmoHotkeys(QObject* parent)
+    : QObject { parent }
+{
+    // Delivered once the thread this object lives on processes events; the
+    // posted call moves along if the object is moved to another thread.
+    QMetaObject::invokeMethod(this, [this] { _loopRunning.store(true); }, Qt::QueuedConnection);
+    if (QCoreApplication* app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, [this] { _loopRunning.store(false); });
+    }
+}
+
+LingmoHotkeys::~LingmoHotkeys()
+{
+    qDeleteAll(_hotkeys);
+}
+
+bool LingmoHotkeys::isSupported()
+{
+    // The X11/Wayland checks dereference qGuiApp.
+    return qobject_cast<QGuiApplication*>(QCoreApplication::instance()) && QHotkey::isPlatformSupported();
+}
+
+int LingmoHotkeys::add(const QKeySequence& shortcut, QString* error)
+{
+    if (QThread::currentThread() != thread()) {
+        int id = -1;
+        QString callError;
+        callOnThread([&] { id = add(shortcut, &callError); }, &callError);
+        if (error) {
+            *error = callError;
+        }
+        return id;
+    }
+
+    if (shortcut.isEmpty()) {
+        if (error) {
+            *error = QStringLiteral("empty shortcut");
+        }
+        return -1;
+    }
+    auto* hotkey = new QHotkey(this);
+    if (!hotkey->setShortcut(shortcut, true)) {
+        if (error) {
+            *error = QStringLiteral("cannot register %1 as a global shortcut").arg(shortcut.toString());
+        }
+        delete hotkey;
+        return -1;
+    }
+
+    const int id = ++_nextId;
+    _hotkeys.insert(id, hotkey);
+    connect(hotkey, &QHotkey::activated, this, [this, id] { queue(id, HotkeyEvent::Activated); });
+    connect(hotkey, &QHotkey::released, this, [this, id] { queue(id, HotkeyEvent::Released); });
+    return id;
+}
+
+bool LingmoHotkeys::remove(int id)
+{
+    if (QThread::currentThread() != thread()) {
+        bool removed = false;
+        callOnThread([&] { removed = remove(id); }, nullptr);
+        return removed;
+    }
+
+    QHotkey* hotkey = _hotkeys.take(id);
+    delete hotkey;
+    return hotkey != nullptr;
+}
+
+// Like a BlockingQueuedConnection, but gives up instead of hanging when this
+// object's thread is not running an event loop or is itself blocked. A call
+// given up on is skipped if that thread gets to it later, so call may refer
+// to the caller's stack.
+bool LingmoHotkeys::callOnThread(const std::function<void()>& call, QString* error)
+{
+    if (!isEventLoopRunning()) {
+        if (error) {
+            *error = QStringLiteral("the Qt event loop of the hotkey thread is not running");
+        }
+        return false;
+    }
+
+    struct Pending {
+        std::mutex mutex;
+        std::condition_variable done;
+        bool finished = false;
+        bool abandoned = false;
+    };
+    const auto pending = std::make_shared<Pending>();
+    QMetaObject::invokeMethod(this, [pending, call] {
+        // Held while call runs, so the caller cannot give up halfway.
+        std::lock_guard<std::mutex> lock(pending->mutex);
+        if (pending->abandoned) {
+            return;
+        }
+        call();
+        pending->finished = true;
+        pending->done.notify_all();
+    }, Qt::QueuedConnection);
+
+    std::unique_lock<std::mutex> lock(pending->mutex);
+    if (!pending->done.wait_for(lock, std::chrono::milliseconds(callTimeoutMs), [&] { return pending->finished; })) {
+        pending->abandoned = true;
+        if (error) {
+            *error = QStringLiteral("the hotkey thread did not respond within %1 ms").arg(callTimeoutMs);
+        }
+        return false;
+    }
+    return true;
+}
+
+void LingmoHotkeys::queue(int id, HotkeyEvent::Kind kind)
+{
+    _events->push({ id, kind, monotonicNanoseconds() });
+    if (kind == HotkeyEvent::Activated) {
+        Q_EMIT activated(id);
+    } else {
+        Q_EMIT released(id);
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef LINGMOHOTKEYS_H
+#define LINGMOHOTKEYS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QHash>
+#include <QKeySequence>
+#include <QObject>
+
+#include "singleton.h"
+
+class QHotkey;
+
+/**
+ * @brief One activation or release of a hotkey registered with LingmoHotkeys.
+ */
+struct HotkeyEvent {
+    enum Kind : quint8 {
+        Activated,
+        Released,
+    };
+
+    int id = 0;
+    Kind kind = Activated;
+    // steady_clock nanoseconds when the event was queued; CLOCK_MONOTONIC on
+    // Linux, i.e. comparable with Python's time.monotonic_ns().
+    qint64 timestamp = 0;
+};
+
+/**
+ * @brief Fixed-size single-producer, single-consumer queue of hotkey events.
+ *
+ * push() and drain() never lock. Consumers that run dry can sleep in
+ * wait(), any number at once; the producer only touches the mutex when
+ * someone is sleeping. When the ring is full new events are dropped and
+ * counted.
+ */
+class HotkeyEventRing {
+public:
+    // capacity is rounded up to a power of two.
+    explicit HotkeyEventRing(std::size_t capacity = 1024);
+
+    // Producer side.
+    bool push(const HotkeyEvent& event);
+
+    // Consumer side: append up to max queued events to out, oldest first.
+    std::size_t drain(std::vector<HotkeyEvent>& out, std::size_t max = std::size_t(-1));
+
+    // Consumer side: block until there is an event, the ring is interrupted
+    // or timeoutMs passes (negative waits forever). True if an event is queued.
+    bool wait(int timeoutMs = -1);
+
+    // Wake every consumer sleeping in wait(). Sticky: wait() keeps returning
+    // at once until resume(), so a consumer about to sleep cannot miss it.
+    void interrupt();
+    void resume();
+
+    bool isEmpty() const;
+
+    quint64 dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    void wake();
+
+    std::vector<HotkeyEvent> _slots;
+    const std::size_t _mask;
+    alignas(64) std::atomic<std::size_t> _head { 0 }; // next slot to write
+    alignas(64) std::atomic<std::size_t> _tail { 0 }; // next slot to read
+    std::atomic<quint64> _dropped { 0 };
+    std::atomic<int> _sleepers { 0 };
+    std::atomic<bool> _interrupted { false };
+    std::mutex _mutex;
+    std::condition_variable _ready;
+};
+
+/**
+ * @brief The LingmoHotkeys class. Owns system-wide QHotkey registrations by
+ * id and reports their activations both as signals and through events(),
+ * so consumers outside the Qt event loop (the Python bindings) can take
+ * them in batches.
+ */
+class LingmoHotkeys : public QObject {
+    Q_OBJECT
+
+private:
+    explicit LingmoHotkeys(QObject* parent = nullptr);
+
+public:
+    SINGLETON(LingmoHotkeys)
+
+    ~LingmoHotkeys() override;
+
+    static bool isSupported();
+
+    // Whether this object's thread has started processing events (and not
+    // yet quit). Calls from other threads need it to get anywhere.
+    bool isEventLoopRunning() const { return _loopRunning.load(); }
+
+    // Register shortcut system-wide. Returns its id, or -1 with the reason in
+    // error. Callable from any thread; the QHotkey lives on this object's.
+    // From another thread this fails rather than blocks when that thread is
+    // not processing events, or does not get to the call within callTimeoutMs.
+    int add(const QKeySequence& shortcut, QString* error = nullptr);
+
+    bool remove(int id);
+
+    static constexpr int callTimeoutMs = 5000;
+
+    // Shared so a consumer thread can outlive this object.
+    std::shared_ptr<HotkeyEventRing> events() const { return _events; }
+
+Q_SIGNALS:
+    void activated(int id);
+    void released(int id);
+
+private:
+    void queue(int id, HotkeyEvent::Kind kind);
+    bool callOnThread(const std::function<void()>& call, QString* error);
+
+    QHash<int, QHotkey*> _hotkeys;
+    int _nextId = 0;
+    std::atomic<bool> _loopRunning { false };
+    const std::shared_ptr<HotkeyEventRing> _events = std::make_shared<HotkeyEventRing>();
+};
+
+#endif // LINGMOHOTKEYS_H
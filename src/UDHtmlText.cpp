@@ -0,0 +1,406 @@
+#include "UDHtmlText.h"
+#include "UDParallel.h"
+#include "UDStringSwitch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <string_view>
+
+namespace {
+
+struct Entity {
+    std::string_view name;
+    char32_t code;
+};
+
+// HTML 4 character entities plus &apos;, sorted by name for binary search.
+constexpr Entity entities[] = {
+    { "AElig", 0x00C6 }, { "Aacute", 0x00C1 }, { "Acirc", 0x00C2 }, { "Agrave", 0x00C0 },
+    { "Alpha", 0x0391 }, { "Aring", 0x00C5 }, { "Atilde", 0x00C3 }, { "Auml", 0x00C4 },
+    { "Beta", 0x0392 }, { "Ccedil", 0x00C7 }, { "Chi", 0x03A7 }, { "Dagger", 0x2021 },
+    { "Delta", 0x0394 }, { "ETH", 0x00D0 }, { "Eacute", 0x00C9 }, { "Ecirc", 0x00CA },
+    { "Egrave", 0x00C8 }, { "Epsilon", 0x0395 }, { "Eta", 0x0397 }, { "Euml", 0x00CB },
+    { "Gamma", 0x0393 }, { "Iacute", 0x00CD }, { "Icirc", 0x00CE }, { "Igrave", 0x00CC },
+    { "Iota", 0x0399 }, { "Iuml", 0x00CF }, { "Kappa", 0x039A }, { "Lambda", 0x039B },
+    { "Mu", 0x039C }, { "Ntilde", 0x00D1 }, { "Nu", 0x039D }, { "OElig", 0x0152 },
+    { "Oacute", 0x00D3 }, { "Ocirc", 0x00D4 }, { "Ograve", 0x00D2 }, { "Omega", 0x03A9 },
+    { "Omicron", 0x039F }, { "Oslash", 0x00D8 }, { "Otilde", 0x00D5 }, { "Ouml", 0x00D6 },
+    { "Phi", 0x03A6 }, { "Pi", 0x03A0 }, { "Prime", 0x2033 }, { "Psi", 0x03A8 }, { "Rho", 0x03A1 },
+    { "Scaron", 0x0160 }, { "Sigma", 0x03A3 }, { "THORN", 0x00DE }, { "Tau", 0x03A4 },
+    { "Theta", 0x0398 }, { "Uacute", 0x00DA }, { "Ucirc", 0x00DB }, { "Ugrave", 0x00D9 },
+    { "Upsilon", 0x03A5 }, { "Uuml", 0x00DC }, { "Xi", 0x039E }, { "Yacute", 0x00DD },
+    { "Yuml", 0x0178 }, { "Zeta", 0x0396 }, { "aacute", 0x00E1 }, { "acirc", 0x00E2 },
+    { "acute", 0x00B4 }, { "aelig", 0x00E6 }, { "agrave", 0x00E0 }, { "alefsym", 0x2135 },
+    { "alpha", 0x03B1 }, { "amp", 0x0026 }, { "and", 0x2227 }, { "ang", 0x2220 },
+    { "apos", 0x0027 }, { "aring", 0x00E5 }, { "asymp", 0x2248 }, { "atilde", 0x00E3 },
+    { "auml", 0x00E4 }, { "bdquo", 0x201E }, { "beta", 0x03B2 }, { "brvbar", 0x00A6 },
+    { "bull", 0x2022 }, { "cap", 0x2229 }, { "ccedil", 0x00E7 }, { "cedil", 0x00B8 },
+    { "cent", 0x00A2 }, { "chi", 0x03C7 }, { "circ", 0x02C6 }, { "clubs", 0x2663 },
+    { "cong", 0x2245 }, { "copy", 0x00A9 }, { "crarr", 0x21B5 }, { "cup", 0x222A },
+    { "curren", 0x00A4 }, { "dArr", 0x21D3 }, { "dagger", 0x2020 }, { "darr", 0x2193 },
+    { "deg", 0x00B0 }, { "delta", 0x03B4 }, { "diams", 0x2666 }, { "divide", 0x00F7 },
+    { "eacute", 0x00E9 }, { "ecirc", 0x00EA }, { "egrave", 0x00E8 }, { "empty", 0x2205 },
+    { "emsp", 0x2003 }, { "ensp", 0x2002 }, { "epsilon", 0x03B5 }, { "equiv", 0x2261 },
+    { "eta", 0x03B7 }, { "eth", 0x00F0 }, { "euml", 0x00EB }, { "euro", 0x20AC },
+    { "exist", 0x2203 }, { "fnof", 0x0192 }, { "forall", 0x2200 }, { "frac12", 0x00BD },
+    { "frac14", 0x00BC }, { "frac34", 0x00BE }, { "frasl", 0x2044 }, { "gamma", 0x03B3 },
+    { "ge", 0x2265 }, { "gt", 0x003E }, { "hArr", 0x21D4 }, { "harr", 0x2194 },
+    { "hearts", 0x2665 }, { "hellip", 0x2026 }, { "iacute", 0x00ED }, { "icirc", 0x00EE },
+    { "iexcl", 0x00A1 }, { "igrave", 0x00EC }, { "image", 0x2111 }, { "infin", 0x221E },
+    { "int", 0x222B }, { "iota", 0x03B9 }, { "iquest", 0x00BF }, { "isin", 0x2208 },
+    { "iuml", 0x00EF }, { "kappa", 0x03BA }, { "lArr", 0x21D0 }, { "lambda", 0x03BB },
+    { "lang", 0x2329 }, { "laquo", 0x00AB }, { "larr", 0x2190 }, { "lceil", 0x2308 },
+    { "ldquo", 0x201C }, { "le", 0x2264 }, { "lfloor", 0x230A }, { "lowast", 0x2217 },
+    { "loz", 0x25CA }, { "lrm", 0x200E }, { "lsaquo", 0x2039 }, { "lsquo", 0x2018 },
+    { "lt", 0x003C }, { "macr", 0x00AF }, { "mdash", 0x2014 }, { "micro", 0x00B5 },
+    { "middot", 0x00B7 }, { "minus", 0x2212 }, { "mu", 0x03BC }, { "nabla", 0x2207 },
+    { "nbsp", 0x00A0 }, { "ndash", 0x2013 }, { "ne", 0x2260 }, { "ni", 0x220B }, { "not", 0x00AC },
+    { "notin", 0x2209 }, { "nsub", 0x2284 }, { "ntilde", 0x00F1 }, { "nu", 0x03BD },
+    { "oacute", 0x00F3 }, { "ocirc", 0x00F4 }, { "oelig", 0x0153 }, { "ograve", 0x00F2 },
+    { "oline", 0x203E }, { "omega", 0x03C9 }, { "omicron", 0x03BF }, { "oplus", 0x2295 },
+    { "or", 0x2228 }, { "ordf", 0x00AA }, { "ordm", 0x00BA }, { "oslash", 0x00F8 },
+    { "otilde", 0x00F5 }, { "otimes", 0x2297 }, { "ouml", 0x00F6 }, { "para", 0x00B6 },
+    { "part", 0x2202 }, { "permil", 0x2030 }, { "perp", 0x22A5 }, { "phi", 0x03C6 },
+    { "pi", 0x03C0 }, { "piv", 0x03D6 }, { "plusmn", 0x00B1 }, { "pound", 0x00A3 },
+    { "prime", 0x2032 }, { "prod", 0x220F }, { "prop", 0x221D }, { "psi", 0x03C8 },
+    { "quot", 0x0022 }, { "rArr", 0x21D2 }, { "radic", 0x221A }, { "rang", 0x232A },
+    { "raquo", 0x00BB }, { "rarr", 0x2192 }, { "rceil", 0x2309 }, { "rdquo", 0x201D },
+    { "real", 0x211C }, { "reg", 0x00AE }, { "rfloor", 0x230B }, { "rho", 0x03C1 },
+    { "rlm", 0x200F }, { "rsaquo", 0x203A }, { "rsquo", 0x2019 }, { "sbquo", 0x201A },
+    { "scaron", 0x0161 }, { "sdot", 0x22C5 }, { "sect", 0x00A7 }, { "shy", 0x00AD },
+    { "sigma", 0x03C3 }, { "sigmaf", 0x03C2 }, { "sim", 0x223C }, { "spades", 0x2660 },
+    { "sub", 0x2282 }, { "sube", 0x2286 }, { "sum", 0x2211 }, { "sup", 0x2283 }, { "sup1", 0x00B9 },
+    { "sup2", 0x00B2 }, { "sup3", 0x00B3 }, { "supe", 0x2287 }, { "szlig", 0x00DF },
+    { "tau", 0x03C4 }, { "there4", 0x2234 }, { "theta", 0x03B8 }, { "thetasym", 0x03D1 },
+    { "thinsp", 0x2009 }, { "thorn", 0x00FE }, { "tilde", 0x02DC }, { "times", 0x00D7 },
+    { "trade", 0x2122 }, { "uArr", 0x21D1 }, { "uacute", 0x00FA }, { "uarr", 0x2191 },
+    { "ucirc", 0x00FB }, { "ugrave", 0x00F9 }, { "uml", 0x00A8 }, { "upsih", 0x03D2 },
+    { "upsilon", 0x03C5 }, { "uuml", 0x00FC }, { "weierp", 0x2118 }, { "xi", 0x03BE },
+    { "yacute", 0x00FD }, { "yen", 0x00A5 }, { "yuml", 0x00FF }, { "zeta", 0x03B6 },
+    { "zwj", 0x200D }, { "zwnj", 0x200C },
+};
+
+constexpr qsizetype maxEntityNameLength = 8;
+constexpr qsizetype maxTagNameLength = 15;
+
+constexpr StringSwitch blockTags { { "address", "article", "aside", "blockquote", "body", "caption",
+    "center", "dd", "div", "dl", "dt", "figcaption", "figure", "footer", "form", "h1", "h2", "h3", "h4", "h5",
+    "h6", "header", "hr", "html", "li", "main", "nav", "ol", "p", "section", "table", "td", "th", "tr", "ul" } };
+
+// Elements whose content is never text: skipped up to the matching end tag.
+constexpr StringSwitch rawTextTags { { "script", "style", "title", "textarea" } };
+
+inline bool isHtmlSpace(char16_t c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+inline bool isAsciiAlnum(char16_t c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+inline bool isAsciiLetter(char16_t c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char toAsciiLower(char16_t c)
+{
+    return char(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+std::optional<char32_t> lookupEntity(std::string_view name)
+{
+    const auto it = std::lower_bound(std::begin(entities), std::end(entities), name,
+        [](const Entity& entity, std::string_view key) { return entity.name < key; });
+    if (it == std::end(entities) || it->name != name) {
+        return std::nullopt;
+    }
+    return it->code;
+}
+
+/**
+ * @brief Output side of the converter: whitespace collapsing and the line
+ * structure. Separators are kept pending until more text arrives, so runs of
+ * block boundaries give one newline and nothing trails at the end.
+ */
+class PlainTextWriter {
+public:
+    explicit PlainTextWriter(qsizetype capacity) { _out.reserve(capacity); }
+
+    void text(char32_t c)
+    {
+        if (_pre == 0 && c < 0x80 && isHtmlSpace(char16_t(c))) {
+            _pendingSpace = _lineHasText;
+            return;
+        }
+        if (_pre > 0 && (c == '\n' || c == '\r')) {
+            if (c == '\n') {
+                lineBreak();
+            }
+            return;
+        }
+        flushPending();
+        // QTextDocument turns non-breaking spaces into plain ones.
+        if (c == 0xA0) {
+            c = ' ';
+        }
+        if (QChar::requiresSurrogates(c)) {
+            _out.append(QChar(QChar::highSurrogate(c)));
+            _out.append(QChar(QChar::lowSurrogate(c)));
+        } else {
+            _out.append(QChar(char16_t(c)));
+        }
+        _lineHasText = true;
+    }
+
+    void blockBoundary()
+    {
+        _pendingSpace = false;
+        if (_lineHasText) {
+            _pendingNewline = true;
+        }
+        _lineHasText = false;
+    }
+
+    void lineBreak()
+    {
+        flushPending();
+        _out.append(QLatin1Char('\n'));
+        _lineHasText = false;
+    }
+
+    void enterPre() { ++_pre; }
+
+    void leavePre() { _pre = qMax(0, _pre - 1); }
+
+    QString result() { return std::move(_out); }
+
+private:
+    void flushPending()
+    {
+        if (_pendingNewline) {
+            _out.append(QLatin1Char('\n'));
+            _pendingNewline = false;
+            _pendingSpace = false;
+        } else if (_pendingSpace) {
+            _out.append(QLatin1Char(' '));
+            _pendingSpace = false;
+        }
+    }
+
+    QString _out;
+    int _pre = 0;
+    bool _lineHasText = false;
+    bool _pendingSpace = false;
+    bool _pendingNewline = false;
+};
+
+class HtmlTextConverter {
+public:
+    explicit HtmlTextConverter(QStringView html)
+        : _html(html)
+        , _writer(html.size())
+    {
+    }
+
+    QString run()
+    {
+        while (_pos < _html.size()) {
+            const char16_t c = _html[_pos].unicode();
+            if (c == '<' && tag()) {
+                continue;
+            }
+            if (c == '&') {
+                entity();
+                continue;
+            }
+            put(c);
+            ++_pos;
+        }
+        return _writer.result();
+    }
+
+private:
+    void put(char32_t c)
+    {
+        if (_headDepth == 0) {
+            _writer.text(c);
+        }
+    }
+
+    // Handle the markup at _pos, or return false if that '<' is just text.
+    bool tag()
+    {
+        const qsizetype size = _html.size();
+        qsizetype i = _pos + 1;
+        if (i >= size) {
+            return false;
+        }
+        const char16_t first = _html[i].unicode();
+        if (first == '!' || first == '?') {
+            const bool comment = first == '!' && _html.sliced(i).startsWith(u"!--");
+            const qsizetype end = comment ? _html.indexOf(u"-->", i + 3) : _html.indexOf(u'>', i);
+            _pos = end < 0 ? size : end + (comment ? 3 : 1);
+            return true;
+        }
+        const bool closing = first == '/';
+        if (closing) {
+            ++i;
+        }
+        if (i >= size || !isAsciiLetter(_html[i].unicode())) {
+            return false;
+        }
+
+        char name[maxTagNameLength];
+        qsizetype length = 0;
+        for (; i < size && isAsciiAlnum(_html[i].unicode()); ++i, ++length) {
+            if (length < maxTagNameLength) {
+                name[length] = toAsciiLower(_html[i].unicode());
+            }
+        }
+        // Skip attributes, honouring quotes so a '>' inside a value is harmless.
+        char16_t quote = 0;
+        bool selfClosing = false;
+        for (; i < size; ++i) {
+            const char16_t c = _html[i].unicode();
+            if (quote) {
+                if (c == quote) {
+                    quote = 0;
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                selfClosing = _html[i - 1] == u'/';
+                break;
+            }
+        }
+        _pos = i < size ? i + 1 : size;
+
+        const std::string_view tagName = length <= maxTagNameLength ? std::string_view(name, size_t(length)) : std::string_view();
+        element(tagName, closing, selfClosing);
+        return true;
+    }
+
+    void element(std::string_view name, bool closing, bool selfClosing)
+    {
+        if (name == "br") {
+            if (_headDepth == 0) {
+                _writer.lineBreak();
+            }
+        } else if (name == "pre") {
+            _writer.blockBoundary();
+            if (closing) {
+                _writer.leavePre();
+            } else if (!selfClosing) {
+                _writer.enterPre();
+            }
+        } else if (name == "head") {
+            _headDepth = closing ? qMax(0, _headDepth - 1) : _headDepth + 1;
+        } else if (blockTags(name) != blockTags.notFound) {
+            _writer.blockBoundary();
+        } else if (!closing && !selfClosing && rawTextTags(name) != rawTextTags.notFound) {
+            skipRawText(name);
+        }
+    }
+
+    // Jump past the end tag of a raw text element, or to the end of input.
+    void skipRawText(std::string_view name)
+    {
+        const qsizetype size = _html.size();
+        for (qsizetype i = _html.indexOf(u"</", _pos); i >= 0; i = _html.indexOf(u"</", i + 2)) {
+            qsizetype j = i + 2;
+            size_t k = 0;
+            while (k < name.size() && j < size && toAsciiLower(_html[j].unicode()) == name[k]) {
+                ++j;
+                ++k;
+            }
+            if (k == name.size() && (j == size || !isAsciiAlnum(_html[j].unicode()))) {
+                const qsizetype end = _html.indexOf(u'>', j);
+                _pos = end < 0 ? size : end + 1;
+                return;
+            }
+        }
+        _pos = size;
+    }
+
+    // Decode the character reference at _pos; a bare '&' is kept as text.
+    void entity()
+    {
+        const qsizetype size = _html.size();
+        qsizetype i = _pos + 1;
+        std::optional<char32_t> code;
+        if (i < size && _html[i] == u'#') {
+            ++i;
+            const bool hex = i < size && (_html[i] == u'x' || _html[i] == u'X');
+            if (hex) {
+                ++i;
+            }
+            const qsizetype digitsStart = i;
+            quint32 value = 0;
+            for (; i < size; ++i) {
+                const char16_t c = _html[i].unicode();
+                int digit = -1;
+                if (c >= '0' && c <= '9') {
+                    digit = c - '0';
+                } else if (hex && c >= 'a' && c <= 'f') {
+                    digit = c - 'a' + 10;
+                } else if (hex && c >= 'A' && c <= 'F') {
+                    digit = c - 'A' + 10;
+                }
+                if (digit < 0) {
+                    break;
+                }
+                value = qMin<quint32>(value * (hex ? 16 : 10) + quint32(digit), 0x110000);
+            }
+            if (i > digitsStart) {
+                const bool valid = value > 0 && value < 0x110000 && (value < 0xD800 || value > 0xDFFF);
+                code = valid ? char32_t(value) : char32_t(QChar::ReplacementCharacter);
+            }
+        } else {
+            char name[maxEntityNameLength];
+            qsizetype length = 0;
+            for (; i < size && length < maxEntityNameLength && isAsciiAlnum(_html[i].unicode()); ++i, ++length) {
+                name[length] = char(_html[i].unicode());
+            }
+            code = lookupEntity(std::string_view(name, size_t(length)));
+        }
+
+        if (!code) {
+            put(u'&');
+            ++_pos;
+            return;
+        }
+        if (i < size && _html[i] == u';') {
+            ++i;
+        }
+        put(*code);
+        _pos = i;
+    }
+
+    QStringView _html;
+    qsizetype _pos = 0;
+    int _headDepth = 0;
+    PlainTextWriter _writer;
+};
+
+} // namespace
+
+QString htmlToPlainText(QStringView html)
+{
+    return HtmlTextConverter(html).run();
+}
+
+QStringList htmlToPlainTexts(const QStringList& htmls)
+{
+    QStringList texts(htmls.size());
+    std::atomic<qsizetype> next { 0 };
+    parallelFor(parallelTasks(htmls.size()), [&](int) {
+        for (qsizetype i = next++; i < htmls.size(); i = next++) {
+            texts[i] = htmlToPlainText(htmls[i]);
+        }
+    });
+    return texts;
+}
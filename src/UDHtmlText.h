@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+// Plain text of an HTML fragment, close to QTextDocument::setHtml() followed
+// by toPlainText(), but without building a document: one pass over the input
+// that decodes entities, collapses whitespace outside <pre>, puts block
+// elements on their own lines and drops <script>, <style>, <title> and
+// <head> contents. Reentrant, so it may run on any thread.
+QString htmlToPlainText(QStringView html);
+
+// htmlToPlainText() for each entry, spread across the global thread pool.
+QStringList htmlToPlainTexts(const QStringList& htmls);
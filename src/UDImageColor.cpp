@@ -0,0 +1,500 @@
+#include "UDImageColor.h"
+#include "UDParallel.h"
+#include "UDSimd.h"
+
+#include <QThreadPool>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Below this many sampled pixels the work is cheaper than waking threads.
+constexpr qint64 kParallelSampleThreshold = 1 << 18;
+constexpr int kMinRowsPerTask = 32;
+
+enum class ChannelOrder {
+    Argb, // 0xAARRGGBB words: Format_RGB32 / Format_ARGB32*
+    Rgba, // R, G, B, A bytes: Format_RGBX8888 / Format_RGBA8888*
+    Rgb, // R, G, B bytes, no padding: Format_RGB888
+};
+
+// Where and how the pixels of a direct 32- or 24-bit image are laid out.
+struct PixelLayout {
+    ChannelOrder order = ChannelOrder::Argb;
+    bool hasAlpha = false;
+    bool premultiplied = false;
+};
+
+// Return image itself when its pixels can be read directly, otherwise convert
+// it into converted once and return that.
+const QImage& directImage(const QImage& image, QImage& converted, PixelLayout& layout)
+{
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+        layout = { ChannelOrder::Argb, false, false };
+        return image;
+    case QImage::Format_ARGB32:
+        layout = { ChannelOrder::Argb, true, false };
+        return image;
+    case QImage::Format_ARGB32_Premultiplied:
+        layout = { ChannelOrder::Argb, true, true };
+        return image;
+    case QImage::Format_RGBX8888:
+        layout = { ChannelOrder::Rgba, false, false };
+        return image;
+    case QImage::Format_RGBA8888:
+        layout = { ChannelOrder::Rgba, true, false };
+        return image;
+    case QImage::Format_RGBA8888_Premultiplied:
+        layout = { ChannelOrder::Rgba, true, true };
+        return image;
+    case QImage::Format_RGB888:
+        layout = { ChannelOrder::Rgb, false, false };
+        return image;
+    default:
+        converted = image.convertToFormat(QImage::Format_ARGB32);
+        layout = { ChannelOrder::Argb, true, false };
+        return converted;
+    }
+}
+
+// A row kernel adds byte 0..3 of every step-th 32-bit pixel to lanes[0..3].
+using RowKernel = void (*)(const uchar* row, int width, int step, quint64* lanes);
+
+[[maybe_unused]] void sumRowScalar(const uchar* row, int width, int step, quint64* lanes)
+{
+    quint64 l0 = 0, l1 = 0, l2 = 0, l3 = 0;
+    for (int x = 0; x < width; x += step) {
+        const uchar* p = row + qsizetype(x) * 4;
+        l0 += p[0];
+        l1 += p[1];
+        l2 += p[2];
+        l3 += p[3];
+    }
+    lanes[0] += l0;
+    lanes[1] += l1;
+    lanes[2] += l2;
+    lanes[3] += l3;
+}
+
+// Same for 24-bit pixels; fills lanes 0..2 only.
+void sumRowRgb24(const uchar* row, int width, int step, quint64* lanes)
+{
+    quint64 l0 = 0, l1 = 0, l2 = 0;
+    const qsizetype stride = qsizetype(step) * 3;
+    const uchar* end = row + qsizetype(width) * 3;
+    for (const uchar* p = row; p < end; p += stride) {
+        l0 += p[0];
+        l1 += p[1];
+        l2 += p[2];
+    }
+    lanes[0] += l0;
+    lanes[1] += l1;
+    lanes[2] += l2;
+}
+
+#if defined(UD_HAVE_SSE2)
+// The SIMD kernels only fill lanes 0..2; x86 is little-endian, so those are
+// the B, G, R bytes of an ARGB32 word or the R, G, B bytes of RGBA8888.
+// Rows of a wrapped foreign buffer need not be 4-byte aligned.
+
+inline void sumTailLe(const quint32* px, int x, int width, int step, quint64* lanes)
+{
+    for (; x < width; x += step) {
+        const quint32 p = qFromUnaligned<quint32>(px + x);
+        lanes[0] += p & 0xff;
+        lanes[1] += (p >> 8) & 0xff;
+        lanes[2] += (p >> 16) & 0xff;
+    }
+}
+
+void sumRowSse2(const uchar* row, int width, int step, quint64* lanes)
+{
+    const quint32* px = reinterpret_cast<const quint32*>(row);
+    const __m128i mask = _mm_set1_epi32(0xff);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = zero, acc1 = zero, acc2 = zero;
+    int x = 0;
+    if (step == 1) {
+        for (; x + 4 <= width; x += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + x));
+            acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_and_si128(v, mask), zero));
+            acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(v, 8), mask), zero));
+            acc2 = _mm_add_epi64(acc2, _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(v, 16), mask), zero));
+        }
+    } else {
+        for (; x + 3 * step < width; x += 4 * step) {
+            const __m128i v = _mm_set_epi32(int(qFromUnaligned<quint32>(px + x + 3 * step)),
+                int(qFromUnaligned<quint32>(px + x + 2 * step)), int(qFromUnaligned<quint32>(px + x + step)),
+                int(qFromUnaligned<quint32>(px + x)));
+            acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_and_si128(v, mask), zero));
+            acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(v, 8), mask), zero));
+            acc2 = _mm_add_epi64(acc2, _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(v, 16), mask), zero));
+        }
+    }
+    alignas(16) quint64 out[6];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), acc0);
+    _mm_store_si128(reinterpret_cast<__m128i*>(out + 2), acc1);
+    _mm_store_si128(reinterpret_cast<__m128i*>(out + 4), acc2);
+    lanes[0] += out[0] + out[1];
+    lanes[1] += out[2] + out[3];
+    lanes[2] += out[4] + out[5];
+    sumTailLe(px, x, width, step, lanes);
+}
+
+UD_TARGET_AVX2 void sumRowAvx2(const uchar* row, int width, int step, quint64* lanes)
+{
+    const quint32* px = reinterpret_cast<const quint32*>(row);
+    const __m256i mask = _mm256_set1_epi32(0xff);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc0 = zero, acc1 = zero, acc2 = zero;
+    int x = 0;
+    if (step == 1) {
+        for (; x + 8 <= width; x += 8) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(px + x));
+            acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_and_si256(v, mask), zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(v, 8), mask), zero));
+            acc2 = _mm256_add_epi64(acc2, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(v, 16), mask), zero));
+        }
+    } else {
+        const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+            _mm256_set1_epi32(step));
+        for (; x + 7 * step < width; x += 8 * step) {
+            const __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(px + x), index, 4);
+            acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_and_si256(v, mask), zero));
+            acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(v, 8), mask), zero));
+            acc2 = _mm256_add_epi64(acc2, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(v, 16), mask), zero));
+        }
+    }
+    alignas(32) quint64 out[12];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(out), acc0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(out + 4), acc1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(out + 8), acc2);
+    lanes[0] += out[0] + out[1] + out[2] + out[3];
+    lanes[1] += out[4] + out[5] + out[6] + out[7];
+    lanes[2] += out[8] + out[9] + out[10] + out[11];
+    sumTailLe(px, x, width, step, lanes);
+}
+
+#endif
+
+RowKernel selectRowKernel()
+{
+#if defined(UD_HAVE_SSE2)
+    if (cpuHasAvx2())
+        return &sumRowAvx2;
+    return &sumRowSse2;
+#else
+    return &sumRowScalar;
+#endif
+}
+
+// Accumulate sampled rows [firstRow, lastRow), i.e. image rows firstRow * step ...
+void accumulateRows(const QImage& image, ChannelOrder order, int step, int firstRow, int lastRow,
+    ImageColorSums& sums)
+{
+    static const RowKernel wordKernel = selectRowKernel();
+    const RowKernel kernel = order == ChannelOrder::Rgb ? &sumRowRgb24 : wordKernel;
+
+    const int width = image.width();
+    quint64 lanes[4] = {};
+    for (int r = firstRow; r < lastRow; ++r) {
+        kernel(image.constScanLine(r * step), width, step, lanes);
+    }
+
+    if (order != ChannelOrder::Argb) {
+        sums.red = lanes[0];
+        sums.green = lanes[1];
+        sums.blue = lanes[2];
+    } else {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        sums.red = lanes[2];
+        sums.green = lanes[1];
+        sums.blue = lanes[0];
+#else
+        sums.red = lanes[1];
+        sums.green = lanes[2];
+        sums.blue = lanes[3];
+#endif
+    }
+    sums.count = quint64(lastRow - firstRow) * quint64((width + step - 1) / step);
+}
+
+// Palette extraction works on a 5-bit-per-channel histogram of at most
+// kPaletteSampleBudget pixels, so its cost does not grow with resolution.
+constexpr qint64 kPaletteSampleBudget = 1 << 16;
+constexpr int kHistBits = 5;
+constexpr int kHistSide = 1 << kHistBits;
+constexpr int kHistShift = 8 - kHistBits;
+
+using Histogram = std::vector<quint32>;
+
+inline int histIndex(int r, int g, int b)
+{
+    return (r << (2 * kHistBits)) | (g << kHistBits) | b;
+}
+
+// An axis-aligned box of histogram bins, inclusive on both ends.
+struct ColorBox {
+    int lo[3] = { 0, 0, 0 };
+    int hi[3] = { kHistSide - 1, kHistSide - 1, kHistSide - 1 };
+    quint64 population = 0;
+
+    qint64 volume() const
+    {
+        return qint64(hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1);
+    }
+
+    int longestAxis() const
+    {
+        int axis = 0;
+        for (int i = 1; i < 3; ++i) {
+            if (hi[i] - lo[i] > hi[axis] - lo[axis])
+                axis = i;
+        }
+        return axis;
+    }
+
+    bool splittable() const { return hi[longestAxis()] > lo[longestAxis()]; }
+};
+
+template <typename Fn>
+void forEachBin(const Histogram& hist, const ColorBox& box, Fn&& fn)
+{
+    for (int r = box.lo[0]; r <= box.hi[0]; ++r) {
+        for (int g = box.lo[1]; g <= box.hi[1]; ++g) {
+            for (int b = box.lo[2]; b <= box.hi[2]; ++b) {
+                if (const quint32 n = hist[histIndex(r, g, b)])
+                    fn(r, g, b, n);
+            }
+        }
+    }
+}
+
+// Shrink box to the bins that are actually populated and recount it.
+void fitBox(const Histogram& hist, ColorBox& box)
+{
+    int lo[3] = { kHistSide, kHistSide, kHistSide };
+    int hi[3] = { -1, -1, -1 };
+    quint64 population = 0;
+    forEachBin(hist, box, [&](int r, int g, int b, quint32 n) {
+        const int c[3] = { r, g, b };
+        for (int i = 0; i < 3; ++i) {
+            lo[i] = qMin(lo[i], c[i]);
+            hi[i] = qMax(hi[i], c[i]);
+        }
+        population += n;
+    });
+    box.population = population;
+    if (population) {
+        std::copy(lo, lo + 3, box.lo);
+        std::copy(hi, hi + 3, box.hi);
+    }
+}
+
+// Median cut along the longest axis; both halves keep at least one bin.
+void splitBox(const Histogram& hist, const ColorBox& box, ColorBox& first, ColorBox& second)
+{
+    const int axis = box.longestAxis();
+    quint64 slices[kHistSide] = {};
+    forEachBin(hist, box, [&](int r, int g, int b, quint32 n) {
+        const int c[3] = { r, g, b };
+        slices[c[axis]] += n;
+    });
+
+    int cut = box.lo[axis];
+    quint64 below = slices[cut];
+    while (cut < box.hi[axis] - 1 && below * 2 < box.population) {
+        below += slices[++cut];
+    }
+
+    first = box;
+    first.hi[axis] = cut;
+    second = box;
+    second.lo[axis] = cut + 1;
+    fitBox(hist, first);
+    fitBox(hist, second);
+}
+
+QColor boxColor(const Histogram& hist, const ColorBox& box)
+{
+    constexpr int half = 1 << (kHistShift - 1);
+    quint64 sum[3] = {};
+    forEachBin(hist, box, [&](int r, int g, int b, quint32 n) {
+        sum[0] += quint64(n) * ((r << kHistShift) + half);
+        sum[1] += quint64(n) * ((g << kHistShift) + half);
+        sum[2] += quint64(n) * ((b << kHistShift) + half);
+    });
+    return QColor(int(sum[0] / box.population), int(sum[1] / box.population),
+        int(sum[2] / box.population));
+}
+
+// Strided downsample of image into hist, skipping mostly transparent pixels.
+quint64 buildHistogram(const QImage& image, Histogram& hist)
+{
+    QImage converted;
+    PixelLayout layout;
+    const QImage& source = directImage(image, converted, layout);
+
+    const qint64 pixels = qint64(source.width()) * source.height();
+    const int step = qMax(1, int(std::ceil(std::sqrt(double(pixels) / kPaletteSampleBudget))));
+
+    quint64 total = 0;
+    for (int y = 0; y < source.height(); y += step) {
+        const uchar* row = source.constScanLine(y);
+        for (int x = 0; x < source.width(); x += step) {
+            int r, g, b, a;
+            if (layout.order == ChannelOrder::Rgb) {
+                const uchar* p = row + qsizetype(x) * 3;
+                r = p[0];
+                g = p[1];
+                b = p[2];
+                a = 255;
+            } else if (layout.order == ChannelOrder::Rgba) {
+                const uchar* p = row + qsizetype(x) * 4;
+                r = p[0];
+                g = p[1];
+                b = p[2];
+                a = p[3];
+            } else {
+                const QRgb p = reinterpret_cast<const QRgb*>(row)[x];
+                r = qRed(p);
+                g = qGreen(p);
+                b = qBlue(p);
+                a = qAlpha(p);
+            }
+            if (layout.hasAlpha) {
+                if (a < 128)
+                    continue;
+                if (layout.premultiplied && a < 255) {
+                    r = qMin(255, (r * 255 + a / 2) / a);
+                    g = qMin(255, (g * 255 + a / 2) / a);
+                    b = qMin(255, (b * 255 + a / 2) / a);
+                }
+            }
+            ++hist[histIndex(r >> kHistShift, g >> kHistShift, b >> kHistShift)];
+            ++total;
+        }
+    }
+    return total;
+}
+
+} // namespace
+
+ImageColorSums accumulateImageColor(const QImage& image, int step)
+{
+    ImageColorSums sums;
+    if (image.isNull() || step < 1) {
+        return sums;
+    }
+
+    QImage converted;
+    PixelLayout layout;
+    const QImage* source = &directImage(image, converted, layout);
+    const ChannelOrder order = layout.order;
+
+    const int sampledRows = (source->height() + step - 1) / step;
+    const qint64 samples = qint64(sampledRows) * ((source->width() + step - 1) / step);
+
+    int tasks = 1;
+    if (samples >= kParallelSampleThreshold) {
+        tasks = qBound(1, qMin(QThreadPool::globalInstance()->maxThreadCount(), sampledRows / kMinRowsPerTask), 64);
+    }
+
+    std::vector<ImageColorSums> partials(tasks);
+    parallelFor(tasks, [&](int t) {
+        const int first = int(qint64(sampledRows) * t / tasks);
+        const int last = int(qint64(sampledRows) * (t + 1) / tasks);
+        accumulateRows(*source, order, step, first, last, partials[t]);
+    });
+
+    for (const ImageColorSums& part : partials) {
+        sums.red += part.red;
+        sums.green += part.green;
+        sums.blue += part.blue;
+        sums.count += part.count;
+    }
+    return sums;
+}
+
+QColor averageColor(const ImageColorSums& sums, double bright)
+{
+    if (sums.count == 0) {
+        return {};
+    }
+    const double count = double(sums.count);
+    auto channel = [&](quint64 sum) {
+        return qBound(0, int(bright * double(sum) / count), 255);
+    };
+    return QColor(channel(sums.red), channel(sums.green), channel(sums.blue));
+}
+
+QColor averageImageColor(const QImage& image, int step, double bright)
+{
+    return averageColor(accumulateImageColor(image, step), bright);
+}
+
+QList<PaletteColor> extractPalette(const QImage& image, int count)
+{
+    QList<PaletteColor> palette;
+    if (image.isNull() || count < 1) {
+        return palette;
+    }
+
+    Histogram hist(size_t(1) << (3 * kHistBits), 0);
+    const quint64 total = buildHistogram(image, hist);
+    if (total == 0) {
+        return palette;
+    }
+
+    std::vector<ColorBox> boxes(1);
+    fitBox(hist, boxes.front());
+
+    // Split by population first, then by population * volume so the last
+    // colors come from distinct regions instead of shades of the dominant one.
+    const int populationSplits = qMax(1, count * 3 / 4);
+    while (int(boxes.size()) < count) {
+        const bool byVolume = int(boxes.size()) >= populationSplits;
+        int best = -1;
+        double bestScore = 0;
+        for (int i = 0; i < int(boxes.size()); ++i) {
+            if (!boxes[i].splittable())
+                continue;
+            double score = double(boxes[i].population);
+            if (byVolume)
+                score *= double(boxes[i].volume());
+            if (score > bestScore) {
+                best = i;
+                bestScore = score;
+            }
+        }
+        if (best < 0)
+            break;
+        ColorBox first, second;
+        splitBox(hist, boxes[best], first, second);
+        boxes[best] = first;
+        boxes.push_back(second);
+    }
+
+    std::sort(boxes.begin(), boxes.end(), [](const ColorBox& a, const ColorBox& b) {
+        return a.population > b.population;
+    });
+    palette.reserve(qsizetype(boxes.size()));
+    for (const ColorBox& box : boxes) {
+        palette.append({ boxColor(hist, box), double(box.population) / double(total) });
+    }
+    return palette;
+}
+
+QVariantList paletteToVariant(const QList<PaletteColor>& palette)
+{
+    QVariantList result;
+    result.reserve(palette.size());
+    for (const PaletteColor& entry : palette) {
+        result.append(QVariantMap { { "color", entry.color }, { "weight", entry.weight } });
+    }
+    return result;
+}
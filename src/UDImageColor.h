@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QList>
+#include <QVariant>
+
+// Sampling step used by LingmoTools::imageMainColor and everything that has to
+// reproduce its result.
+constexpr int mainColorStep = 20;
+
+/**
+ * @brief Channel sums of the pixels visited by accumulateImageColor().
+ */
+struct ImageColorSums {
+    quint64 red = 0;
+    quint64 green = 0;
+    quint64 blue = 0;
+    quint64 count = 0;
+};
+
+// Sum the RGB channels of every step-th pixel in both directions.
+// Rows are read through constScanLine(), with SSE2/AVX2 kernels where the
+// CPU supports them, and large images are split across the global thread pool.
+ImageColorSums accumulateImageColor(const QImage& image, int step = 1);
+
+// Average color described by sums, scaled by bright and clamped to 255.
+QColor averageColor(const ImageColorSums& sums, double bright = 1);
+
+// Average color of every step-th pixel, scaled by bright and clamped to 255.
+// Returns an invalid color for a null image.
+QColor averageImageColor(const QImage& image, int step = 1, double bright = 1);
+
+/**
+ * @brief One palette color and the share of sampled pixels it stands for.
+ */
+struct PaletteColor {
+    QColor color;
+    double weight = 0;
+};
+
+// Up to count dominant colors, most populous first. The image is sampled down
+// to about 64k pixels and clustered with median cut on a 5-bit histogram.
+QList<PaletteColor> extractPalette(const QImage& image, int count);
+
+// QML shape of a palette: a list of { color, weight } maps.
+QVariantList paletteToVariant(const QList<PaletteColor>& palette);
@@ -0,0 +1,43 @@
+#include "UDMappedFile.h"
+
+#include <limits>
+
+MappedFile::MappedFile(const QString& path)
+    : _file(path)
+{
+    if (!_file.open(QIODevice::ReadOnly) || _file.isSequential()) {
+        return;
+    }
+    const qint64 size = _file.size();
+    if (size > std::numeric_limits<qsizetype>::max()) {
+        return;
+    }
+    // Mapping zero bytes fails everywhere, and /proc and sysfs files report
+    // size 0 whatever they hold, so an empty view could be wrong: callers
+    // read such files instead.
+    if (size == 0) {
+        return;
+    }
+    _data = _file.map(0, size);
+    if (!_data) {
+        return;
+    }
+    _size = qsizetype(size);
+    _valid = true;
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data) {
+        _file.unmap(_data);
+    }
+}
+
+std::shared_ptr<const MappedFile> mapFile(const QString& path)
+{
+    auto mapped = std::make_shared<const MappedFile>(path);
+    if (!mapped->isValid()) {
+        return nullptr;
+    }
+    return mapped;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+
+/**
+ * @brief A whole file mapped read-only into memory. The mapping lives exactly
+ * as long as this object; views and bytes() handed out by it must not outlive
+ * it. Share it through the std::shared_ptr returned by mapFile() to tie the
+ * lifetime of a consumer to the mapping.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const QString& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isValid() const { return _valid; }
+
+    QString path() const { return _file.fileName(); }
+
+    qsizetype size() const { return _size; }
+
+    const char* data() const { return reinterpret_cast<const char*>(_data); }
+
+    QByteArrayView view() const { return QByteArrayView(data(), _size); }
+
+    // QByteArray::fromRawData over the mapping: no copy, read-only, and only
+    // valid while this MappedFile is alive. Detaching it (any write) copies.
+    QByteArray bytes() const { return QByteArray::fromRawData(data(), _size); }
+
+private:
+    QFile _file;
+    uchar* _data = nullptr;
+    qsizetype _size = 0;
+    bool _valid = false;
+};
+
+// Map path read-only. Returns nullptr if it cannot be opened or mapped, which
+// includes every file of size 0: /proc and sysfs files report that size with
+// content behind it, so read those the ordinary way instead.
+std::shared_ptr<const MappedFile> mapFile(const QString& path);
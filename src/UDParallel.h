@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThreadPool>
+
+// Run fn(0) ... fn(tasks - 1) on the global thread pool and wait for all of
+// them. The calling thread runs task 0 itself, plus any task the pool has no
+// idle thread for, so a saturated (or re-entrant) pool can never deadlock us.
+template <typename Fn>
+void parallelFor(int tasks, Fn&& fn)
+{
+    QSemaphore done;
+    for (int t = 1; t < tasks; ++t) {
+        auto job = [&fn, &done, t] {
+            fn(t);
+            done.release();
+        };
+        if (!QThreadPool::globalInstance()->tryStart(job)) {
+            job();
+        }
+    }
+    if (tasks > 0) {
+        fn(0);
+    }
+    done.acquire(qMax(0, tasks - 1));
+}
+
+// Number of tasks worth starting for items independent pieces of work.
+inline int parallelTasks(qsizetype items)
+{
+    return int(qBound(qsizetype(1), qsizetype(QThreadPool::globalInstance()->maxThreadCount()), qMax(qsizetype(1), items)));
+}
@@ -0,0 +1,147 @@
+#include "UDPlatform.h"
+
+#include <QGuiApplication>
+#include <QQuickWindow>
+#include <QSGRendererInterface>
+#include <QSettings>
+#include <QSysInfo>
+#include <QVersionNumber>
+
+#include <mutex>
+
+namespace {
+
+int readWindowsBuildNumber()
+{
+#if defined(Q_OS_WIN)
+    QSettings regKey {
+        QString::fromUtf8(
+            R"(HKEY_LOCAL_MACHINE\SOFTWARE\Microsoft\Windows NT\CurrentVersion)"),
+        QSettings::NativeFormat
+    };
+    if (regKey.contains(QString::fromUtf8("CurrentBuildNumber"))) {
+        return regKey.value(QString::fromUtf8("CurrentBuildNumber")).toInt();
+    }
+#endif
+    return -1;
+}
+
+QString graphicsApiName(QSGRendererInterface::GraphicsApi api)
+{
+    switch (api) {
+    case QSGRendererInterface::Software:
+        return "software";
+    case QSGRendererInterface::OpenVG:
+        return "openvg";
+    case QSGRendererInterface::OpenGL:
+        return "opengl";
+    case QSGRendererInterface::Direct3D11:
+        return "direct3d11";
+    case QSGRendererInterface::Vulkan:
+        return "vulkan";
+    case QSGRendererInterface::Metal:
+        return "metal";
+    case QSGRendererInterface::Null:
+        return "null";
+    default:
+        return "unknown";
+    }
+}
+
+// Everything that is known without a QGuiApplication.
+PlatformInfo captureSystemInfo()
+{
+    PlatformInfo info;
+    info.os = QSysInfo::productType();
+    info.osVersion = QSysInfo::productVersion();
+    info.kernelType = QSysInfo::kernelType();
+
+    info.qtVersion = QString::fromLatin1(qVersion());
+    const QVersionNumber qt = QVersionNumber::fromString(info.qtVersion);
+    info.qtMajor = qt.majorVersion();
+    info.qtMinor = qt.minorVersion();
+    info.qtPatch = qt.microVersion();
+
+#if defined(Q_OS_WIN)
+    info.compositor = "dwm";
+#elif defined(Q_OS_MACOS)
+    info.compositor = "quartz";
+#else
+    info.compositor = QString::fromLocal8Bit(qgetenv("XDG_CURRENT_DESKTOP"));
+#endif
+
+    info.windowsBuildNumber = readWindowsBuildNumber();
+    info.isWindows10OrGreater = info.windowsBuildNumber >= 10240;
+    info.isWindows11OrGreater = info.windowsBuildNumber >= 22000;
+    info.supportsAcrylic = info.windowsBuildNumber >= 17134;
+    info.supportsMica = info.isWindows11OrGreater;
+    return info;
+}
+
+// The system part plus what the QPA plugin and Qt Quick report; only
+// meaningful once a QGuiApplication exists.
+PlatformInfo captureGuiInfo(const PlatformInfo& system)
+{
+    PlatformInfo info = system;
+    info.hasGui = true;
+    info.platformName = QGuiApplication::platformName();
+    info.isX11 = info.platformName == "xcb";
+    info.isWayland = info.platformName.startsWith("wayland");
+
+    info.sceneGraphBackend = QQuickWindow::sceneGraphBackend();
+    const QSGRendererInterface::GraphicsApi api = QQuickWindow::graphicsApi();
+    info.graphicsApi = graphicsApiName(api);
+    info.isSoftware = info.sceneGraphBackend == "software" || api == QSGRendererInterface::Software;
+    info.supportsShaderEffects = !info.isSoftware && QSGRendererInterface::isApiRhiBased(api);
+    return info;
+}
+
+const PlatformInfo& systemInfo()
+{
+    static std::once_flag once;
+    static PlatformInfo info;
+    std::call_once(once, [] { info = captureSystemInfo(); });
+    return info;
+}
+
+} // namespace
+
+const PlatformInfo& platformInfo()
+{
+    // Without an application the GUI fields stay empty, and nothing is
+    // frozen: the first call made with one takes the full snapshot.
+    if (!qGuiApp) {
+        return systemInfo();
+    }
+    static std::once_flag once;
+    static PlatformInfo info;
+    std::call_once(once, [] { info = captureGuiInfo(systemInfo()); });
+    return info;
+}
+
+QVariantMap platformInfoToVariant(const PlatformInfo& info)
+{
+    return {
+        { "hasGui", info.hasGui },
+        { "os", info.os },
+        { "osVersion", info.osVersion },
+        { "kernelType", info.kernelType },
+        { "qtVersion", info.qtVersion },
+        { "qtMajor", info.qtMajor },
+        { "qtMinor", info.qtMinor },
+        { "qtPatch", info.qtPatch },
+        { "platformName", info.platformName },
+        { "isX11", info.isX11 },
+        { "isWayland", info.isWayland },
+        { "compositor", info.compositor },
+        { "sceneGraphBackend", info.sceneGraphBackend },
+        { "graphicsApi", info.graphicsApi },
+        { "isSoftware", info.isSoftware },
+        { "supportsShaderEffects", info.supportsShaderEffects },
+        { "windowsBuildNumber", info.windowsBuildNumber },
+        { "isWindows10OrGreater", info.isWindows10OrGreater },
+        { "isWindows11OrGreater", info.isWindows11OrGreater },
+        { "supportsAcrylic", info.supportsAcrylic },
+        { "supportsMica", info.supportsMica },
+    };
+}
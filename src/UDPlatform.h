@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @brief What the process runs on, captured once. Everything here is fixed
+ * for the lifetime of the process, so it is read without locking. The QPA
+ * and Qt Quick fields need a QGuiApplication and are empty without one.
+ */
+struct PlatformInfo {
+    bool hasGui = false; // captured with a QGuiApplication, all fields filled
+    QString os; // QSysInfo::productType(): "windows", "macos", "ubuntu", ...
+    QString osVersion;
+    QString kernelType;
+    QString qtVersion; // runtime qVersion(), not the headers
+    int qtMajor = 0;
+    int qtMinor = 0;
+    int qtPatch = 0;
+    QString platformName; // QPA plugin: "xcb", "wayland", "windows", "cocoa", ...
+    bool isX11 = false;
+    bool isWayland = false;
+    QString compositor; // XDG_CURRENT_DESKTOP on Linux, "dwm" / "quartz" elsewhere
+    QString sceneGraphBackend;
+    QString graphicsApi; // "opengl", "vulkan", "direct3d11", "metal", "software", ...
+    bool isSoftware = false;
+    bool supportsShaderEffects = false;
+    int windowsBuildNumber = -1;
+    bool isWindows10OrGreater = false;
+    bool isWindows11OrGreater = false;
+    bool supportsAcrylic = false; // DWM acrylic blur, Windows 10 1803+
+    bool supportsMica = false; // DWM system backdrop, Windows 11+
+};
+
+// The snapshot, taken by the first caller under std::call_once. Before a
+// QGuiApplication exists this is a system-only snapshot (hasGui false) and
+// the full one is taken by the first call made with an application. Take
+// that after any QQuickWindow::setSceneGraphBackend() or setGraphicsApi()
+// call, as both feed into it.
+const PlatformInfo& platformInfo();
+
+// platformInfo() as a map keyed by the member names, for QML and Python.
+QVariantMap platformInfoToVariant(const PlatformInfo& info);
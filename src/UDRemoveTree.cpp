@@ -0,0 +1,245 @@
+#include "UDRemoveTree.h"
+#include "UDParallel.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <deque>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(Q_OS_LINUX)
+
+// Not exported by glibc; this is the kernel's layout.
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+constexpr size_t direntBufferSize = 32 * 1024;
+
+/**
+ * @brief A directory that is removed once the entries in it are gone and all
+ * of its subdirectories have been removed (or given up on). It stays open
+ * until then, so its subdirectories are opened and removed relative to it and
+ * no path is ever resolved again from the root.
+ */
+struct DirNode {
+    // The root's absolute path, otherwise the name within parent.
+    QByteArray name;
+    DirNode* parent = nullptr;
+    int fd = -1;
+    // Subdirectories still pending, plus one for reading this directory.
+    std::atomic<int> pending { 1 };
+};
+
+class TreeRemover {
+public:
+    explicit TreeRemover(RemoveTreeState& state)
+        : _state(state)
+    {
+    }
+
+    void run(const QByteArray& root)
+    {
+        auto* node = new DirNode;
+        node->name = root;
+        _queue.push_back(node);
+        parallelFor(QThreadPool::globalInstance()->maxThreadCount(), [this](int) { work(); });
+    }
+
+private:
+    void work()
+    {
+        for (;;) {
+            DirNode* node = nullptr;
+            {
+                QMutexLocker locker(&_mutex);
+                while (_queue.empty() && _active > 0) {
+                    _changed.wait(&_mutex);
+                }
+                if (_queue.empty()) {
+                    _changed.wakeAll();
+                    return;
+                }
+                // Newest first: finishing subtrees before starting new ones
+                // keeps the number of open directories near the tree depth.
+                node = _queue.back();
+                _queue.pop_back();
+                ++_active;
+            }
+            process(node);
+            QMutexLocker locker(&_mutex);
+            --_active;
+            if (_queue.empty() && _active == 0) {
+                _changed.wakeAll();
+            }
+        }
+    }
+
+    void process(DirNode* node)
+    {
+        if (!_state.cancelled) {
+            constexpr int flags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+            node->fd = node->parent ? ::openat(node->parent->fd, node->name.constData(), flags)
+                                    : ::open(node->name.constData(), flags);
+            if (node->fd < 0) {
+                ++_state.failed;
+            } else {
+                readDirectory(node->fd, node);
+            }
+        }
+        complete(node);
+    }
+
+    // Unlink everything that is not a directory and queue the directories.
+    void readDirectory(int fd, DirNode* node)
+    {
+        std::vector<DirNode*> children;
+        alignas(LinuxDirent64) char buffer[direntBufferSize];
+        for (;;) {
+            const long read = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+            if (read <= 0) {
+                if (read < 0) {
+                    ++_state.failed;
+                }
+                break;
+            }
+            for (long offset = 0; offset < read;) {
+                const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+                offset += entry->d_reclen;
+                const char* name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                    continue;
+                }
+                bool isDir = entry->d_type == DT_DIR;
+                if (entry->d_type == DT_UNKNOWN) {
+                    struct stat st;
+                    isDir = ::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+                }
+                if (isDir) {
+                    auto* child = new DirNode;
+                    child->name = name;
+                    child->parent = node;
+                    children.push_back(child);
+                } else if (::unlinkat(fd, name, 0) == 0) {
+                    ++_state.removed;
+                } else {
+                    ++_state.failed;
+                }
+            }
+            if (_state.cancelled) {
+                break;
+            }
+        }
+
+        if (children.empty()) {
+            return;
+        }
+        node->pending += int(children.size());
+        QMutexLocker locker(&_mutex);
+        _queue.insert(_queue.end(), children.begin(), children.end());
+        _changed.wakeAll();
+    }
+
+    // Drop one pending reference; the last one closes and removes the
+    // directory and passes completion on to its parent.
+    void complete(DirNode* node)
+    {
+        while (node && --node->pending == 0) {
+            if (node->fd >= 0) {
+                ::close(node->fd);
+            }
+            if (!_state.cancelled) {
+                const int removed = node->parent ? ::unlinkat(node->parent->fd, node->name.constData(), AT_REMOVEDIR)
+                                                 : ::rmdir(node->name.constData());
+                if (removed == 0) {
+                    ++_state.removed;
+                } else {
+                    ++_state.failed;
+                }
+            }
+            DirNode* parent = node->parent;
+            delete node;
+            node = parent;
+        }
+    }
+
+    RemoveTreeState& _state;
+    QMutex _mutex;
+    QWaitCondition _changed;
+    std::deque<DirNode*> _queue;
+    int _active = 0;
+};
+
+#else
+
+// Portable fallback: serial, but still cancellable and counted.
+bool removeEntries(const QString& path, RemoveTreeState& state)
+{
+    QDir dir(path);
+    const QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    for (const QFileInfo& info : entries) {
+        if (state.cancelled) {
+            return false;
+        }
+        if (info.isDir() && !info.isSymLink()) {
+            if (!removeEntries(info.filePath(), state)) {
+                return false;
+            }
+            if (dir.rmdir(info.fileName())) {
+                ++state.removed;
+            } else {
+                ++state.failed;
+            }
+        } else if (QFile::remove(info.filePath())) {
+            ++state.removed;
+        } else {
+            ++state.failed;
+        }
+    }
+    return true;
+}
+
+#endif
+
+} // namespace
+
+bool removeTree(const QString& path, RemoveTreeState& state)
+{
+    // Like QDir::removeRecursively(), anything but a real directory is left
+    // alone; a symlink to one is not followed either.
+    const QFileInfo info(path);
+    if (!info.isDir() || info.isSymLink()) {
+        return true;
+    }
+
+#if defined(Q_OS_LINUX)
+    TreeRemover(state).run(QFile::encodeName(info.absoluteFilePath()));
+#else
+    if (removeEntries(path, state) && !state.cancelled) {
+        if (QDir().rmdir(path)) {
+            ++state.removed;
+        } else {
+            ++state.failed;
+        }
+    }
+#endif
+    return !state.cancelled && !QFileInfo::exists(path);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <atomic>
+
+#include <QString>
+
+/**
+ * @brief Shared state of one removeTree() run. Another thread may read the
+ * counters for progress and set cancelled at any time.
+ */
+struct RemoveTreeState {
+    std::atomic<bool> cancelled { false };
+    std::atomic<qint64> removed { 0 }; // files, links and directories deleted so far
+    std::atomic<qint64> failed { 0 };
+};
+
+// Delete the directory path and everything below it, like
+// QDir::removeRecursively(), but with subdirectories fanned out across the
+// global thread pool (the calling thread joins in). On Linux directories are
+// opened with openat and read with getdents64 relative to their parent's fd,
+// and entries removed with unlinkat; symlinks are removed, never followed.
+// Blocks until done or cancelled. Returns true if path no longer exists; a
+// path that is missing or not a directory (a file, a symlink) is left alone
+// and counts as success, as with removeRecursively().
+bool removeTree(const QString& path, RemoveTreeState& state);
@@ -0,0 +1,86 @@
+#include "UDScreenTopology.h"
+
+#include <algorithm>
+
+namespace {
+
+// Sorted, de-duplicated coordinates from the edges picked by edge().
+template <typename Edge>
+std::vector<int> sortedEdges(const QList<QRect>& rects, Edge edge)
+{
+    std::vector<int> edges;
+    edges.reserve(size_t(rects.size()) * 2);
+    for (const QRect& rect : rects) {
+        edge(rect, edges);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+} // namespace
+
+ScreenTopology::ScreenTopology(const QList<QRect>& geometries, const QList<QRect>& availableGeometries,
+    const QRect& virtualGeometry)
+    : _geometries(geometries)
+    , _availableGeometries(availableGeometries)
+    , _virtualGeometry(virtualGeometry)
+{
+    // Cut the plane at every screen edge; each resulting cell is wholly
+    // inside or outside each screen, so it has a single owner.
+    _slabEdges = sortedEdges(geometries, [](const QRect& rect, std::vector<int>& edges) {
+        if (!rect.isEmpty()) {
+            edges.push_back(rect.x());
+            edges.push_back(rect.x() + rect.width());
+        }
+    });
+    const std::vector<int> rows = sortedEdges(geometries, [](const QRect& rect, std::vector<int>& edges) {
+        if (!rect.isEmpty()) {
+            edges.push_back(rect.y());
+            edges.push_back(rect.y() + rect.height());
+        }
+    });
+
+    _slabCells.push_back(0);
+    for (size_t slab = 0; slab + 1 < _slabEdges.size(); ++slab) {
+        const int left = _slabEdges[slab];
+        for (size_t row = 0; row + 1 < rows.size(); ++row) {
+            const QPoint probe(left, rows[row]);
+            int owner = -1;
+            for (int i = 0; i < geometries.size(); ++i) {
+                if (geometries[i].contains(probe)) {
+                    owner = i;
+                    break;
+                }
+            }
+            if (owner < 0) {
+                continue;
+            }
+            // Merge with the cell above when the same screen continues.
+            if (_cells.size() > size_t(_slabCells.back()) && _cells.back().screen == owner
+                && _cells.back().bottom == rows[row]) {
+                _cells.back().bottom = rows[row + 1];
+            } else {
+                _cells.push_back({ rows[row], rows[row + 1], owner });
+            }
+        }
+        _slabCells.push_back(int(_cells.size()));
+    }
+}
+
+int ScreenTopology::indexAt(const QPoint& pos) const
+{
+    const auto edge = std::upper_bound(_slabEdges.begin(), _slabEdges.end(), pos.x());
+    if (edge == _slabEdges.begin() || edge == _slabEdges.end()) {
+        return -1;
+    }
+    const size_t slab = size_t(edge - _slabEdges.begin()) - 1;
+    const auto first = _cells.begin() + _slabCells[slab];
+    const auto last = _cells.begin() + _slabCells[slab + 1];
+    const auto cell = std::upper_bound(first, last, pos.y(), [](int y, const Cell& c) { return y < c.top; });
+    if (cell == first) {
+        return -1;
+    }
+    const Cell& hit = *(cell - 1);
+    return pos.y() < hit.bottom ? hit.screen : -1;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include <QList>
+#include <QPoint>
+#include <QRect>
+
+/**
+ * @brief Snapshot of the screen layout: geometries, available areas and a
+ * point-to-screen index. Plain data with no QScreen or QGuiApplication
+ * dependency, so it can be built from any list of rectangles.
+ */
+class ScreenTopology {
+public:
+    ScreenTopology() = default;
+
+    ScreenTopology(const QList<QRect>& geometries, const QList<QRect>& availableGeometries,
+        const QRect& virtualGeometry);
+
+    // Index of the screen containing pos, or -1. Where screens overlap (for
+    // example mirrored outputs) the lowest index wins, like a linear scan.
+    // O(log n) and allocation free.
+    int indexAt(const QPoint& pos) const;
+
+    int count() const { return int(_geometries.size()); }
+
+    const QList<QRect>& geometries() const { return _geometries; }
+
+    const QList<QRect>& availableGeometries() const { return _availableGeometries; }
+
+    QRect virtualGeometry() const { return _virtualGeometry; }
+
+    // Same screens; the lookup structure follows from them.
+    bool operator==(const ScreenTopology& other) const
+    {
+        return _geometries == other._geometries && _availableGeometries == other._availableGeometries
+            && _virtualGeometry == other._virtualGeometry;
+    }
+
+    bool operator!=(const ScreenTopology& other) const { return !(*this == other); }
+
+private:
+    // A y-range [top, bottom) of one vertical slab that belongs to a screen.
+    struct Cell {
+        int top;
+        int bottom;
+        int screen;
+    };
+
+    QList<QRect> _geometries;
+    QList<QRect> _availableGeometries;
+    QRect _virtualGeometry;
+    // Slab i spans x in [_slabEdges[i], _slabEdges[i + 1]) and owns
+    // _cells[_slabCells[i] .. _slabCells[i + 1]), sorted by top.
+    std::vector<int> _slabEdges;
+    std::vector<int> _slabCells;
+    std::vector<Cell> _cells;
+};
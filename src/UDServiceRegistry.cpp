@@ -0,0 +1,117 @@
+#include "UDServiceRegistry.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+
+namespace {
+
+bool logConstructions()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("UD_SERVICE_TIMINGS") != 0;
+    return enabled;
+}
+
+QString formatTiming(const ServiceRegistry::Timing& timing)
+{
+    return QStringLiteral("%1: %2 ms%3")
+        .arg(timing.name)
+        .arg(double(timing.nanoseconds) / 1e6, 0, 'f', 3)
+        .arg(timing.mainThread ? QString() : QStringLiteral(" (warm-up)"));
+}
+
+} // namespace
+
+ServiceRegistry& ServiceRegistry::instance()
+{
+    static ServiceRegistry registry;
+    return registry;
+}
+
+void ServiceRegistry::adopt(const QString& name, QObject* object, qint64 nanoseconds, void (*destroy)())
+{
+    QCoreApplication* app = QCoreApplication::instance();
+    Timing timing { name, nanoseconds, !app || QThread::currentThread() == app->thread() };
+    // Objects built by a warm-up belong to the application thread's event loop.
+    if (object && app && object->thread() != app->thread()) {
+        object->moveToThread(app->thread());
+    }
+    if (logConstructions()) {
+        qInfo().noquote() << "Service constructed" << formatTiming(timing);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.push_back({ std::move(timing), destroy });
+    if (app && !_postRoutineInstalled) {
+        _postRoutineInstalled = true;
+        qAddPostRoutine([] { ServiceRegistry::instance().shutdown(); });
+    }
+}
+
+void ServiceRegistry::startWarmUp()
+{
+    std::vector<std::function<void()>> warmUps;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        warmUps.swap(_warmUps);
+    }
+    if (warmUps.empty()) {
+        return;
+    }
+    QThreadPool::globalInstance()->start([warmUps = std::move(warmUps)] {
+        for (const auto& warmUp : warmUps) {
+            warmUp();
+        }
+    });
+}
+
+void ServiceRegistry::shutdown()
+{
+    // Destructors may touch other services, which may in turn be constructed
+    // again; keep going until nothing is left.
+    for (;;) {
+        std::vector<Entry> entries;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            entries.swap(_entries);
+        }
+        if (entries.empty()) {
+            return;
+        }
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            it->destroy();
+        }
+    }
+}
+
+QList<ServiceRegistry::Timing> ServiceRegistry::timings() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    QList<Timing> result;
+    result.reserve(qsizetype(_entries.size()));
+    for (const Entry& entry : _entries) {
+        result.append(entry.timing);
+    }
+    return result;
+}
+
+void ServiceRegistry::dumpTimings() const
+{
+    QList<Timing> all = timings();
+    std::stable_sort(all.begin(), all.end(), [](const Timing& a, const Timing& b) {
+        return a.nanoseconds > b.nanoseconds;
+    });
+    qint64 total = 0;
+    for (const Timing& timing : all) {
+        qInfo().noquote() << formatTiming(timing);
+        if (timing.mainThread) {
+            total += timing.nanoseconds;
+        }
+    }
+    qInfo().noquote() << QStringLiteral("%1 services, %2 ms on the main thread (nested constructions counted twice)")
+                             .arg(all.size())
+                             .arg(double(total) / 1e6, 0, 'f', 3);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QList>
+#include <QString>
+
+class QObject;
+
+template <typename T>
+class Singleton;
+
+/**
+ * @brief Owner of every Singleton<T> instance. Records how long each one took
+ * to construct and on which thread, destroys them in reverse construction
+ * order, and can construct chosen ones ahead of time on a worker thread.
+ *
+ * Nothing is warmed up unless the application asks for it, in main() once the
+ * QGuiApplication exists and before the QML engine loads:
+ *
+ *     ServiceRegistry::instance().warmUp<LingmoWallpaperCache>();
+ *     ServiceRegistry::instance().startWarmUp();
+ *
+ * The timings are readable from QML as LingmoTools.serviceTimings() and
+ * LingmoTools.dumpServiceTimings().
+ */
+class ServiceRegistry {
+public:
+    struct Timing {
+        QString name;
+        qint64 nanoseconds = 0; // includes services constructed from inside this one
+        bool mainThread = true;
+    };
+
+    static ServiceRegistry& instance();
+
+    // Queue Singleton<T> for startWarmUp().
+    template <typename T>
+    void warmUp()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _warmUps.push_back([] { Singleton<T>::getInstance(); });
+    }
+
+    // Construct every queued service, in queue order, on a background thread.
+    // QObject services are handed over to the application thread afterwards.
+    void startWarmUp();
+
+    // Destroy all services, newest first. Also runs as a QCoreApplication
+    // post routine. Services may be constructed again afterwards.
+    void shutdown();
+
+    QList<Timing> timings() const;
+
+    // Log timings() through qInfo(), slowest first. Set UD_SERVICE_TIMINGS=1
+    // to have each construction logged as it happens.
+    void dumpTimings() const;
+
+    // Called by Singleton<T> once an instance exists.
+    void adopt(const QString& name, QObject* object, qint64 nanoseconds, void (*destroy)());
+
+private:
+    ServiceRegistry() = default;
+
+    struct Entry {
+        Timing timing;
+        void (*destroy)() = nullptr;
+    };
+
+    mutable std::mutex _mutex;
+    std::vector<Entry> _entries;
+    std::vector<std::function<void()>> _warmUps;
+    bool _postRoutineInstalled = false;
+};
+
@@ -0,0 +1,56 @@
+#pragma once
+
+// Compile-time and run-time x86 SIMD detection shared by the vectorised
+// kernels. SSE2 is the compile-time baseline; anything newer is built with a
+// per-function target attribute and only called after the CPU check passes.
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define UD_X86 1
+#endif
+
+#if defined(UD_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define UD_HAVE_SSE2 1
+#include <immintrin.h>
+#endif
+
+#if defined(UD_HAVE_SSE2)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define UD_TARGET_SSSE3
+#define UD_TARGET_AVX2
+#else
+#define UD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define UD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+inline bool cpuHasSsse3()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+inline bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // OSXSAVE and AVX, then make sure the OS saves the YMM registers.
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return false;
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <QStringView>
+
+typedef std::uint64_t hash_t;
+
+constexpr hash_t prime = 0x100000001B3ull;
+constexpr hash_t basis = 0xCBF29CE484222325ull;
+
+// FNV-1a over the bytes of str.
+constexpr hash_t hash_(std::string_view str, hash_t last_value = basis)
+{
+    for (const char c : str) {
+        last_value = (last_value ^ static_cast<unsigned char>(c)) * prime;
+    }
+    return last_value;
+}
+
+// Feed the UTF-8 encoding of str to sink one byte at a time, without building
+// a QByteArray. Unpaired surrogates become U+FFFD, as in QString::toUtf8().
+template <typename Sink>
+void forEachUtf8Byte(QStringView str, Sink&& sink)
+{
+    const qsizetype size = str.size();
+    for (qsizetype i = 0; i < size; ++i) {
+        char32_t u = str[i].unicode();
+        if (u < 0x80) {
+            sink(static_cast<unsigned char>(u));
+            continue;
+        }
+        if (QChar::isHighSurrogate(u) && i + 1 < size && str[i + 1].isLowSurrogate()) {
+            u = QChar::surrogateToUcs4(char16_t(u), str[++i].unicode());
+        } else if (QChar::isSurrogate(u)) {
+            u = QChar::ReplacementCharacter;
+        }
+        if (u < 0x800) {
+            sink(static_cast<unsigned char>(0xC0 | (u >> 6)));
+        } else if (u < 0x10000) {
+            sink(static_cast<unsigned char>(0xE0 | (u >> 12)));
+            sink(static_cast<unsigned char>(0x80 | ((u >> 6) & 0x3F)));
+        } else {
+            sink(static_cast<unsigned char>(0xF0 | (u >> 18)));
+            sink(static_cast<unsigned char>(0x80 | ((u >> 12) & 0x3F)));
+            sink(static_cast<unsigned char>(0x80 | ((u >> 6) & 0x3F)));
+        }
+        sink(static_cast<unsigned char>(0x80 | (u & 0x3F)));
+    }
+}
+
+// hash_() of the UTF-8 encoding of str.
+inline hash_t hash_(QStringView str)
+{
+    hash_t value = basis;
+    forEachUtf8Byte(str, [&value](unsigned char byte) { value = (value ^ byte) * prime; });
+    return value;
+}
+
+// Compute the hash of a string.
+inline hash_t hash_(char const* str)
+{
+    return hash_(std::string_view(str));
+}
+
+constexpr hash_t hash_compile_time(char const* str, hash_t last_value = basis)
+{
+    return hash_(std::string_view(str), last_value);
+}
+
+/**
+ * @brief Compile-time string to index table for switch-based dispatch.
+ *
+ * The keys are laid out in a collision-free (perfect) hash table when the
+ * object is built, so declaring it constexpr rejects duplicate or hash-colliding
+ * keys at compile time. The layout is two-level (hash and displace): each key
+ * hashes to a small bucket, and every bucket stores the displacement that
+ * moves its keys to free slots of a table at most half full. That takes a few
+ * tries per bucket whatever the key count, where a single seed for the whole
+ * table stops being findable past a few dozen keys. A lookup is one hash, two
+ * loads and one compare against the stored key, so a string that merely shares
+ * a hash never matches.
+ *
+ *     static constexpr StringSwitch commands { { "open", "close" } };
+ *     switch (commands(name)) {
+ *     case commands.caseOf("open"): ...
+ *     case StringSwitch<2>::notFound: ...
+ *     }
+ */
+template <std::size_t N>
+class StringSwitch {
+    static_assert(N > 0, "StringSwitch needs at least one key");
+
+public:
+    static constexpr int notFound = -1;
+
+    constexpr StringSwitch(const char* const (&keys)[N])
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            _keys[i] = keys[i];
+            _hashes[i] = hash_(_keys[i]);
+        }
+        layout();
+    }
+
+    // Index of key, or notFound.
+    constexpr int operator()(std::string_view key) const
+    {
+        const int index = lookup(hash_(key));
+        return index >= 0 && _keys[index] == key ? index : notFound;
+    }
+
+    int operator()(QStringView key) const
+    {
+        const int index = lookup(hash_(key));
+        return index >= 0 && utf8Equal(key, _keys[index]) ? index : notFound;
+    }
+
+    // Index of a key that must be in the table; for case labels, where an
+    // unknown key is then a compile error.
+    constexpr int caseOf(std::string_view key) const
+    {
+        const int index = (*this)(key);
+        if (index == notFound) {
+            throw "StringSwitch has no such key";
+        }
+        return index;
+    }
+
+    constexpr std::string_view key(int index) const { return _keys[index]; }
+
+    static constexpr std::size_t size() { return N; }
+
+private:
+    // Smallest bits with 2^bits >= n.
+    static constexpr std::size_t bitsFor(std::size_t n)
+    {
+        std::size_t bits = 0;
+        while ((std::size_t(1) << bits) < n) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    // Four keys per bucket on average, in a table of at least twice N slots.
+    static constexpr std::size_t bucketBits = bitsFor((N + 3) / 4);
+    static constexpr std::size_t bucketCount = std::size_t(1) << bucketBits;
+    static constexpr std::size_t tableBits = bitsFor(2 * N);
+    static constexpr std::size_t tableSize = std::size_t(1) << tableBits;
+    static constexpr std::uint32_t maxDisplacement = 1 << 16;
+
+    static constexpr std::size_t bucket(hash_t hash)
+    {
+        return bucketBits == 0 ? 0 : std::size_t((hash * 0x9E3779B97F4A7C15ull) >> (64 - bucketBits));
+    }
+
+    // splitmix64's finalizer over the hash and the bucket's displacement.
+    static constexpr std::size_t slot(hash_t hash, std::uint32_t displacement)
+    {
+        hash_t x = hash + (hash_t(displacement) + 1) * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return std::size_t(x >> (64 - tableBits));
+    }
+
+    constexpr int lookup(hash_t hash) const
+    {
+        return _slots[slot(hash, _displacements[bucket(hash)])] - 1;
+    }
+
+    // Place the buckets largest first, each at the first displacement that
+    // puts all of its keys in free, distinct slots.
+    constexpr void layout()
+    {
+        std::array<std::size_t, bucketCount> counts {};
+        for (std::size_t i = 0; i < N; ++i) {
+            ++counts[bucket(_hashes[i])];
+        }
+        // Key indices grouped by bucket: bucket b holds order[starts[b]..starts[b] + counts[b]).
+        std::array<std::size_t, bucketCount> starts {};
+        std::size_t largest = 0;
+        for (std::size_t b = 1; b < bucketCount; ++b) {
+            starts[b] = starts[b - 1] + counts[b - 1];
+        }
+        std::array<std::size_t, N> order {};
+        std::array<std::size_t, bucketCount> filled {};
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t b = bucket(_hashes[i]);
+            order[starts[b] + filled[b]++] = i;
+            largest = counts[b] > largest ? counts[b] : largest;
+        }
+
+        for (std::size_t size = largest; size > 0; --size) {
+            for (std::size_t b = 0; b < bucketCount; ++b) {
+                if (counts[b] == size) {
+                    place(b, order.data() + starts[b], size);
+                }
+            }
+        }
+    }
+
+    constexpr void place(std::size_t b, const std::size_t* members, std::size_t count)
+    {
+        // Equal hashes share a bucket, and no displacement separates them.
+        for (std::size_t m = 0; m < count; ++m) {
+            for (std::size_t other = 0; other < m; ++other) {
+                if (_hashes[members[other]] == _hashes[members[m]]) {
+                    throw "StringSwitch keys must be unique and must not collide";
+                }
+            }
+        }
+        for (std::uint32_t displacement = 0; displacement < maxDisplacement; ++displacement) {
+            // Claim the slots one by one, and give them back on a clash.
+            std::size_t placed = 0;
+            while (placed < count) {
+                const std::size_t s = slot(_hashes[members[placed]], displacement);
+                if (_slots[s] != 0) {
+                    break;
+                }
+                _slots[s] = int(members[placed]) + 1;
+                ++placed;
+            }
+            if (placed == count) {
+                _displacements[b] = displacement;
+                return;
+            }
+            while (placed > 0) {
+                --placed;
+                _slots[slot(_hashes[members[placed]], displacement)] = 0;
+            }
+        }
+        throw "StringSwitch found no perfect hash for these keys";
+    }
+
+    static bool utf8Equal(QStringView str, std::string_view utf8)
+    {
+        std::size_t pos = 0;
+        bool equal = true;
+        forEachUtf8Byte(str, [&](unsigned char byte) {
+            equal = equal && pos < utf8.size() && static_cast<unsigned char>(utf8[pos]) == byte;
+            ++pos;
+        });
+        return equal && pos == utf8.size();
+    }
+
+    std::array<std::string_view, N> _keys {};
+    std::array<hash_t, N> _hashes {};
+    std::array<std::uint32_t, bucketCount> _displacements {};
+    std::array<int, tableSize> _slots {}; // key index + 1, 0 for an empty slot
+};
+
+template <std::size_t N>
+StringSwitch(const char* const (&)[N]) -> StringSwitch<N>;
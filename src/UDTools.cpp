@@ -1,22 +1,41 @@
 #include "UDTools.h"
+#include "UDBase64.h"
+#include "UDHash.h"
+#include "UDHtmlText.h"
+#include "UDImageColor.h"
+#include "UDMappedFile.h"
+#include "UDPlatform.h"
+#include "UDRemoveTree.h"
+#include "UDUuid.h"
 
 #include <QClipboard>
 #include <QColor>
 #include <QCryptographicHash>
 #include <QCursor>
-#include <QDBusInterface>
-#include <QDBusReply>
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusVariant>
 #include <QDateTime>
+#include <QDeadlineTimer>
 #include <QDir>
 #include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QGuiApplication>
+#include <QMetaMethod>
 #include <QOpenGLContext>
 #include <QProcess>
+#include <QPromise>
 #include <QQuickWindow>
 #include <QScreen>
-#include <QSettings>
-#include <QTextDocument>
-#include <QUuid>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <functional>
+#include <memory>
 
 #ifdef Q_OS_WIN
 #pragma comment(lib, "user32.lib")
@@ -26,22 +45,23 @@
 
 #endif
 
-hash_t hash_(char const* str)
+LingmoTools::LingmoTools(QObject* parent)
+    : QObject { parent }
 {
-    hash_t ret { basis };
-
-    while (*str) {
-        ret ^= *str;
-        ret *= prime;
-        str++;
+    // Screens belong to the GUI thread; a singleton warmed up elsewhere starts
+    // watching on its first read instead.
+    if (qGuiApp && QThread::currentThread() == qGuiApp->thread()) {
+        watchScreens();
     }
-
-    return ret;
 }
 
-LingmoTools::LingmoTools(QObject* parent)
-    : QObject { parent }
+LingmoTools::~LingmoTools()
 {
+    // removeDirAsync() workers post back to this object when they finish.
+    for (const auto& state : std::as_const(_removals)) {
+        state->cancelled = true;
+    }
+    _removalPool.waitForDone();
 }
 
 void LingmoTools::clipText(const QString& text)
@@ -51,7 +71,12 @@ void LingmoTools::clipText(const QString& text)
 
 QString LingmoTools::uuid()
 {
-    return QUuid::createUuid().toString().remove('-').remove('{').remove('}');
+    return uuidHex();
+}
+
+QStringList LingmoTools::uuids(int count)
+{
+    return uuidHexes(count);
 }
 
 QString LingmoTools::readFile(const QString& fileName)
@@ -65,6 +90,20 @@ QString LingmoTools::readFile(const QString& fileName)
     return content;
 }
 
+QByteArray LingmoTools::readFileBytes(const QString& fileName)
+{
+    const std::shared_ptr<const MappedFile> mapped = mapFile(fileName);
+    if (mapped) {
+        return mapped->view().toByteArray();
+    }
+    // /proc, sysfs, FIFOs and the like cannot be mapped but can be read.
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return file.readAll();
+}
+
 bool LingmoTools::isMacos()
 {
 #if defined(Q_OS_MACOS)
@@ -94,16 +133,22 @@ bool LingmoTools::isWin()
 
 int LingmoTools::qtMajor()
 {
-    const QString qtVersion = QString::fromLatin1(qVersion());
-    const QStringList versionParts = qtVersion.split('.');
-    return versionParts[0].toInt();
+    return platformInfo().qtMajor;
 }
 
 int LingmoTools::qtMinor()
 {
-    const QString qtVersion = QString::fromLatin1(qVersion());
-    const QStringList versionParts = qtVersion.split('.');
-    return versionParts[1].toInt();
+    return platformInfo().qtMinor;
+}
+
+QVariantMap LingmoTools::platform()
+{
+    // Only the snapshot taken with an application is final.
+    if (!qGuiApp) {
+        return platformInfoToVariant(platformInfo());
+    }
+    static const QVariantMap map = platformInfoToVariant(platformInfo());
+    return map;
 }
 
 void LingmoTools::setQuitOnLastWindowClosed(bool val)
@@ -137,14 +182,91 @@ QString LingmoTools::getFileNameByUrl(const QUrl& url)
 
 QString LingmoTools::html2PlantText(const QString& html)
 {
-    QTextDocument textDocument;
-    textDocument.setHtml(html);
-    return textDocument.toPlainText();
+    return htmlToPlainText(html);
 }
 
 QRect LingmoTools::getVirtualGeometry()
 {
-    return QGuiApplication::primaryScreen()->virtualGeometry();
+    return screenTopology().virtualGeometry();
+}
+
+int LingmoTools::screenCount()
+{
+    return screenTopology().count();
+}
+
+QVariantList LingmoTools::screenGeometries()
+{
+    QVariantList list;
+    for (const QRect& rect : screenTopology().geometries()) {
+        list.append(rect);
+    }
+    return list;
+}
+
+QVariantList LingmoTools::availableGeometries()
+{
+    QVariantList list;
+    for (const QRect& rect : screenTopology().availableGeometries()) {
+        list.append(rect);
+    }
+    return list;
+}
+
+const ScreenTopology& LingmoTools::screenTopology()
+{
+    // Created before the QGuiApplication: start watching on the first read.
+    if (!_screensWatched && qGuiApp) {
+        watchScreens();
+    }
+    return _screenTopology;
+}
+
+// Builds the first layout without screensChanged(): this runs from the
+// constructor or from inside a property READ, where a NOTIFY would make QML
+// re-evaluate the binding it is still evaluating.
+void LingmoTools::watchScreens()
+{
+    _screensWatched = true;
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, [this] { rebuildScreenTopology(); });
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [this](QScreen* screen) {
+        rebuildScreenTopology(screen);
+    });
+    connect(qGuiApp, &QGuiApplication::primaryScreenChanged, this, [this] { rebuildScreenTopology(); });
+    readScreens();
+}
+
+void LingmoTools::rebuildScreenTopology(QScreen* removed)
+{
+    if (readScreens(removed)) {
+        Q_EMIT screensChanged();
+    }
+}
+
+bool LingmoTools::readScreens(QScreen* removed)
+{
+    for (QScreen* screen : std::as_const(_screens)) {
+        disconnect(screen, nullptr, this, nullptr);
+    }
+    // A screen that is going away may still be listed while screenRemoved() is emitted.
+    _screens = QGuiApplication::screens();
+    _screens.removeAll(removed);
+
+    QList<QRect> geometries;
+    QList<QRect> available;
+    for (QScreen* screen : std::as_const(_screens)) {
+        connect(screen, &QScreen::geometryChanged, this, [this] { rebuildScreenTopology(); });
+        connect(screen, &QScreen::availableGeometryChanged, this, [this] { rebuildScreenTopology(); });
+        geometries.append(screen->geometry());
+        available.append(screen->availableGeometry());
+    }
+    QScreen* primary = QGuiApplication::primaryScreen();
+    ScreenTopology topology(geometries, available, primary ? primary->virtualGeometry() : QRect());
+    if (topology == _screenTopology) {
+        return false;
+    }
+    _screenTopology = std::move(topology);
+    return true;
 }
 
 QString LingmoTools::getApplicationDirPath()
@@ -179,10 +301,54 @@ QString LingmoTools::fromBase64(const QString& text)
     return QByteArray::fromBase64(text.toUtf8());
 }
 
+QByteArray LingmoTools::toBase64Bytes(const QByteArray& data)
+{
+    return base64Encode(data);
+}
+
+QByteArray LingmoTools::fromBase64Bytes(const QByteArray& text)
+{
+    return base64Decode(text).value_or(QByteArray());
+}
+
 bool LingmoTools::removeDir(const QString& dirPath)
 {
-    QDir qDir(dirPath);
-    return qDir.removeRecursively();
+    RemoveTreeState state;
+    return removeTree(dirPath, state);
+}
+
+int LingmoTools::removeDirAsync(const QString& dirPath)
+{
+    const int id = ++_nextRemovalId;
+    auto state = std::make_shared<RemoveTreeState>();
+    _removals.insert(id, state);
+
+    // Poll the counters instead of signalling per entry from the workers.
+    auto* progress = new QTimer(this);
+    progress->setInterval(100);
+    connect(progress, &QTimer::timeout, this, [this, id, state] {
+        Q_EMIT removeDirProgress(id, state->removed);
+    });
+    progress->start();
+
+    _removalPool.start([this, id, state, dirPath, progress] {
+        const bool ok = removeTree(dirPath, *state);
+        QMetaObject::invokeMethod(this, [this, id, state, ok, progress] {
+            progress->deleteLater();
+            _removals.remove(id);
+            Q_EMIT removeDirProgress(id, state->removed);
+            Q_EMIT removeDirFinished(id, ok);
+        }, Qt::QueuedConnection);
+    });
+    return id;
+}
+
+void LingmoTools::cancelRemoveDir(int id)
+{
+    const std::shared_ptr<RemoveTreeState> state = _removals.value(id);
+    if (state) {
+        state->cancelled = true;
+    }
 }
 
 bool LingmoTools::removeFile(const QString& filePath)
@@ -197,6 +363,37 @@ QString LingmoTools::sha256(const QString& text)
         .toHex();
 }
 
+QString LingmoTools::fileHash(const QString& path, const QString& algorithm)
+{
+    const std::optional<HashAlgorithm> algo = hashAlgorithmFromName(algorithm);
+    if (!algo) {
+        return {};
+    }
+    return hashFile(path, *algo).toHex();
+}
+
+QStringList LingmoTools::fileHashes(const QStringList& paths, const QString& algorithm)
+{
+    const std::optional<HashAlgorithm> algo = hashAlgorithmFromName(algorithm);
+    QStringList hexes;
+    if (!algo) {
+        return hexes;
+    }
+    for (const QByteArray& digest : hashFiles(paths, *algo)) {
+        hexes.append(digest.toHex());
+    }
+    return hexes;
+}
+
+QString LingmoTools::bytesHash(const QByteArray& data, const QString& algorithm)
+{
+    const std::optional<HashAlgorithm> algo = hashAlgorithmFromName(algorithm);
+    if (!algo) {
+        return {};
+    }
+    return hashBytes(data, *algo).toHex();
+}
+
 void LingmoTools::showFileInFolder(const QString& path)
 {
 #if defined(Q_OS_WIN)
@@ -221,7 +418,25 @@ void LingmoTools::showFileInFolder(const QString& path)
 
 bool LingmoTools::isSoftware()
 {
-    return QQuickWindow::sceneGraphBackend() == "software";
+    return platformInfo().isSoftware;
+}
+
+QVariantList LingmoTools::serviceTimings()
+{
+    QVariantList result;
+    for (const ServiceRegistry::Timing& timing : ServiceRegistry::instance().timings()) {
+        result.append(QVariantMap {
+            { "name", timing.name },
+            { "ms", double(timing.nanoseconds) / 1e6 },
+            { "mainThread", timing.mainThread },
+        });
+    }
+    return result;
+}
+
+void LingmoTools::dumpServiceTimings()
+{
+    ServiceRegistry::instance().dumpTimings();
 }
 
 QPoint LingmoTools::cursorPos() { return QCursor::pos(); }
@@ -235,171 +450,186 @@ QIcon LingmoTools::windowIcon() { return QGuiApplication::windowIcon(); }
 
 int LingmoTools::cursorScreenIndex()
 {
-    int screenIndex = 0;
-    int screenCount = QGuiApplication::screens().count();
-    if (screenCount > 1) {
-        QPoint pos = QCursor::pos();
-        for (int i = 0; i <= screenCount - 1; ++i) {
-            if (QGuiApplication::screens().at(i)->geometry().contains(pos)) {
-                screenIndex = i;
-                break;
-            }
-        }
+    const ScreenTopology& topology = screenTopology();
+    if (topology.count() <= 1) {
+        return 0;
     }
-    return screenIndex;
+    return qMax(0, topology.indexAt(QCursor::pos()));
 }
 
 int LingmoTools::windowBuildNumber()
 {
-#if defined(Q_OS_WIN)
-    QSettings regKey {
-        QString::fromUtf8(
-            R"(HKEY_LOCAL_MACHINE\SOFTWARE\Microsoft\Windows NT\CurrentVersion)"),
-        QSettings::NativeFormat
-    };
-    if (regKey.contains(QString::fromUtf8("CurrentBuildNumber"))) {
-        auto buildNumber = regKey.value(QString::fromUtf8("CurrentBuildNumber")).toInt();
-        return buildNumber;
-    }
-#endif
-    return -1;
+    return platformInfo().windowsBuildNumber;
 }
 
 bool LingmoTools::isWindows11OrGreater()
 {
-    static QVariant var;
-    if (var.isNull()) {
-#if defined(Q_OS_WIN)
-        auto buildNumber = windowBuildNumber();
-        if (buildNumber >= 22000) {
-            var = QVariant::fromValue(true);
-            return true;
-        }
-#endif
-        var = QVariant::fromValue(false);
-        return false;
-    } else {
-        return var.toBool();
-    }
+    return platformInfo().isWindows11OrGreater;
 }
 
 bool LingmoTools::isWindows10OrGreater()
 {
-    static QVariant var;
-    if (var.isNull()) {
-#if defined(Q_OS_WIN)
-        auto buildNumber = windowBuildNumber();
-        if (buildNumber >= 10240) {
-            var = QVariant::fromValue(true);
-            return true;
-        }
-#endif
-        var = QVariant::fromValue(false);
-        return false;
-    } else {
-        return var.toBool();
-    }
+    return platformInfo().isWindows10OrGreater;
 }
 
 QRect LingmoTools::desktopAvailableGeometry(QQuickWindow* window)
 {
-    return window->screen()->availableGeometry();
+    const ScreenTopology& topology = screenTopology();
+    const qsizetype index = _screens.indexOf(window->screen());
+    if (index < 0 || index >= topology.count()) {
+        return window->screen()->availableGeometry();
+    }
+    return topology.availableGeometries().at(index);
 }
 
-QString LingmoTools::getWallpaperFilePath()
+#if defined(Q_OS_LINUX)
+// Desktop service that knows the current wallpaper.
+enum class WallpaperBackend {
+    None,
+    Deepin,
+    Lingmo,
+    Plasma,
+};
+
+// The service of the desktop the session runs, going by XDG_CURRENT_DESKTOP.
+static WallpaperBackend desktopBackend()
+{
+    static constexpr StringSwitch desktops { { "KDE" } };
+
+    const QByteArray desktop = qgetenv("XDG_CURRENT_DESKTOP");
+    switch (desktops(std::string_view(desktop.constData(), size_t(desktop.size())))) {
+    case desktops.caseOf("KDE"):
+        return WallpaperBackend::Plasma;
+    }
+    return WallpaperBackend::None;
+}
+
+static WallpaperBackend wallpaperBackend()
 {
-#if defined(Q_OS_WIN)
-    wchar_t path[MAX_PATH] = {};
-    if (::SystemParametersInfoW(SPI_GETDESKWALLPAPER, MAX_PATH, path, FALSE) == FALSE) {
-        return {};
+    static constexpr StringSwitch productTypes { { "uos", "lingmo" } };
+
+    switch (productTypes(QSysInfo::productType())) {
+    case productTypes.caseOf("uos"):
+        return WallpaperBackend::Deepin;
+    case productTypes.caseOf("lingmo"):
+        return WallpaperBackend::Lingmo;
     }
-    return QString::fromWCharArray(path);
-#elif defined(Q_OS_LINUX)
-    auto type = QSysInfo::productType();
+    return desktopBackend();
+}
 
-    switch (hash_(type.toStdString().c_str())) {
-    case hash_compile_time("uos"): {
-        QDBusInterface interface("com.deepin.wm",
+static QDBusMessage wallpaperRequest(WallpaperBackend backend)
+{
+    switch (backend) {
+    case WallpaperBackend::Deepin: {
+        auto message = QDBusMessage::createMethodCall("com.deepin.wm",
             "/com/deepin/wm",
             "com.deepin.wm",
-            QDBusConnection::sessionBus());
-
-        if (!interface.isValid()) {
-            qWarning() << QDBusConnection::sessionBus().lastError().message();
-            return QString();
-        }
-
-        // Call the method and get the reply
-        QDBusReply<QString> reply = interface.call("GetCurrentWorkspaceBackgroundForMonitor",
-            QString("string:'%1'").arg(currentTimestamp()));
-
-        if (!reply.isValid()) {
-            // Handle the error
-            qWarning() << reply.error().message();
-            return QString();
-        }
-
-        QString result = reply.value().trimmed();
-
-        int startIndex = result.indexOf("file:///");
-        if (startIndex != -1) {
-            auto path = result.mid(startIndex + 7, result.length() - startIndex - 8);
-            return path;
-        }
-        break;
+            "GetCurrentWorkspaceBackgroundForMonitor");
+        message << QString("string:'%1'").arg(QDateTime::currentMSecsSinceEpoch());
+        return message;
     }
-    case hash_compile_time("lingmo"): {
-        QDBusInterface interface("com.lingmo.Settings",
+    case WallpaperBackend::Lingmo: {
+        // 使用 org.freedesktop.DBus.Properties.Get 方法来获取属性
+        auto message = QDBusMessage::createMethodCall("com.lingmo.Settings",
             "/Theme",
             "org.freedesktop.DBus.Properties",
-            QDBusConnection::sessionBus());
-
-        if (!interface.isValid()) {
-            qWarning() << QDBusConnection::sessionBus().lastError().message();
-            return QString();
-        }
-
-        // 使用 org.freedesktop.DBus.Properties.Get 方法来获取属性
-        QDBusReply<QVariant> reply = interface.call("Get",
-            "com.lingmo.Theme", // 接口名
+            "Get");
+        message << QStringLiteral("com.lingmo.Theme") // 接口名
+                << QStringLiteral("wallpaper");
+        return message;
+    }
+    case WallpaperBackend::Plasma: {
+        auto message = QDBusMessage::createMethodCall("org.kde.plasmashell",
+            "/PlasmaShell",
+            "org.kde.PlasmaShell",
             "wallpaper");
-
-        if (!reply.isValid()) {
-            qWarning() << "Error getting property:" << reply.error().message();
-            return QString();
-        }
-
-        QString result = reply.value().toString();
-
-        return result;
+        message << static_cast<uint32_t>(0);
+        return message;
+    }
+    case WallpaperBackend::None:
         break;
     }
+    return {};
+}
+
+// useDesktop is set when a Deepin reply holds no file:/// URL; the wallpaper
+// is then looked up as on any other distribution, by XDG_CURRENT_DESKTOP.
+static QString parseWallpaperReply(WallpaperBackend backend, const QDBusMessage& reply, bool* useDesktop = nullptr)
+{
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        qWarning() << "Failed to query wallpaper:" << reply.errorMessage();
+        return {};
     }
+    const QVariant value = reply.arguments().value(0);
 
-    QString desktop_name = qgetenv("XDG_CURRENT_DESKTOP");
+    switch (backend) {
+    case WallpaperBackend::Deepin: {
+        QString result = value.toString().trimmed();
 
-    switch (hash_(desktop_name.toStdString().c_str())) {
-    case hash_compile_time("KDE"): {
-        QDBusInterface plasmaShellInterface("org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell");
-        // 检查接口是否有效
-        if (!plasmaShellInterface.isValid()) {
-            qDebug() << "Failed to create D-Bus interface.";
-            return {};
+        int startIndex = result.indexOf("file:///");
+        if (startIndex != -1) {
+            return result.mid(startIndex + 7, result.length() - startIndex - 8);
         }
-        // 调用D-Bus方法获取属性
-        QDBusReply<QVariantMap> reply = plasmaShellInterface.call("wallpaper", static_cast<uint32_t>(0));
-        // 检查调用是否成功
-        if (!reply.isValid()) {
-            qDebug() << "Failed to call D-Bus method:" << reply.error().message();
-            return {};
+        if (useDesktop) {
+            *useDesktop = true;
         }
-        // 获取属性值
-        QVariantMap properties = reply.value();
-        QString imagePath = properties["Image"].toString();
-        return imagePath;
+        return {};
     }
+    case WallpaperBackend::Lingmo:
+        return value.value<QDBusVariant>().variant().toString();
+    case WallpaperBackend::Plasma:
+        // 获取属性值
+        return qdbus_cast<QVariantMap>(value)["Image"].toString();
+    case WallpaperBackend::None:
+        break;
     }
+    return {};
+}
 
+// The pending call fails with NoReply once the deadline passes, so a hung
+// service can no longer hold us for the 25 s D-Bus default. A Deepin reply
+// without a file is followed up with the desktop's service, within the same
+// deadline.
+static void queryWallpaper(QObject* context, WallpaperBackend backend, QDeadlineTimer deadline,
+    const std::function<void(const QString&)>& resolve)
+{
+    const int timeoutMs = deadline.isForever() ? -1 : int(qMax<qint64>(deadline.remainingTime(), 1));
+    auto* watcher = new QDBusPendingCallWatcher(
+        QDBusConnection::sessionBus().asyncCall(wallpaperRequest(backend), timeoutMs), context);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, context,
+        [context, backend, deadline, resolve](QDBusPendingCallWatcher* call) {
+            call->deleteLater();
+            bool useDesktop = false;
+            const QString path = parseWallpaperReply(backend, call->reply(), &useDesktop);
+            const WallpaperBackend desktop = useDesktop ? desktopBackend() : WallpaperBackend::None;
+            if (desktop != WallpaperBackend::None && !deadline.hasExpired()) {
+                queryWallpaper(context, desktop, deadline, resolve);
+                return;
+            }
+            resolve(path);
+        });
+}
+#endif
+
+QString LingmoTools::getWallpaperFilePath()
+{
+#if defined(Q_OS_WIN)
+    wchar_t path[MAX_PATH] = {};
+    if (::SystemParametersInfoW(SPI_GETDESKWALLPAPER, MAX_PATH, path, FALSE) == FALSE) {
+        return {};
+    }
+    return QString::fromWCharArray(path);
+#elif defined(Q_OS_LINUX)
+    WallpaperBackend backend = wallpaperBackend();
+    if (backend == WallpaperBackend::None) {
+        return {};
+    }
+    bool useDesktop = false;
+    QString path = parseWallpaperReply(backend, QDBusConnection::sessionBus().call(wallpaperRequest(backend)), &useDesktop);
+    if (useDesktop && (backend = desktopBackend()) != WallpaperBackend::None) {
+        path = parseWallpaperReply(backend, QDBusConnection::sessionBus().call(wallpaperRequest(backend)));
+    }
+    return path;
 #elif defined(Q_OS_MACOS)
     QProcess process;
     QStringList args;
@@ -416,26 +646,189 @@ QString LingmoTools::getWallpaperFilePath()
 #else
     return {};
 #endif
-    return {};
 }
 
-QColor LingmoTools::imageMainColor(const QImage& image, double bright)
+QFuture<QString> LingmoTools::wallpaperFilePathAsync(int timeoutMs)
 {
-    int step = 20;
-    int t = 0;
-    int r = 0, g = 0, b = 0;
-    for (int i = 0; i < image.width(); i += step) {
-        for (int j = 0; j < image.height(); j += step) {
-            if (image.valid(i, j)) {
-                t++;
-                QColor c = image.pixel(i, j);
-                r += c.red();
-                b += c.blue();
-                g += c.green();
-            }
+    auto promise = std::make_shared<QPromise<QString>>();
+    QFuture<QString> future = promise->future();
+    promise->start();
+    auto resolve = [this, promise](const QString& path) {
+        promise->addResult(path);
+        promise->finish();
+        Q_EMIT wallpaperPathResolved(path);
+    };
+
+#if defined(Q_OS_LINUX)
+    const WallpaperBackend backend = wallpaperBackend();
+    if (backend == WallpaperBackend::None) {
+        QTimer::singleShot(0, this, [resolve] { resolve({}); });
+        return future;
+    }
+    queryWallpaper(this, backend, QDeadlineTimer(timeoutMs), resolve);
+#elif defined(Q_OS_MACOS)
+    auto* process = new QProcess(this);
+    auto* timer = new QTimer(process);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, process, [process] { process->kill(); });
+    connect(process, &QProcess::finished, this, [process, timer, resolve](int, QProcess::ExitStatus) {
+        process->deleteLater();
+        // Killed by the timer: Finder did not answer, which says nothing
+        // about the wallpaper.
+        if (!timer->isActive()) {
+            resolve({});
+            return;
+        }
+        QByteArray result = process->readAllStandardOutput().trimmed();
+        if (result.isEmpty()) {
+            resolve("/System/Library/CoreServices/DefaultDesktop.heic");
+            return;
+        }
+        resolve(QString::fromUtf8(result));
+    });
+    connect(process, &QProcess::errorOccurred, this, [process, resolve](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            process->deleteLater();
+            resolve({});
+        }
+    });
+    process->start("osascript",
+        { "-e", R"(tell application "Finder" to get POSIX path of (desktop picture as alias))" });
+    timer->start(timeoutMs);
+#else
+    // Cheap and local on Windows; still delivered asynchronously so callers
+    // see the same ordering on every platform.
+    QTimer::singleShot(0, this, [this, resolve] { resolve(getWallpaperFilePath()); });
+#endif
+    return future;
+}
+
+void LingmoTools::requestWallpaperFilePath(int timeoutMs)
+{
+    wallpaperFilePathAsync(timeoutMs);
+}
+
+void LingmoTools::connectNotify(const QMetaMethod& signal)
+{
+    if (signal == QMetaMethod::fromSignal(&LingmoTools::wallpaperChanged)) {
+        startWallpaperWatch();
+    }
+}
+
+void LingmoTools::startWallpaperWatch()
+{
+    if (_wallpaperWatcher) {
+        return;
+    }
+    _wallpaperWatcher = new QFileSystemWatcher(this);
+
+    // Fallback for every platform: the wallpaper file itself may be rewritten
+    // in place (or replaced by rename), which no D-Bus signal announces.
+    connect(_wallpaperWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& file) {
+        // Atomic saves replace the inode, which silently drops it from the watch.
+        if (QFileInfo::exists(file)) {
+            _wallpaperWatcher->addPath(file);
+        }
+        if (file == _wallpaperPath) {
+            Q_EMIT wallpaperChanged(file);
+        }
+        refreshWallpaper();
+    });
+
+#if defined(Q_OS_LINUX)
+    auto bus = QDBusConnection::sessionBus();
+    bool subscribed = false;
+    switch (wallpaperBackend()) {
+    case WallpaperBackend::Deepin:
+        subscribed = bus.connect("com.deepin.wm", "/com/deepin/wm", "com.deepin.wm",
+            "WorkspaceBackgroundChanged", this, SLOT(onWallpaperSignal()));
+        break;
+    case WallpaperBackend::Lingmo:
+        subscribed = bus.connect("com.lingmo.Settings", "/Theme", "org.freedesktop.DBus.Properties",
+            "PropertiesChanged", this, SLOT(onWallpaperPropertiesChanged(QString, QVariantMap, QStringList)));
+        break;
+    case WallpaperBackend::Plasma: {
+        subscribed = bus.connect("org.kde.plasmashell", "/PlasmaShell", "org.kde.PlasmaShell",
+            "wallpaperChanged", this, SLOT(onWallpaperSignal()));
+        // Older Plasma releases have no wallpaperChanged signal, but always
+        // rewrite the applet config when the wallpaper is switched.
+        const QString appletsrc = QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation)
+            + "/plasma-org.kde.plasma.desktop-appletsrc";
+        if (QFileInfo::exists(appletsrc)) {
+            _wallpaperWatcher->addPath(appletsrc);
+        }
+        break;
+    }
+    case WallpaperBackend::None:
+        break;
+    }
+    if (!subscribed) {
+        qDebug() << "No wallpaper change signal on D-Bus, relying on the file watch";
+    }
+#endif
+
+    // Only seeds the current path: nothing changed yet, so nothing is emitted.
+    wallpaperFilePathAsync().then(this, [this](const QString& path) {
+        if (!path.isEmpty() && _wallpaperPath.isEmpty()) {
+            setWallpaperPath(path, false);
         }
+    });
+}
+
+void LingmoTools::onWallpaperSignal()
+{
+    refreshWallpaper();
+}
+
+void LingmoTools::onWallpaperPropertiesChanged(const QString& interfaceName, const QVariantMap& changed,
+    const QStringList& invalidated)
+{
+    if (interfaceName != "com.lingmo.Theme") {
+        return;
     }
-    return QColor(int(bright * r / t) > 255 ? 255 : int(bright * r / t),
-        int(bright * g / t) > 255 ? 255 : int(bright * g / t),
-        int(bright * b / t) > 255 ? 255 : int(bright * b / t));
+    if (changed.contains("wallpaper")) {
+        setWallpaperPath(changed.value("wallpaper").toString());
+    } else if (invalidated.contains("wallpaper")) {
+        refreshWallpaper();
+    }
+}
+
+void LingmoTools::refreshWallpaper()
+{
+    wallpaperFilePathAsync().then(this, [this](const QString& path) {
+        // A failed or timed-out query says nothing about the wallpaper; keep
+        // the last known one rather than announcing an empty path.
+        if (!path.isEmpty()) {
+            setWallpaperPath(path);
+        }
+    });
+}
+
+void LingmoTools::setWallpaperPath(const QString& path, bool notify)
+{
+    if (path == _wallpaperPath) {
+        return;
+    }
+    if (!_wallpaperPath.isEmpty()) {
+        _wallpaperWatcher->removePath(_wallpaperPath);
+    }
+    _wallpaperPath = path;
+    if (!path.isEmpty() && QFileInfo::exists(path)) {
+        _wallpaperWatcher->addPath(path);
+    }
+    if (notify) {
+        Q_EMIT wallpaperChanged(path);
+    }
+}
+
+QColor LingmoTools::imageMainColor(const QImage& image, double bright)
+{
+    // Same 20px sampling grid as the original per-pixel loop, so the
+    // resulting color is unchanged; only the accumulation got faster.
+    return averageImageColor(image, mainColorStep, bright);
+}
+
+QVariantList LingmoTools::imagePalette(const QImage& image, int count)
+{
+    return paletteToVariant(extractPalette(image, count));
 }
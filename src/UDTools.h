@@ -2,28 +2,24 @@
 #define LINGMOTOOLS_H
 
 #include <cstdint>
+#include <memory>
 
+#include <QFuture>
+#include <QHash>
 #include <QIcon>
 #include <QImage>
 #include <QObject>
 #include <QQmlEngine>
 #include <QQuickWindow>
+#include <QThreadPool>
 
+#include "UDScreenTopology.h"
+#include "UDStringSwitch.h"
 #include "singleton.h"
 
-typedef std::uint64_t hash_t;
-
-constexpr hash_t prime = 0x100000001B3ull;
-constexpr hash_t basis = 0xCBF29CE484222325ull;
-
-// Compute the hash of a string.
-hash_t hash_(char const* str);
-
-constexpr hash_t hash_compile_time(char const* str, hash_t last_value = basis)
-{
-    return *str ? hash_compile_time(str + 1, (*str ^ last_value) * prime)
-                : last_value;
-}
+class QFileSystemWatcher;
+class QScreen;
+struct RemoveTreeState;
 
 /**
  * @brief The LingmoTools class. Contains some small utils.
@@ -33,6 +29,11 @@ class LingmoTools : public QObject {
     Q_OBJECT
     QML_NAMED_ELEMENT(LingmoTools)
     QML_SINGLETON
+    Q_PROPERTY(QVariantMap platform READ platform CONSTANT FINAL)
+    Q_PROPERTY(int screenCount READ screenCount NOTIFY screensChanged FINAL)
+    Q_PROPERTY(QRect virtualGeometry READ getVirtualGeometry NOTIFY screensChanged FINAL)
+    Q_PROPERTY(QVariantList screenGeometries READ screenGeometries NOTIFY screensChanged FINAL)
+    Q_PROPERTY(QVariantList availableGeometries READ availableGeometries NOTIFY screensChanged FINAL)
 
 private:
     explicit LingmoTools(QObject* parent = nullptr);
@@ -40,12 +41,23 @@ private:
 public:
     SINGLETON(LingmoTools)
 
-    static auto create(QQmlEngine*, QJSEngine*) { return getInstance(); }
+    static auto create(QQmlEngine*, QJSEngine*)
+    {
+        // Owned by ServiceRegistry, not by the engine that asked for it.
+        QJSEngine::setObjectOwnership(getInstance(), QJSEngine::CppOwnership);
+        return getInstance();
+    }
+
+    ~LingmoTools() override;
 
     Q_INVOKABLE int qtMajor();
 
     Q_INVOKABLE int qtMinor();
 
+    // OS, Qt, windowing system, renderer and effect support, captured once
+    // (see PlatformInfo); keys are the PlatformInfo member names.
+    QVariantMap platform();
+
     Q_INVOKABLE bool isMacos();
 
     Q_INVOKABLE bool isLinux();
@@ -56,8 +68,17 @@ public:
 
     Q_INVOKABLE QString uuid();
 
+    // count ids shaped like uuid(), generated in one go.
+    Q_INVOKABLE QStringList uuids(int count);
+
     Q_INVOKABLE QString readFile(const QString& fileName);
 
+    // Raw file contents, without the UTF-16 decode readFile() does. QML needs
+    // an owning array, so this copies once out of the mapping; C++ callers
+    // that want no copy at all should hold on to mapFile() instead. Files
+    // that cannot be mapped (empty ones, /proc, FIFOs) are read the ordinary way.
+    Q_INVOKABLE QByteArray readFileBytes(const QString& fileName);
+
     Q_INVOKABLE void setQuitOnLastWindowClosed(bool val);
 
     Q_INVOKABLE void setOverrideCursor(Qt::CursorShape shape);
@@ -74,6 +95,16 @@ public:
 
     Q_INVOKABLE QRect getVirtualGeometry();
 
+    int screenCount();
+
+    QVariantList screenGeometries();
+
+    QVariantList availableGeometries();
+
+    // Cached layout of all screens, kept current from QGuiApplication and
+    // QScreen signals; screensChanged() fires whenever it is rebuilt.
+    const ScreenTopology& screenTopology();
+
     Q_INVOKABLE QString getApplicationDirPath();
 
     Q_INVOKABLE QUrl getUrlByFilePath(const QString& path);
@@ -84,18 +115,46 @@ public:
 
     Q_INVOKABLE QString sha256(const QString& text);
 
+    // Hex digest of a file's contents; algorithm is one of md5, sha256, xxh3
+    // or blake3. Empty if the file cannot be read or the algorithm is unknown.
+    Q_INVOKABLE QString fileHash(const QString& path, const QString& algorithm = "sha256");
+
+    // fileHash() for each path, hashed in parallel.
+    Q_INVOKABLE QStringList fileHashes(const QStringList& paths, const QString& algorithm = "sha256");
+
+    Q_INVOKABLE QString bytesHash(const QByteArray& data, const QString& algorithm = "sha256");
+
     Q_INVOKABLE QString toBase64(const QString& text);
 
     Q_INVOKABLE QString fromBase64(const QString& text);
 
+    // Byte-exact base64 for binary payloads (thumbnails, clipboard data).
+    Q_INVOKABLE QByteArray toBase64Bytes(const QByteArray& data);
+
+    // Empty on malformed input rather than a lossy best-effort decode.
+    Q_INVOKABLE QByteArray fromBase64Bytes(const QByteArray& text);
+
     Q_INVOKABLE bool removeDir(const QString& dirPath);
 
+    // Remove dirPath in the background. Returns an id that is passed to
+    // removeDirProgress() (every 100ms) and removeDirFinished().
+    Q_INVOKABLE int removeDirAsync(const QString& dirPath);
+
+    Q_INVOKABLE void cancelRemoveDir(int id);
+
     Q_INVOKABLE bool removeFile(const QString& filePath);
 
     Q_INVOKABLE void showFileInFolder(const QString& path);
 
     Q_INVOKABLE bool isSoftware(); // Checkfor software rendering
 
+    // Construction time of every service built so far, in construction order,
+    // as { name, ms, mainThread } maps (see ServiceRegistry::timings()).
+    Q_INVOKABLE QVariantList serviceTimings();
+
+    // Logs the service timings, slowest first, e.g. once the first frame is up.
+    Q_INVOKABLE void dumpServiceTimings();
+
     Q_INVOKABLE qint64 currentTimestamp();
 
     Q_INVOKABLE QPoint cursorPos();
@@ -114,7 +173,68 @@ public:
 
     Q_INVOKABLE QString getWallpaperFilePath();
 
+    // Non-blocking getWallpaperFilePath(). Resolves with an empty path when the
+    // desktop service fails or does not answer within timeoutMs, and also
+    // emits wallpaperPathResolved(). On macOS, only a Finder that answers
+    // without a picture resolves to the default desktop picture.
+    QFuture<QString> wallpaperFilePathAsync(int timeoutMs = 5000);
+
+    Q_INVOKABLE void requestWallpaperFilePath(int timeoutMs = 5000);
+
     Q_INVOKABLE QColor imageMainColor(const QImage& image, double bright = 1);
+
+    // Ranked list of { color, weight } maps, weights summing to 1.
+    Q_INVOKABLE QVariantList imagePalette(const QImage& image, int count = 5);
+
+Q_SIGNALS:
+    void wallpaperPathResolved(const QString& path);
+
+    // Emitted when the wallpaper changes, as announced by the desktop's D-Bus
+    // service or seen by a file watch on the current wallpaper. Watching starts
+    // with the first connection to this signal, so nobody has to poll.
+    void wallpaperChanged(const QString& path);
+
+    void screensChanged();
+
+    void removeDirProgress(int id, qint64 removed);
+
+    void removeDirFinished(int id, bool ok);
+
+protected:
+    void connectNotify(const QMetaMethod& signal) override;
+
+private Q_SLOTS:
+    void onWallpaperSignal();
+
+    void onWallpaperPropertiesChanged(const QString& interfaceName, const QVariantMap& changed,
+        const QStringList& invalidated);
+
+private:
+    void startWallpaperWatch();
+
+    void refreshWallpaper();
+
+    // Watches path instead of the previous one; emits wallpaperChanged() if
+    // notify is set and the path differs.
+    void setWallpaperPath(const QString& path, bool notify = true);
+
+    void watchScreens();
+
+    // Emits screensChanged() if the layout differs from the cached one.
+    void rebuildScreenTopology(QScreen* removed = nullptr);
+
+    // Re-reads the screens into _screenTopology; true if it changed.
+    bool readScreens(QScreen* removed = nullptr);
+
+    QFileSystemWatcher* _wallpaperWatcher = nullptr;
+    QString _wallpaperPath;
+    ScreenTopology _screenTopology;
+    QList<QScreen*> _screens;
+    bool _screensWatched = false;
+    QHash<int, std::shared_ptr<RemoveTreeState>> _removals;
+    int _nextRemovalId = 0;
+    // removeDirAsync() drivers only, so shutdown waits for nothing else.
+    QThreadPool _removalPool;
 };
 
 #endif // LINGMOTOOLS_H
@@ -0,0 +1,134 @@
+#include "UDUuid.h"
+
+#include <QRandomGenerator>
+
+#include <atomic>
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <pthread.h>
+#endif
+
+namespace {
+
+constexpr qsizetype uuidSize = 16;
+constexpr char hexDigits[] = "0123456789abcdef";
+
+#if defined(Q_OS_UNIX)
+std::atomic<quint32> forkGeneration { 0 };
+
+// Bumped in every child after fork(); a relaxed load instead of a getpid()
+// system call on each read.
+quint32 currentForkGeneration()
+{
+    static const int registered = ::pthread_atfork(nullptr, nullptr, [] {
+        forkGeneration.fetch_add(1, std::memory_order_relaxed);
+    });
+    Q_UNUSED(registered)
+    return forkGeneration.load(std::memory_order_relaxed);
+}
+#endif
+
+/**
+ * @brief Random bytes drawn from the system CSPRNG in 4 KiB batches. One per
+ * thread, so no locking; discarded after fork() so parent and child never
+ * hand out the same bytes.
+ */
+class RandomPool {
+public:
+    void read(uchar* out, qsizetype count)
+    {
+#if defined(Q_OS_UNIX)
+        const quint32 generation = currentForkGeneration();
+        if (generation != _generation) {
+            _generation = generation;
+            _pos = bufferSize;
+        }
+#endif
+        while (count > 0) {
+            if (_pos == bufferSize) {
+                QRandomGenerator::system()->fillRange(_buffer, bufferWords);
+                _pos = 0;
+            }
+            const qsizetype take = qMin(count, bufferSize - _pos);
+            std::memcpy(out, reinterpret_cast<const uchar*>(_buffer) + _pos, size_t(take));
+            // Never hand the same bytes out twice.
+            std::memset(reinterpret_cast<uchar*>(_buffer) + _pos, 0, size_t(take));
+            _pos += take;
+            out += take;
+            count -= take;
+        }
+    }
+
+private:
+    static constexpr qsizetype bufferWords = 1024;
+    static constexpr qsizetype bufferSize = bufferWords * qsizetype(sizeof(quint32));
+
+    quint32 _buffer[bufferWords];
+    qsizetype _pos = bufferSize;
+#if defined(Q_OS_UNIX)
+    quint32 _generation = 0;
+#endif
+};
+
+RandomPool& randomPool()
+{
+    thread_local RandomPool pool;
+    return pool;
+}
+
+template <typename Char>
+void writeHex(const uchar* uuid, Char* out)
+{
+    for (qsizetype i = 0; i < uuidSize; ++i) {
+        out[2 * i] = Char(char16_t(hexDigits[uuid[i] >> 4]));
+        out[2 * i + 1] = Char(char16_t(hexDigits[uuid[i] & 0x0F]));
+    }
+}
+
+} // namespace
+
+void uuidToHex(const uchar* uuid, char* out)
+{
+    writeHex(uuid, out);
+}
+
+void randomUuids(uchar* out, qsizetype count)
+{
+    randomPool().read(out, count * uuidSize);
+    for (qsizetype i = 0; i < count; ++i, out += uuidSize) {
+        out[6] = (out[6] & 0x0F) | 0x40; // version 4
+        out[8] = (out[8] & 0x3F) | 0x80; // RFC 4122 variant
+    }
+}
+
+QString uuidHex()
+{
+    uchar uuid[uuidSize];
+    randomUuids(uuid, 1);
+    QString hex(2 * uuidSize, Qt::Uninitialized);
+    writeHex(uuid, hex.data());
+    return hex;
+}
+
+QStringList uuidHexes(qsizetype count)
+{
+    const QByteArray bytes = uuidBytes(count);
+    const auto* uuid = reinterpret_cast<const uchar*>(bytes.constData());
+    count = bytes.size() / uuidSize;
+    QStringList hexes;
+    hexes.reserve(count);
+    for (qsizetype i = 0; i < count; ++i, uuid += uuidSize) {
+        QString hex(2 * uuidSize, Qt::Uninitialized);
+        writeHex(uuid, hex.data());
+        hexes.append(std::move(hex));
+    }
+    return hexes;
+}
+
+QByteArray uuidBytes(qsizetype count)
+{
+    QByteArray bytes(qMax<qsizetype>(count, 0) * uuidSize, Qt::Uninitialized);
+    randomUuids(reinterpret_cast<uchar*>(bytes.data()), qMax<qsizetype>(count, 0));
+    return bytes;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+// Write count random version 4 UUIDs, 16 bytes each, to out. The bytes come
+// from a per-thread buffer refilled from QRandomGenerator::system(), so the
+// operating system CSPRNG is hit once per 256 UUIDs rather than once each.
+void randomUuids(uchar* out, qsizetype count);
+
+// A random UUID as 32 lowercase hex digits, without braces or dashes; the
+// same shape LingmoTools::uuid() has always returned.
+QString uuidHex();
+
+// The 32 hex digits of uuidHex() for the 16 bytes at uuid, written to out
+// without a terminator.
+void uuidToHex(const uchar* uuid, char* out);
+
+QStringList uuidHexes(qsizetype count);
+
+// count UUIDs as 16 raw bytes each, back to back.
+QByteArray uuidBytes(qsizetype count);
@@ -0,0 +1,275 @@
+#include "UDWallpaperCache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr int indexVersion = 2;
+
+QJsonArray paletteToJson(const QList<PaletteColor>& palette)
+{
+    QJsonArray array;
+    for (const PaletteColor& entry : palette) {
+        array.append(QJsonObject { { "color", entry.color.name() }, { "weight", entry.weight } });
+    }
+    return array;
+}
+
+QList<PaletteColor> paletteFromJson(const QJsonArray& array)
+{
+    QList<PaletteColor> palette;
+    palette.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        const QJsonObject object = value.toObject();
+        palette.append({ QColor(object["color"].toString()), object["weight"].toDouble() });
+    }
+    return palette;
+}
+
+} // namespace
+
+LingmoWallpaperCache::LingmoWallpaperCache(QObject* parent)
+    : QObject { parent }
+{
+}
+
+QString LingmoWallpaperCache::cacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/wallpaper";
+}
+
+QColor LingmoWallpaperCache::mainColor(const QString& path, double bright)
+{
+    const std::optional<Entry> e = entry(path);
+    if (!e) {
+        return {};
+    }
+    return averageColor(e->sums, bright);
+}
+
+QVariantList LingmoWallpaperCache::palette(const QString& path, int count)
+{
+    const std::optional<Entry> e = entry(path);
+    if (!e) {
+        return {};
+    }
+    const auto cached = e->palettes.constFind(count);
+    if (cached != e->palettes.constEnd()) {
+        return paletteToVariant(*cached);
+    }
+
+    // From the full wallpaper like the first five, not the thumbnail, whose
+    // downscaling would shift the colors and their weights.
+    QImageReader reader(path);
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Failed to decode wallpaper" << path << reader.errorString();
+        return {};
+    }
+    const QList<PaletteColor> palette = extractPalette(image, count);
+    {
+        QMutexLocker locker(&_mutex);
+        auto it = _entries.find(path);
+        if (it != _entries.end() && it->size == e->size && it->mtime == e->mtime) {
+            it->palettes.insert(count, palette);
+            saveIndex();
+        }
+    }
+    return paletteToVariant(palette);
+}
+
+QUrl LingmoWallpaperCache::thumbnail(const QString& path)
+{
+    const std::optional<Entry> e = entry(path);
+    if (!e) {
+        return {};
+    }
+    return QUrl::fromLocalFile(cacheDir() + "/" + e->thumbnail);
+}
+
+void LingmoWallpaperCache::clear()
+{
+    QMutexLocker locker(&_mutex);
+    _entries.clear();
+    _loaded = true;
+    QDir(cacheDir()).removeRecursively();
+}
+
+std::optional<LingmoWallpaperCache::Entry> LingmoWallpaperCache::entry(const QString& path)
+{
+    const QFileInfo info(path);
+    if (!info.isFile()) {
+        return std::nullopt;
+    }
+    const qint64 size = info.size();
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+
+    {
+        QMutexLocker locker(&_mutex);
+        if (!_loaded) {
+            loadIndex();
+        }
+        auto it = _entries.find(path);
+        if (it != _entries.end() && it->size == size && it->mtime == mtime
+            && QFile::exists(cacheDir() + "/" + it->thumbnail)) {
+            // Only kept in memory; the next index write persists it.
+            it->used = QDateTime::currentMSecsSinceEpoch();
+            Entry hit = *it;
+            locker.unlock();
+            countLookup(true);
+            return hit;
+        }
+    }
+
+    countLookup(false);
+    std::optional<Entry> decoded = decode(path, size, mtime);
+    if (!decoded) {
+        return std::nullopt;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _entries.insert(path, *decoded);
+    evict();
+    saveIndex();
+    return decoded;
+}
+
+std::optional<LingmoWallpaperCache::Entry> LingmoWallpaperCache::decode(const QString& path, qint64 size, qint64 mtime)
+{
+    QImageReader reader(path);
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Failed to decode wallpaper" << path << reader.errorString();
+        return std::nullopt;
+    }
+
+    Entry e;
+    e.size = size;
+    e.mtime = mtime;
+    e.sums = accumulateImageColor(image, mainColorStep);
+    e.palettes.insert(5, extractPalette(image, 5));
+    e.thumbnail = QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Md5).toHex() + ".png";
+    e.used = QDateTime::currentMSecsSinceEpoch();
+
+    const QString dir = cacheDir();
+    QDir().mkpath(dir);
+    const QImage thumb = image.scaled(thumbnailSize, thumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    if (!thumb.save(dir + "/" + e.thumbnail, "PNG")) {
+        qWarning() << "Failed to write wallpaper thumbnail for" << path;
+    }
+    return e;
+}
+
+void LingmoWallpaperCache::loadIndex()
+{
+    _loaded = true;
+    QFile file(cacheDir() + "/index.json");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root["version"].toInt() != indexVersion) {
+        return;
+    }
+    const QJsonObject entries = root["entries"].toObject();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        const QJsonArray sums = object["sums"].toArray();
+        Entry e;
+        e.size = object["size"].toInteger();
+        e.mtime = object["mtime"].toInteger();
+        e.sums.red = quint64(sums.at(0).toInteger());
+        e.sums.green = quint64(sums.at(1).toInteger());
+        e.sums.blue = quint64(sums.at(2).toInteger());
+        e.sums.count = quint64(sums.at(3).toInteger());
+        const QJsonObject palettes = object["palettes"].toObject();
+        for (auto palette = palettes.begin(); palette != palettes.end(); ++palette) {
+            e.palettes.insert(palette.key().toInt(), paletteFromJson(palette.value().toArray()));
+        }
+        e.thumbnail = object["thumbnail"].toString();
+        e.used = object["used"].toInteger();
+        _entries.insert(it.key(), e);
+    }
+    // An index written by an older build may be over the limit.
+    evict();
+}
+
+void LingmoWallpaperCache::saveIndex()
+{
+    QJsonObject entries;
+    for (auto it = _entries.constBegin(); it != _entries.constEnd(); ++it) {
+        const Entry& e = it.value();
+        QJsonObject palettes;
+        for (auto palette = e.palettes.constBegin(); palette != e.palettes.constEnd(); ++palette) {
+            palettes.insert(QString::number(palette.key()), paletteToJson(palette.value()));
+        }
+        entries.insert(it.key(), QJsonObject {
+            { "size", e.size },
+            { "mtime", e.mtime },
+            { "sums", QJsonArray { qint64(e.sums.red), qint64(e.sums.green), qint64(e.sums.blue), qint64(e.sums.count) } },
+            { "palettes", palettes },
+            { "thumbnail", e.thumbnail },
+            { "used", e.used },
+        });
+    }
+
+    const QString dir = cacheDir();
+    QDir().mkpath(dir);
+    QSaveFile file(dir + "/index.json");
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write wallpaper cache index" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject { { "version", indexVersion }, { "entries", entries } }).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+// Called with _mutex held. Drops the least recently used entries and their
+// thumbnails until at most maxEntries are left.
+void LingmoWallpaperCache::evict()
+{
+    if (_entries.size() <= maxEntries) {
+        return;
+    }
+    std::vector<std::pair<qint64, QString>> byUse;
+    byUse.reserve(_entries.size());
+    for (auto it = _entries.constBegin(); it != _entries.constEnd(); ++it) {
+        byUse.emplace_back(it->used, it.key());
+    }
+    const auto excess = byUse.begin() + (byUse.size() - maxEntries);
+    std::nth_element(byUse.begin(), excess, byUse.end());
+    const QString dir = cacheDir();
+    for (auto it = byUse.begin(); it != excess; ++it) {
+        const auto entry = _entries.constFind(it->second);
+        QFile::remove(dir + "/" + entry->thumbnail);
+        _entries.erase(entry);
+    }
+}
+
+// The signals are emitted on the calling thread; receivers elsewhere get
+// them queued.
+void LingmoWallpaperCache::countLookup(bool hit)
+{
+    if (hit) {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        Q_EMIT hitsChanged();
+    } else {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        Q_EMIT missesChanged();
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef LINGMOWALLPAPERCACHE_H
+#define LINGMOWALLPAPERCACHE_H
+
+#include <atomic>
+#include <optional>
+
+#include <QColor>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QQmlEngine>
+#include <QUrl>
+
+#include "UDImageColor.h"
+#include "singleton.h"
+#include "stdafx.h"
+
+/**
+ * @brief The LingmoWallpaperCache class. Remembers the main color, palette and
+ * a thumbnail of wallpapers on disk, keyed by path + size + mtime, so repeat
+ * launches only stat the file instead of decoding it. Keeps at most
+ * maxEntries wallpapers, dropping the least recently used ones.
+ */
+class LingmoWallpaperCache : public QObject {
+    Q_OBJECT
+    QML_NAMED_ELEMENT(LingmoWallpaperCache)
+    QML_SINGLETON
+    // Counted from whichever thread does the lookup, hence atomic.
+    Q_PROPERTY(int hits READ hits NOTIFY hitsChanged FINAL)
+    Q_PROPERTY(int misses READ misses NOTIFY missesChanged FINAL)
+
+private:
+    explicit LingmoWallpaperCache(QObject* parent = nullptr);
+
+public:
+    SINGLETON(LingmoWallpaperCache)
+
+    static auto create(QQmlEngine*, QJSEngine*)
+    {
+        // Owned by ServiceRegistry, not by the engine that asked for it.
+        QJSEngine::setObjectOwnership(getInstance(), QJSEngine::CppOwnership);
+        return getInstance();
+    }
+
+    // Same result as LingmoTools::imageMainColor on the decoded file.
+    Q_INVOKABLE QColor mainColor(const QString& path, double bright = 1);
+
+    // Same result as LingmoTools::imagePalette on the decoded file, for any
+    // count. Five colors come with the first decode; other counts decode the
+    // file once more the first time they are asked for.
+    Q_INVOKABLE QVariantList palette(const QString& path, int count = 5);
+
+    // File URL of a downscaled copy, at most thumbnailSize on either side.
+    Q_INVOKABLE QUrl thumbnail(const QString& path);
+
+    Q_INVOKABLE QString cacheDir();
+
+    Q_INVOKABLE void clear();
+
+    int hits() const { return _hits.load(std::memory_order_relaxed); }
+    int misses() const { return _misses.load(std::memory_order_relaxed); }
+
+    static constexpr int thumbnailSize = 320;
+    static constexpr int maxEntries = 200;
+
+Q_SIGNALS:
+    void hitsChanged();
+    void missesChanged();
+
+private:
+    struct Entry {
+        qint64 size = 0;
+        qint64 mtime = 0;
+        ImageColorSums sums;
+        QHash<int, QList<PaletteColor>> palettes; // by color count
+        QString thumbnail;
+        qint64 used = 0; // last lookup, ms since epoch
+    };
+
+    std::optional<Entry> entry(const QString& path);
+    std::optional<Entry> decode(const QString& path, qint64 size, qint64 mtime);
+    void loadIndex();
+    void saveIndex();
+    void evict();
+    void countLookup(bool hit);
+
+    QMutex _mutex;
+    QHash<QString, Entry> _entries;
+    bool _loaded = false;
+    std::atomic<int> _hits { 0 };
+    std::atomic<int> _misses { 0 };
+};
+
+#endif // LINGMOWALLPAPERCACHE_H
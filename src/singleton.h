@@ -1,21 +1,74 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+
+#include "UDServiceRegistry.h"
+
 /**
- * @brief The Singleton class
+ * @brief The Singleton class. Constructs T on first use, thread-safely, and
+ * hands it to ServiceRegistry, which times the construction and owns the
+ * instance until ServiceRegistry::shutdown().
  */
 template <typename T>
 class Singleton {
 public:
     static T* getInstance();
+
+private:
+    static QString name();
+
+    static void destroy();
+
+    static inline std::atomic<T*> _instance { nullptr };
+    static inline std::mutex _mutex;
 };
 
 template <typename T>
 T* Singleton<T>::getInstance()
 {
-    static T* instance = new T();
+    if (T* instance = _instance.load(std::memory_order_acquire)) {
+        return instance;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    T* instance = _instance.load(std::memory_order_relaxed);
+    if (!instance) {
+        QElapsedTimer timer;
+        timer.start();
+        instance = new T();
+        QObject* object = nullptr;
+        if constexpr (std::is_base_of_v<QObject, T>) {
+            object = instance;
+        }
+        ServiceRegistry::instance().adopt(name(), object, timer.nsecsElapsed(), &Singleton<T>::destroy);
+        _instance.store(instance, std::memory_order_release);
+    }
     return instance;
 }
 
+template <typename T>
+QString Singleton<T>::name()
+{
+    if constexpr (std::is_base_of_v<QObject, T>) {
+        return QString::fromLatin1(T::staticMetaObject.className());
+    } else {
+        return QString::fromLatin1(typeid(T).name());
+    }
+}
+
+template <typename T>
+void Singleton<T>::destroy()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    delete _instance.exchange(nullptr, std::memory_order_acq_rel);
+}
+
 #define SINGLETON(Class)                        \
 private:                                        \
     friend class Singleton<Class>;              \
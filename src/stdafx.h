@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QProperty>
+
 #define Q_PROPERTY_AUTO_P(TYPE, M)                   \
     Q_PROPERTY(TYPE M MEMBER _##M NOTIFY M##Changed) \
 public:                                              \
@@ -50,3 +52,105 @@ public:                                               \
                                                       \
 private:                                              \
     TYPE _##M;
+
+// As above, but the setter only assigns and emits when the value differs,
+// so bindings that depend on the property are not re-evaluated for nothing.
+#define Q_PROPERTY_AUTO_P_DISTINCT(TYPE, M)          \
+    Q_PROPERTY(TYPE M MEMBER _##M NOTIFY M##Changed) \
+public:                                              \
+    Q_SIGNAL void M##Changed();                      \
+    void M(TYPE in_##M)                              \
+    {                                                \
+        if (_##M == in_##M)                          \
+            return;                                  \
+        _##M = in_##M;                               \
+        Q_EMIT M##Changed();                         \
+    }                                                \
+    TYPE M()                                         \
+    {                                                \
+        return _##M;                                 \
+    }                                                \
+                                                     \
+private:                                             \
+    TYPE _##M;
+
+#define Q_PROPERTY_AUTO_DISTINCT(TYPE, M)            \
+    Q_PROPERTY(TYPE M MEMBER _##M NOTIFY M##Changed) \
+public:                                              \
+    Q_SIGNAL void M##Changed();                      \
+    void M(const TYPE& in_##M)                       \
+    {                                                \
+        if (_##M == in_##M)                          \
+            return;                                  \
+        _##M = in_##M;                               \
+        Q_EMIT M##Changed();                         \
+    }                                                \
+    TYPE M()                                         \
+    {                                                \
+        return _##M;                                 \
+    }                                                \
+                                                     \
+private:                                             \
+    TYPE _##M;
+
+#define Q_PROPERTY_READONLY_AUTO_DISTINCT(TYPE, M)    \
+    Q_PROPERTY(TYPE M READ M NOTIFY M##Changed FINAL) \
+public:                                               \
+    Q_SIGNAL void M##Changed();                       \
+    void M(const TYPE& in_##M)                        \
+    {                                                 \
+        if (_##M == in_##M)                           \
+            return;                                   \
+        _##M = in_##M;                                \
+        Q_EMIT M##Changed();                          \
+    }                                                 \
+    TYPE M()                                          \
+    {                                                 \
+        return _##M;                                  \
+    }                                                 \
+                                                      \
+private:                                              \
+    TYPE _##M;
+
+// Backed by a QObjectBindableProperty: the setter only notifies on change,
+// C++ code can bind to it through M##Bindable(), and dependent bindings are
+// re-evaluated lazily. Setting a value removes any binding on the property.
+#define Q_PROPERTY_BINDABLE_AUTO(CLASS, TYPE, M)                                   \
+    Q_PROPERTY(TYPE M READ M WRITE M NOTIFY M##Changed BINDABLE M##Bindable FINAL) \
+public:                                                                            \
+    Q_SIGNAL void M##Changed();                                                    \
+    void M(const TYPE& in_##M)                                                     \
+    {                                                                              \
+        _##M = in_##M;                                                             \
+    }                                                                              \
+    TYPE M() const                                                                 \
+    {                                                                              \
+        return _##M;                                                               \
+    }                                                                              \
+    QBindable<TYPE> M##Bindable()                                                  \
+    {                                                                              \
+        return &_##M;                                                              \
+    }                                                                              \
+                                                                                   \
+private:                                                                           \
+    Q_OBJECT_BINDABLE_PROPERTY(CLASS, TYPE, _##M, &CLASS::M##Changed)
+
+#define Q_PROPERTY_READONLY_BINDABLE_AUTO(CLASS, TYPE, M)                  \
+    Q_PROPERTY(TYPE M READ M NOTIFY M##Changed BINDABLE M##Bindable FINAL) \
+public:                                                                    \
+    Q_SIGNAL void M##Changed();                                            \
+    void M(const TYPE& in_##M)                                             \
+    {                                                                      \
+        _##M = in_##M;                                                     \
+    }                                                                      \
+    TYPE M() const                                                         \
+    {                                                                      \
+        return _##M;                                                       \
+    }                                                                      \
+    QBindable<TYPE> M##Bindable()                                          \
+    {                                                                      \
+        return &_##M;                                                      \
+    }                                                                      \
+                                                                           \
+private:                                                                   \
+    Q_OBJECT_BINDABLE_PROPERTY(CLASS, TYPE, _##M, &CLASS::M##Changed)
@@ -0,0 +1,136 @@
+#include <UDBase64.h>
+
+#include <QRandomGenerator>
+#include <QTest>
+
+// Throughput of LingmoTools::toBase64()/fromBase64(), which go through
+// QString, against the byte-oriented encoder and decoder.
+class BenchBase64 : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void previousEncode_data();
+    void previousEncode();
+    void encode_data();
+    void encode();
+    void previousDecode_data();
+    void previousDecode();
+    void decode_data();
+    void decode();
+    void streamDecode_data();
+    void streamDecode();
+
+private:
+    static QByteArray payload(int size);
+};
+
+void BenchBase64::previousEncode_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("1KiB") << (1 << 10);
+    QTest::newRow("64KiB") << (64 << 10);
+    QTest::newRow("4MiB") << (4 << 20);
+}
+
+// Printable ASCII, so the previous QString round trip keeps it intact and
+// both paths do the same work.
+QByteArray BenchBase64::payload(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator random(size);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(' ' + random.bounded(95));
+    }
+    return data;
+}
+
+void BenchBase64::previousEncode()
+{
+    QFETCH(int, size);
+
+    const QString text = QString::fromUtf8(payload(size));
+    QString encoded;
+    QBENCHMARK {
+        encoded = text.toUtf8().toBase64();
+    }
+    QCOMPARE(encoded.toUtf8(), base64Encode(text.toUtf8()));
+}
+
+void BenchBase64::encode_data()
+{
+    previousEncode_data();
+}
+
+void BenchBase64::encode()
+{
+    QFETCH(int, size);
+
+    const QByteArray data = payload(size);
+    QByteArray encoded;
+    QBENCHMARK {
+        encoded = base64Encode(data);
+    }
+    QCOMPARE(encoded, data.toBase64());
+}
+
+void BenchBase64::previousDecode_data()
+{
+    previousEncode_data();
+}
+
+void BenchBase64::previousDecode()
+{
+    QFETCH(int, size);
+
+    const QString text = QString::fromLatin1(payload(size).toBase64());
+    QString decoded;
+    QBENCHMARK {
+        decoded = QByteArray::fromBase64(text.toUtf8());
+    }
+    QCOMPARE(decoded.size(), qsizetype(size));
+}
+
+void BenchBase64::decode_data()
+{
+    previousEncode_data();
+}
+
+void BenchBase64::decode()
+{
+    QFETCH(int, size);
+
+    const QByteArray text = payload(size).toBase64();
+    std::optional<QByteArray> decoded;
+    QBENCHMARK {
+        decoded = base64Decode(text);
+    }
+    QVERIFY(decoded);
+    QCOMPARE(decoded->size(), qsizetype(size));
+}
+
+void BenchBase64::streamDecode_data()
+{
+    previousEncode_data();
+}
+
+// The clipboard case: the text arrives in 16 KiB pieces.
+void BenchBase64::streamDecode()
+{
+    QFETCH(int, size);
+
+    const QByteArray text = payload(size).toBase64();
+    QByteArray decoded;
+    QBENCHMARK {
+        decoded.clear();
+        Base64Decoder decoder;
+        for (qsizetype i = 0; i < text.size(); i += 16 << 10) {
+            decoder.update(QByteArrayView(text).sliced(i, qMin<qsizetype>(16 << 10, text.size() - i)), decoded);
+        }
+        QVERIFY(decoder.finish(decoded));
+    }
+    QCOMPARE(decoded.size(), qsizetype(size));
+}
+
+QTEST_GUILESS_MAIN(BenchBase64)
+#include "bench_base64.moc"
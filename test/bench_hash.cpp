@@ -0,0 +1,109 @@
+#include <UDHash.h>
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+Q_DECLARE_METATYPE(HashAlgorithm)
+
+// File hashing before (read, QString round trip, hash) and after (mapped,
+// streamed), and the parallel batch against a serial loop.
+class BenchHash : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void previousPath();
+    void hashFile_data();
+    void hashFile();
+    void serialFiles();
+    void batchFiles();
+
+private:
+    QTemporaryDir _dir;
+    QString _large;
+    QStringList _small;
+};
+
+void BenchHash::initTestCase()
+{
+    QVERIFY(_dir.isValid());
+    // Text, so the QString round trip of the previous path keeps it intact.
+    QByteArray line("The quick brown fox jumps over the lazy dog 0123456789\n");
+    QByteArray data;
+    data.reserve(256 << 20);
+    while (data.size() < (256 << 20)) {
+        data += line;
+    }
+    _large = _dir.filePath(QStringLiteral("large"));
+    QFile large(_large);
+    QVERIFY(large.open(QIODevice::WriteOnly));
+    QCOMPARE(large.write(data), data.size());
+
+    for (int i = 0; i < 256; ++i) {
+        const QString path = _dir.filePath(QStringLiteral("small-%1").arg(i));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data.constData(), 1 << 20), qint64(1 << 20));
+        _small << path;
+    }
+}
+
+// What hashing a file through LingmoTools::readFile() and sha256() cost.
+void BenchHash::previousPath()
+{
+    QByteArray digest;
+    QBENCHMARK {
+        QFile file(_large);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QString text = QString::fromUtf8(file.readAll());
+        digest = QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha256);
+    }
+    QCOMPARE(digest, ::hashFile(_large, HashAlgorithm::Sha256));
+}
+
+void BenchHash::hashFile_data()
+{
+    QTest::addColumn<HashAlgorithm>("algorithm");
+
+    QTest::newRow("md5") << HashAlgorithm::Md5;
+    QTest::newRow("sha256") << HashAlgorithm::Sha256;
+    QTest::newRow("xxh3") << HashAlgorithm::Xxh3;
+    QTest::newRow("blake3") << HashAlgorithm::Blake3;
+}
+
+void BenchHash::hashFile()
+{
+    QFETCH(HashAlgorithm, algorithm);
+
+    QByteArray digest;
+    QBENCHMARK {
+        digest = ::hashFile(_large, algorithm);
+    }
+    QVERIFY(!digest.isEmpty());
+}
+
+void BenchHash::serialFiles()
+{
+    QList<QByteArray> digests;
+    QBENCHMARK {
+        digests.clear();
+        for (const QString& path : std::as_const(_small)) {
+            digests << ::hashFile(path, HashAlgorithm::Blake3);
+        }
+    }
+    QCOMPARE(digests.size(), _small.size());
+}
+
+void BenchHash::batchFiles()
+{
+    QList<QByteArray> digests;
+    QBENCHMARK {
+        digests = hashFiles(_small, HashAlgorithm::Blake3);
+    }
+    QCOMPARE(digests.size(), _small.size());
+}
+
+QTEST_GUILESS_MAIN(BenchHash)
+#include "bench_hash.moc"
@@ -0,0 +1,143 @@
+#include <qhotkey_p.h>
+
+#include <QCoreApplication>
+#include <QMetaMethod>
+#include <QMultiHash>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+// Dispatch of key events to the hotkeys registered on them, with 1, 10 and
+// 500 shortcuts registered. 10000 events per iteration, spread over all of
+// them, so events per second is 10000 over the time reported: the
+// QMultiHash lookup and queued invoke per listener the dispatch used before,
+// and QHotkeyPrivate::activateShortcut() on the flat shortcut table.
+class BenchHotkeyDispatch : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void previousDispatch_data();
+    void previousDispatch();
+    void tableDispatch_data();
+    void tableDispatch();
+};
+
+static constexpr int eventCount = 10000;
+
+// A backend that grabs nothing, so the platform one is never created.
+class DispatchBackend : public QHotkeyPrivate {
+public:
+    using QHotkeyPrivate::activateShortcut;
+
+protected:
+    quint32 nativeKeycode(Qt::Key keycode, bool& ok) override
+    {
+        ok = true;
+        return quint32(keycode);
+    }
+    quint32 nativeModifiers(Qt::KeyboardModifiers modifiers, bool& ok) override
+    {
+        ok = true;
+        return quint32(modifiers);
+    }
+    bool registerShortcut(QHotkey::NativeShortcut) override { return true; }
+    bool unregisterShortcut(QHotkey::NativeShortcut) override { return true; }
+    bool nativeEventFilter(const QByteArray&, void*, _NATIVE_EVENT_RESULT*) override { return false; }
+};
+
+// Dense bindings as desktop shortcuts have them: neighbouring keycodes under
+// a handful of modifier masks.
+static std::vector<QHotkey::NativeShortcut> denseShortcuts(int count)
+{
+    static const quint32 modifiers[] = { 0x4 | 0x8, 0x4 | 0x1, 0x40, 0x40 | 0x1 };
+    std::vector<QHotkey::NativeShortcut> shortcuts;
+    for (int i = 0; i < count; ++i) {
+        shortcuts.emplace_back(quint32(10 + i / 4), modifiers[i % 4]);
+    }
+    return shortcuts;
+}
+
+// The key and hash the QMultiHash was used with.
+struct PreviousKey {
+    quint32 key;
+    quint32 modifier;
+
+    bool operator==(const PreviousKey& other) const { return key == other.key && modifier == other.modifier; }
+};
+
+static size_t qHash(PreviousKey key, size_t seed = 0)
+{
+    return qHash(key.key, seed) ^ qHash(key.modifier, seed);
+}
+
+void BenchHotkeyDispatch::previousDispatch_data()
+{
+    QTest::addColumn<int>("hotkeyCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("10") << 10;
+    QTest::newRow("500") << 500;
+}
+
+void BenchHotkeyDispatch::previousDispatch()
+{
+    QFETCH(int, hotkeyCount);
+    const std::vector<QHotkey::NativeShortcut> shortcuts = denseShortcuts(hotkeyCount);
+    QObject parent;
+    QMultiHash<PreviousKey, QHotkey*> table;
+    int activations = 0;
+    for (const QHotkey::NativeShortcut& shortcut : shortcuts) {
+        auto* hotkey = new QHotkey(shortcut, false, &parent);
+        connect(hotkey, &QHotkey::activated, [&] { ++activations; });
+        table.insert({ shortcut.key, shortcut.modifier }, hotkey);
+    }
+
+    const QMetaMethod activated = QMetaMethod::fromSignal(&QHotkey::activated);
+    QBENCHMARK {
+        for (int i = 0; i < eventCount; ++i) {
+            const QHotkey::NativeShortcut& shortcut = shortcuts[std::size_t(i % hotkeyCount)];
+            for (QHotkey* hotkey : table.values({ shortcut.key, shortcut.modifier })) {
+                activated.invoke(hotkey, Qt::QueuedConnection);
+            }
+        }
+        QCoreApplication::sendPostedEvents();
+    }
+    QCOMPARE(activations % eventCount, 0);
+    QVERIFY(activations > 0);
+}
+
+void BenchHotkeyDispatch::tableDispatch_data()
+{
+    previousDispatch_data();
+}
+
+void BenchHotkeyDispatch::tableDispatch()
+{
+    QFETCH(int, hotkeyCount);
+    const std::vector<QHotkey::NativeShortcut> shortcuts = denseShortcuts(hotkeyCount);
+    DispatchBackend backend;
+    std::vector<std::unique_ptr<QHotkey>> hotkeys;
+    int activations = 0;
+    for (const QHotkey::NativeShortcut& shortcut : shortcuts) {
+        hotkeys.push_back(std::make_unique<QHotkey>(shortcut));
+        connect(hotkeys.back().get(), &QHotkey::activated, [&] { ++activations; });
+        QVERIFY(backend.addShortcut(hotkeys.back().get()));
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < eventCount; ++i) {
+            backend.activateShortcut(shortcuts[std::size_t(i % hotkeyCount)]);
+        }
+    }
+    QCOMPARE(activations % eventCount, 0);
+    QVERIFY(activations > 0);
+
+    // Unregistered first, or their destructors would reach for the platform
+    // backend.
+    for (const std::unique_ptr<QHotkey>& hotkey : hotkeys) {
+        QVERIFY(backend.removeShortcut(hotkey.get()));
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchHotkeyDispatch)
+#include "bench_hotkeydispatch.moc"
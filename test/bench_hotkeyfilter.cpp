@@ -0,0 +1,156 @@
+#include <qhotkey_p.h>
+
+#include <QGuiApplication>
+#include <QTest>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <xcb/xcb.h>
+
+// Replays a high-rate XCB event stream through the X11 backend's native
+// event filter, as the application's event dispatcher hands it every event
+// of Qt's connection: 100000 events per iteration, so events per second is
+// 100000 over the time reported. The stream is generated with a fixed seed
+// in the proportions a recording of a busy desktop session has: mostly
+// pointer motion and XInput2 events, some exposes and property changes, and
+// in the "typing" row key events, a few of them on grabbed shortcuts. The
+// grabs live on the backend's own connection, so none of these may activate
+// a hotkey.
+class BenchHotkeyFilter : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void replay_data();
+    void replay();
+
+private:
+    std::vector<std::unique_ptr<QHotkey>> _hotkeys;
+    int _activations = 0;
+};
+
+static constexpr int eventCount = 100000;
+
+// Every core event is 32 bytes; the filter only reads the common header and,
+// for key events, the key event fields.
+union RecordedEvent {
+    xcb_generic_event_t generic;
+    xcb_key_press_event_t key;
+    xcb_motion_notify_event_t motion;
+};
+
+struct Stream {
+    std::vector<RecordedEvent> events;
+};
+
+static Stream recordedStream(const std::vector<QHotkey::NativeShortcut>& grabbed, bool typing)
+{
+    std::vector<xcb_keycode_t> ungrabbed;
+    for (int keycode = 8; keycode < 256; ++keycode) {
+        bool isGrabbed = false;
+        for (const QHotkey::NativeShortcut& shortcut : grabbed) {
+            isGrabbed = isGrabbed || shortcut.key == quint32(keycode);
+        }
+        if (!isGrabbed) {
+            ungrabbed.push_back(xcb_keycode_t(keycode));
+        }
+    }
+
+    Stream stream;
+    std::mt19937 random(42);
+    xcb_timestamp_t time = 1;
+    auto append = [&](quint8 type) -> RecordedEvent& {
+        RecordedEvent event {};
+        event.generic.response_type = type;
+        event.generic.sequence = quint16(stream.events.size());
+        stream.events.push_back(event);
+        return stream.events.back();
+    };
+    auto key = [&](quint8 type, xcb_keycode_t keycode, quint16 state) {
+        RecordedEvent& event = append(type);
+        event.key.detail = keycode;
+        event.key.state = state;
+        event.key.time = time++;
+    };
+
+    while (stream.events.size() < std::size_t(eventCount)) {
+        const unsigned roll = random() % 1000;
+        if (roll < 600) {
+            RecordedEvent& event = append(XCB_MOTION_NOTIFY);
+            event.motion.event_x = qint16(random() % 1280);
+            event.motion.event_y = qint16(random() % 1024);
+            event.motion.time = time++;
+        } else if (roll < 750) {
+            append(XCB_GE_GENERIC);
+        } else if (roll < 850) {
+            append(XCB_EXPOSE);
+        } else if (roll < 900 || !typing) {
+            append(XCB_PROPERTY_NOTIFY);
+        } else if (roll < 980) {
+            const xcb_keycode_t keycode = ungrabbed[random() % ungrabbed.size()];
+            key(XCB_KEY_PRESS, keycode, 0);
+            key(XCB_KEY_RELEASE, keycode, 0);
+        } else {
+            const QHotkey::NativeShortcut& shortcut = grabbed[random() % grabbed.size()];
+            key(XCB_KEY_PRESS, xcb_keycode_t(shortcut.key), quint16(shortcut.modifier));
+            key(XCB_KEY_RELEASE, xcb_keycode_t(shortcut.key), quint16(shortcut.modifier));
+        }
+    }
+    return stream;
+}
+
+void BenchHotkeyFilter::initTestCase()
+{
+    if (QGuiApplication::platformName() != QLatin1String("xcb") || !QHotkey::isPlatformSupported()) {
+        QSKIP("needs the xcb platform plugin");
+    }
+    for (const char* key : { "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12" }) {
+        for (const char* modifiers : { "Ctrl+Alt+", "Ctrl+Shift+" }) {
+            _hotkeys.push_back(std::make_unique<QHotkey>(QKeySequence(QString::fromLatin1(modifiers) + QLatin1String(key)), true));
+            QVERIFY(_hotkeys.back()->isRegistered());
+            connect(_hotkeys.back().get(), &QHotkey::activated, this, [this] { ++_activations; });
+        }
+    }
+}
+
+void BenchHotkeyFilter::cleanupTestCase()
+{
+    _hotkeys.clear();
+}
+
+void BenchHotkeyFilter::replay_data()
+{
+    QTest::addColumn<bool>("typing");
+    QTest::newRow("idle pointer") << false;
+    QTest::newRow("typing") << true;
+}
+
+void BenchHotkeyFilter::replay()
+{
+    QFETCH(bool, typing);
+    std::vector<QHotkey::NativeShortcut> grabbed;
+    for (const std::unique_ptr<QHotkey>& hotkey : _hotkeys) {
+        grabbed.push_back(hotkey->currentNativeShortcut());
+    }
+    Stream stream = recordedStream(grabbed, typing);
+    QAbstractNativeEventFilter* filter = QHotkeyPrivate::instance();
+    const QByteArray eventType = QByteArrayLiteral("xcb_generic_event_t");
+
+    int iterations = 0;
+    _activations = 0;
+    QBENCHMARK {
+        for (RecordedEvent& event : stream.events) {
+            qintptr result = 0;
+            filter->nativeEventFilter(eventType, &event, &result);
+        }
+        ++iterations;
+    }
+    QVERIFY(iterations > 0);
+    QCOMPARE(_activations, 0);
+}
+
+QTEST_MAIN(BenchHotkeyFilter)
+#include "bench_hotkeyfilter.moc"
@@ -0,0 +1,99 @@
+#include <UDHotkey.h>
+
+#include <QTest>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "xtest.h"
+
+// Time from an XTest key press to its activation being queued in the
+// hotkey ring, and to it being drained by a consumer polling from the Qt
+// thread, over 200 presses of one shortcut. The median queued latency is
+// the benchmark result; the percentiles are printed.
+class BenchHotkeyLatency : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void pressToQueued();
+
+private:
+    XTestKeyboard _keyboard;
+    int _id = -1;
+};
+
+static constexpr int pressCount = 200;
+
+static qint64 nowNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static qint64 percentile(std::vector<qint64> values, int percent)
+{
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, values.size() * std::size_t(percent) / 100)];
+}
+
+void BenchHotkeyLatency::initTestCase()
+{
+    if (!LingmoHotkeys::isSupported()) {
+        QSKIP("global hotkeys are not supported on this platform");
+    }
+    if (!_keyboard.isValid()) {
+        QSKIP("no X display with the XTest extension");
+    }
+    QString error;
+    _id = LingmoHotkeys::getInstance()->add(QKeySequence(QStringLiteral("Ctrl+Alt+F9")), &error);
+    QVERIFY2(_id >= 0, qPrintable(error));
+}
+
+void BenchHotkeyLatency::cleanupTestCase()
+{
+    if (_id >= 0) {
+        LingmoHotkeys::getInstance()->remove(_id);
+    }
+}
+
+void BenchHotkeyLatency::pressToQueued()
+{
+    const std::shared_ptr<HotkeyEventRing> ring = LingmoHotkeys::getInstance()->events();
+    std::vector<HotkeyEvent> events;
+    ring->drain(events);
+
+    std::vector<qint64> queued;
+    std::vector<qint64> drained;
+    for (int i = 0; i < pressCount; ++i) {
+        events.clear();
+        const qint64 pressed = nowNanoseconds();
+        _keyboard.press({ XK_Control_L, XK_Alt_L, XK_F9 });
+        QVERIFY(processEventsUntil([&] { return ring->drain(events) > 0; }));
+        const qint64 seen = nowNanoseconds();
+        QCOMPARE(events.front().id, _id);
+        QCOMPARE(int(events.front().kind), int(HotkeyEvent::Activated));
+        queued.push_back(events.front().timestamp - pressed);
+        drained.push_back(seen - pressed);
+
+        _keyboard.release({ XK_Control_L, XK_Alt_L, XK_F9 });
+        QVERIFY(processEventsUntil([&] {
+            ring->drain(events);
+            return std::any_of(events.begin(), events.end(), [](const HotkeyEvent& event) {
+                return event.kind == HotkeyEvent::Released;
+            });
+        }));
+    }
+
+    qInfo("queued  p50 %lld us, p99 %lld us, max %lld us", percentile(queued, 50) / 1000,
+        percentile(queued, 99) / 1000, percentile(queued, 100) / 1000);
+    qInfo("drained p50 %lld us, p99 %lld us, max %lld us", percentile(drained, 50) / 1000,
+        percentile(drained, 99) / 1000, percentile(drained, 100) / 1000);
+    QTest::setBenchmarkResult(qreal(percentile(queued, 50)), QTest::WalltimeNanoseconds);
+    QCOMPARE(ring->dropped(), quint64(0));
+}
+
+QTEST_MAIN(BenchHotkeyLatency)
+#include "bench_hotkeylatency.moc"
@@ -0,0 +1,121 @@
+#include <qhotkey.h>
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QTest>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Registering 200 application shortcuts at startup on a real X server: one
+// QHotkey::setRegistered() call after the other, with a server round trip
+// each, and a single QHotkey::registerAll() batch. Each round registers all
+// of them and unregisters them again untimed; the median over the rounds is
+// the benchmark result.
+class BenchHotkeyRegister : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void oneByOne();
+    void registerAll();
+
+private:
+    void unregisterAll();
+
+    std::vector<std::unique_ptr<QHotkey>> _hotkeys;
+    QList<QHotkey*> _list;
+};
+
+static constexpr int shortcutCount = 200;
+static constexpr int roundCount = 20;
+
+static qint64 median(std::vector<qint64> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+void BenchHotkeyRegister::initTestCase()
+{
+    if (QGuiApplication::platformName() != QLatin1String("xcb") || !QHotkey::isPlatformSupported()) {
+        QSKIP("needs the xcb platform plugin");
+    }
+    static const Qt::KeyboardModifiers modifiers[] = {
+        Qt::ControlModifier | Qt::AltModifier,
+        Qt::ControlModifier | Qt::ShiftModifier,
+        Qt::AltModifier | Qt::ShiftModifier,
+        Qt::ControlModifier | Qt::AltModifier | Qt::ShiftModifier,
+        Qt::AltModifier,
+    };
+    std::vector<Qt::Key> keys;
+    for (int key = Qt::Key_F1; key <= Qt::Key_F12; ++key) {
+        keys.push_back(Qt::Key(key));
+    }
+    for (int key = Qt::Key_A; key <= Qt::Key_Z; ++key) {
+        keys.push_back(Qt::Key(key));
+    }
+    for (int key = Qt::Key_0; key <= Qt::Key_9; ++key) {
+        keys.push_back(Qt::Key(key));
+    }
+    for (const Qt::KeyboardModifiers modifier : modifiers) {
+        for (const Qt::Key key : keys) {
+            if (_hotkeys.size() < std::size_t(shortcutCount)) {
+                _hotkeys.push_back(std::make_unique<QHotkey>(key, modifier));
+                QVERIFY(_hotkeys.back()->currentNativeShortcut().isValid());
+                _list << _hotkeys.back().get();
+            }
+        }
+    }
+    QCOMPARE(_list.size(), qsizetype(shortcutCount));
+}
+
+void BenchHotkeyRegister::cleanupTestCase()
+{
+    _list.clear();
+    _hotkeys.clear();
+}
+
+void BenchHotkeyRegister::unregisterAll()
+{
+    for (QHotkey* hotkey : _list) {
+        hotkey->setRegistered(false);
+    }
+}
+
+void BenchHotkeyRegister::oneByOne()
+{
+    std::vector<qint64> times;
+    for (int round = 0; round < roundCount; ++round) {
+        QElapsedTimer timer;
+        timer.start();
+        for (QHotkey* hotkey : _list) {
+            QVERIFY(hotkey->setRegistered(true));
+        }
+        times.push_back(timer.nsecsElapsed());
+        unregisterAll();
+    }
+    QTest::setBenchmarkResult(qreal(median(times)), QTest::WalltimeNanoseconds);
+}
+
+void BenchHotkeyRegister::registerAll()
+{
+    std::vector<qint64> times;
+    for (int round = 0; round < roundCount; ++round) {
+        QElapsedTimer timer;
+        timer.start();
+        const QList<bool> results = QHotkey::registerAll(_list);
+        times.push_back(timer.nsecsElapsed());
+        QCOMPARE(results, QList<bool>(shortcutCount, true));
+        for (QHotkey* hotkey : _list) {
+            QVERIFY(hotkey->isRegistered());
+        }
+        unregisterAll();
+    }
+    QTest::setBenchmarkResult(qreal(median(times)), QTest::WalltimeNanoseconds);
+}
+
+QTEST_MAIN(BenchHotkeyRegister)
+#include "bench_hotkeyregister.moc"
@@ -0,0 +1,118 @@
+#include <qhotkey.h>
+
+#include <QTest>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "xtest.h"
+
+// Time from an XTest key release to QHotkey::released, over 100 presses of
+// one shortcut. Registered twice with ctest: as is, where XKB detectable
+// auto-repeat reports releases as they arrive, and with
+// QHOTKEY_DETECTABLE_AUTOREPEAT=0, where they wait out the 50 ms auto-repeat
+// timer. The median is the benchmark result; the percentiles are printed.
+class BenchHotkeyRelease : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void pressToRelease();
+    void heldKeyActivatesOnce();
+
+private:
+    XTestKeyboard _keyboard;
+    std::unique_ptr<QHotkey> _hotkey;
+    int _activations = 0;
+    int _releases = 0;
+    qint64 _released = 0;
+};
+
+static constexpr int pressCount = 100;
+
+static qint64 nowNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static qint64 percentile(std::vector<qint64> values, int percent)
+{
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, values.size() * std::size_t(percent) / 100)];
+}
+
+static bool detectableAutoRepeat()
+{
+    return qEnvironmentVariable("QHOTKEY_DETECTABLE_AUTOREPEAT") != QLatin1String("0");
+}
+
+void BenchHotkeyRelease::initTestCase()
+{
+    if (!QHotkey::isPlatformSupported()) {
+        QSKIP("global hotkeys are not supported on this platform");
+    }
+    if (!_keyboard.isValid()) {
+        QSKIP("no X display with the XTest extension");
+    }
+    _hotkey = std::make_unique<QHotkey>(QKeySequence(QStringLiteral("Ctrl+Alt+F10")), true);
+    QVERIFY(_hotkey->isRegistered());
+    connect(_hotkey.get(), &QHotkey::activated, this, [this] { ++_activations; });
+    connect(_hotkey.get(), &QHotkey::released, this, [this] {
+        ++_releases;
+        _released = nowNanoseconds();
+    });
+    qInfo("detectable auto-repeat %s", detectableAutoRepeat() ? "on" : "off, releases go through the timer");
+}
+
+void BenchHotkeyRelease::cleanupTestCase()
+{
+    _hotkey.reset();
+}
+
+void BenchHotkeyRelease::pressToRelease()
+{
+    std::vector<qint64> latencies;
+    for (int i = 0; i < pressCount; ++i) {
+        _activations = _releases = 0;
+        _keyboard.press({ XK_Control_L, XK_Alt_L, XK_F10 });
+        QVERIFY(processEventsUntil([this] { return _activations > 0; }));
+
+        const qint64 released = nowNanoseconds();
+        _keyboard.release({ XK_Control_L, XK_Alt_L, XK_F10 });
+        QVERIFY(processEventsUntil([this] { return _releases > 0; }));
+        latencies.push_back(_released - released);
+        QCOMPARE(_activations, 1);
+        QCOMPARE(_releases, 1);
+    }
+
+    qInfo("released p50 %lld us, p99 %lld us, max %lld us", percentile(latencies, 50) / 1000,
+        percentile(latencies, 99) / 1000, percentile(latencies, 100) / 1000);
+    QTest::setBenchmarkResult(qreal(percentile(latencies, 50)), QTest::WalltimeNanoseconds);
+    if (detectableAutoRepeat()) {
+        QVERIFY2(percentile(latencies, 50) < 50 * 1000 * 1000, "releases still wait for the auto-repeat timer");
+    } else {
+        QVERIFY(percentile(latencies, 0) >= 50 * 1000 * 1000);
+    }
+}
+
+// Held past the server's repeat delay, the key repeats; either way that must
+// not read as more presses and releases.
+void BenchHotkeyRelease::heldKeyActivatesOnce()
+{
+    _activations = _releases = 0;
+    _keyboard.press({ XK_Control_L, XK_Alt_L, XK_F10 });
+    QVERIFY(processEventsUntil([this] { return _activations > 0; }));
+    QTest::qWait(1000);
+    _keyboard.release({ XK_Control_L, XK_Alt_L, XK_F10 });
+    QVERIFY(processEventsUntil([this] { return _releases > 0; }));
+    QTest::qWait(200);
+    QCOMPARE(_activations, 1);
+    QCOMPARE(_releases, 1);
+}
+
+QTEST_MAIN(BenchHotkeyRelease)
+#include "bench_hotkeyrelease.moc"
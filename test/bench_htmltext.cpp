@@ -0,0 +1,73 @@
+#include <UDHtmlText.h>
+
+#include <QTest>
+#include <QTextDocument>
+
+// Stripping 10000 notification bodies: through QTextDocument, as
+// LingmoTools::html2PlantText() used to, with the streaming converter, and
+// with the converter spread across the thread pool.
+class BenchHtmlText : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void previousDocument();
+    void serial();
+    void batch();
+
+private:
+    QStringList _bodies;
+};
+
+void BenchHtmlText::initTestCase()
+{
+    const QStringList templates = {
+        QStringLiteral("<b>%1</b> sent you a message"),
+        QStringLiteral("<p>Download of <i>%1.iso</i> finished</p><p>3.2&nbsp;GB in 4 min</p>"),
+        QStringLiteral("<html><head><style>b{color:red}</style></head><body><div>Battery at <b>%1%</b>"
+                       "<br>Plug in your charger &mdash; about 12 minutes left</div></body></html>"),
+        QStringLiteral("<ul><li>%1 new mails</li><li>2 meetings &amp; a reminder</li></ul>"
+                       "<a href=\"https://mail.example.com/?id=%1&view=1\">Open</a>"),
+    };
+    for (int i = 0; i < 10000; ++i) {
+        _bodies << templates[i % templates.size()].arg(i);
+    }
+}
+
+void BenchHtmlText::previousDocument()
+{
+    QStringList texts;
+    QBENCHMARK {
+        texts.clear();
+        for (const QString& body : std::as_const(_bodies)) {
+            QTextDocument document;
+            document.setHtml(body);
+            texts << document.toPlainText();
+        }
+    }
+    QCOMPARE(texts.size(), _bodies.size());
+}
+
+void BenchHtmlText::serial()
+{
+    QStringList texts;
+    QBENCHMARK {
+        texts.clear();
+        for (const QString& body : std::as_const(_bodies)) {
+            texts << htmlToPlainText(body);
+        }
+    }
+    QCOMPARE(texts.size(), _bodies.size());
+}
+
+void BenchHtmlText::batch()
+{
+    QStringList texts;
+    QBENCHMARK {
+        texts = htmlToPlainTexts(_bodies);
+    }
+    QCOMPARE(texts.size(), _bodies.size());
+}
+
+QTEST_MAIN(BenchHtmlText)
+#include "bench_htmltext.moc"
@@ -0,0 +1,74 @@
+#include "testimages.h"
+
+#include <UDImageColor.h>
+
+#include <QTest>
+
+// imageMainColor before and after the scanline engine, on wallpaper sizes.
+class BenchImageColor : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void previousMainColor_data();
+    void previousMainColor();
+    void mainColor_data();
+    void mainColor();
+    void everyPixel_data();
+    void everyPixel();
+};
+
+void BenchImageColor::previousMainColor_data()
+{
+    QTest::addColumn<QImage>("image");
+
+    QTest::newRow("1080p") << noiseImage(1920, 1080, QImage::Format_RGB32, 1);
+    QTest::newRow("4k") << noiseImage(3840, 2160, QImage::Format_RGB32, 2);
+    QTest::newRow("8k") << noiseImage(7680, 4320, QImage::Format_RGB32, 3);
+}
+
+void BenchImageColor::previousMainColor()
+{
+    QFETCH(QImage, image);
+
+    QColor color;
+    QBENCHMARK {
+        color = ::previousMainColor(image, 1);
+    }
+    QVERIFY(color.isValid());
+}
+
+void BenchImageColor::mainColor_data()
+{
+    previousMainColor_data();
+}
+
+void BenchImageColor::mainColor()
+{
+    QFETCH(QImage, image);
+
+    QColor color;
+    QBENCHMARK {
+        color = averageImageColor(image, mainColorStep);
+    }
+    QCOMPARE(color, ::previousMainColor(image, 1));
+}
+
+void BenchImageColor::everyPixel_data()
+{
+    previousMainColor_data();
+}
+
+// Every pixel instead of the 20px grid: bandwidth bound, split across threads.
+void BenchImageColor::everyPixel()
+{
+    QFETCH(QImage, image);
+
+    ImageColorSums sums;
+    QBENCHMARK {
+        sums = accumulateImageColor(image, 1);
+    }
+    QCOMPARE(sums.count, quint64(image.width()) * quint64(image.height()));
+}
+
+QTEST_GUILESS_MAIN(BenchImageColor)
+#include "bench_imagecolor.moc"
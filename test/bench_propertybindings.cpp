@@ -0,0 +1,150 @@
+#include <stdafx.h>
+
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQmlEngine>
+#include <QTest>
+
+// A panel-like object with the same int property declared three ways.
+// Bindings in QML call evaluated() so re-evaluations can be counted.
+class Panel : public QObject {
+    Q_OBJECT
+    Q_PROPERTY_AUTO(int, plain)
+    Q_PROPERTY_AUTO_DISTINCT(int, distinct)
+    Q_PROPERTY_BINDABLE_AUTO(Panel, int, bindable)
+
+public:
+    Panel()
+    {
+        _plain = 0;
+        _distinct = 0;
+    }
+
+    // The C++ setters, not QMetaProperty::write(): moc's MEMBER write
+    // already compares, and QML panels are updated from C++.
+    void write(const QByteArray& name, int value)
+    {
+        if (name == "plain") {
+            plain(value);
+        } else if (name == "distinct") {
+            distinct(value);
+        } else {
+            bindable(value);
+        }
+    }
+
+    Q_INVOKABLE void evaluated()
+    {
+        ++evaluations;
+    }
+
+    int evaluations = 0;
+};
+
+// Each row writes a property 1000 times with 100 QML bindings depending on
+// it, either always with the value it already has ("same") or with a new
+// one each time ("new"). reevaluations reports how many times the bindings
+// ran as the benchmark result; writes times the same loop.
+class BenchPropertyBindings : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void reevaluations_data();
+    void reevaluations();
+    void writes_data();
+    void writes();
+
+private:
+    QObject* createDependents(QQmlEngine* engine, Panel* panel, const QByteArray& property);
+};
+
+static constexpr int writeCount = 1000;
+static constexpr int dependentCount = 100;
+
+QObject* BenchPropertyBindings::createDependents(QQmlEngine* engine, Panel* panel, const QByteArray& property)
+{
+    QByteArray qml = "import QtQml\nQtObject {\n";
+    for (int i = 0; i < dependentCount; ++i) {
+        qml += "    property int d" + QByteArray::number(i) + ": { panel.evaluated(); return panel." + property + " + "
+            + QByteArray::number(i) + " }\n";
+    }
+    qml += "}\n";
+
+    engine->rootContext()->setContextProperty(QStringLiteral("panel"), panel);
+    QQmlComponent component(engine);
+    component.setData(qml, QUrl());
+    QObject* object = component.create();
+    if (!object) {
+        qWarning().noquote() << component.errorString();
+    }
+    return object;
+}
+
+void BenchPropertyBindings::reevaluations_data()
+{
+    QTest::addColumn<QByteArray>("property");
+    QTest::addColumn<bool>("changing");
+
+    for (const char* property : { "plain", "distinct", "bindable" }) {
+        QTest::addRow("%s-same", property) << QByteArray(property) << false;
+        QTest::addRow("%s-new", property) << QByteArray(property) << true;
+    }
+}
+
+void BenchPropertyBindings::reevaluations()
+{
+    QFETCH(QByteArray, property);
+    QFETCH(bool, changing);
+
+    QQmlEngine engine;
+    Panel panel;
+    QScopedPointer<QObject> dependents(createDependents(&engine, &panel, property));
+    QVERIFY(dependents);
+    QCOMPARE(panel.evaluations, dependentCount);
+
+    panel.evaluations = 0;
+    for (int i = 1; i <= writeCount; ++i) {
+        panel.write(property, changing ? i : 0);
+    }
+    QCOMPARE(dependents->property("d7").toInt(), (changing ? writeCount : 0) + 7);
+    QTest::setBenchmarkResult(panel.evaluations, QTest::Events);
+
+    if (!changing) {
+        QCOMPARE(panel.evaluations, property == "plain" ? writeCount * dependentCount : 0);
+    } else if (property == "bindable") {
+        // Bound dependents may be evaluated lazily, so never more often.
+        QVERIFY(panel.evaluations <= writeCount * dependentCount);
+    } else {
+        QCOMPARE(panel.evaluations, writeCount * dependentCount);
+    }
+}
+
+void BenchPropertyBindings::writes_data()
+{
+    reevaluations_data();
+}
+
+void BenchPropertyBindings::writes()
+{
+    QFETCH(QByteArray, property);
+    QFETCH(bool, changing);
+
+    QQmlEngine engine;
+    Panel panel;
+    QScopedPointer<QObject> dependents(createDependents(&engine, &panel, property));
+    QVERIFY(dependents);
+
+    int value = 0;
+    QBENCHMARK {
+        for (int i = 0; i < writeCount; ++i) {
+            if (changing) {
+                ++value;
+            }
+            panel.write(property, value);
+        }
+    }
+    QCOMPARE(dependents->property("d7").toInt(), value + 7);
+}
+
+QTEST_GUILESS_MAIN(BenchPropertyBindings)
+#include "bench_propertybindings.moc"
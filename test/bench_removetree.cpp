@@ -0,0 +1,84 @@
+#include <UDParallel.h>
+#include <UDRemoveTree.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <atomic>
+
+// Removing a cache-like tree of 500k files (100 x 50 directories of 100 files
+// each) with QDir::removeRecursively(), as LingmoTools::removeDir() used to,
+// and with removeTree(). The tree lives under $TMPDIR; point that at a real
+// disk rather than tmpfs to include the filesystem's own cost.
+class BenchRemoveTree : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+    void removeRecursively();
+    void removeTree();
+
+private:
+    QTemporaryDir* _dir = nullptr;
+    QString _root;
+};
+
+void BenchRemoveTree::init()
+{
+    _dir = new QTemporaryDir;
+    QVERIFY(_dir->isValid());
+    _root = _dir->filePath(QStringLiteral("cache"));
+    QVERIFY(QDir().mkdir(_root));
+
+    // Generating the tree serially would take longer than removing it.
+    std::atomic<int> created { 0 };
+    parallelFor(100, [&](int top) {
+        const QString topDir = QStringLiteral("%1/%2").arg(_root).arg(top);
+        QDir().mkdir(topDir);
+        for (int sub = 0; sub < 50; ++sub) {
+            const QString dir = QStringLiteral("%1/%2").arg(topDir).arg(sub);
+            QDir().mkdir(dir);
+            for (int file = 0; file < 100; ++file) {
+                QFile entry(QStringLiteral("%1/%2.cache").arg(dir).arg(file));
+                if (entry.open(QIODevice::WriteOnly)) {
+                    entry.write("cached");
+                    ++created;
+                }
+            }
+        }
+    });
+    QCOMPARE(created.load(), 500000);
+}
+
+void BenchRemoveTree::cleanup()
+{
+    delete _dir;
+    _dir = nullptr;
+}
+
+void BenchRemoveTree::removeRecursively()
+{
+    bool ok = false;
+    QBENCHMARK_ONCE {
+        ok = QDir(_root).removeRecursively();
+    }
+    QVERIFY(ok);
+}
+
+void BenchRemoveTree::removeTree()
+{
+    RemoveTreeState state;
+    bool ok = false;
+    QBENCHMARK_ONCE {
+        ok = ::removeTree(_root, state);
+    }
+    QVERIFY(ok);
+    // The files, 5100 directories and the root.
+    QCOMPARE(state.removed.load(), qint64(505101));
+}
+
+QTEST_GUILESS_MAIN(BenchRemoveTree)
+#include "bench_removetree.moc"
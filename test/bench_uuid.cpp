@@ -0,0 +1,65 @@
+#include <UDUuid.h>
+
+#include <QTest>
+#include <QUuid>
+
+// 10000 IDs per iteration, so IDs per second is 10000 over the time reported:
+// LingmoTools::uuid() as it was (QUuid, braces and dashes removed), one
+// uuidHex() call per ID, and a single uuidHexes() batch.
+class BenchUuid : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void previousUuid();
+    void uuidHex();
+    void uuidHexes();
+    void uuidBytes();
+};
+
+static constexpr int idCount = 10000;
+
+void BenchUuid::previousUuid()
+{
+    QStringList ids;
+    QBENCHMARK {
+        ids.clear();
+        for (int i = 0; i < idCount; ++i) {
+            ids << QUuid::createUuid().toString().remove(QLatin1Char('-')).remove(QLatin1Char('{')).remove(QLatin1Char('}'));
+        }
+    }
+    QCOMPARE(ids.last().size(), qsizetype(32));
+}
+
+void BenchUuid::uuidHex()
+{
+    QStringList ids;
+    QBENCHMARK {
+        ids.clear();
+        for (int i = 0; i < idCount; ++i) {
+            ids << ::uuidHex();
+        }
+    }
+    QCOMPARE(ids.last().size(), qsizetype(32));
+}
+
+void BenchUuid::uuidHexes()
+{
+    QStringList ids;
+    QBENCHMARK {
+        ids = ::uuidHexes(idCount);
+    }
+    QCOMPARE(ids.size(), qsizetype(idCount));
+}
+
+// Raw bytes, what Python's uuids(n, raw=True) starts from.
+void BenchUuid::uuidBytes()
+{
+    QByteArray bytes;
+    QBENCHMARK {
+        bytes = ::uuidBytes(idCount);
+    }
+    QCOMPARE(bytes.size(), qsizetype(idCount) * 16);
+}
+
+QTEST_GUILESS_MAIN(BenchUuid)
+#include "bench_uuid.moc"
@@ -0,0 +1,123 @@
+import importlib.util
+import subprocess
+import sys
+import sysconfig
+import threading
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+free_threaded_only = pytest.mark.skipif(
+    not sysconfig.get_config_var("Py_GIL_DISABLED"), reason="needs a free-threaded (3.13t) interpreter"
+)
+
+THREADS = 16
+DATA = bytes((i * 131 + 7) & 0xFF for i in range(1 << 18))
+HTML = "<p>Hello <b>world</b> &amp; <i>everyone</i></p><br>second line"
+
+
+# A module without py::mod_gil_not_used() switches the GIL back on when it
+# is imported.
+@free_threaded_only
+@pytest.mark.parametrize(
+    "module",
+    [
+        "UDFrameless",
+        pytest.param(
+            "UDHotkey",
+            marks=pytest.mark.skipif(
+                importlib.util.find_spec("UniDeskCppExt.UDHotkey") is None, reason="built without global hotkeys"
+            ),
+        ),
+        "UDTools",
+    ],
+)
+def test_import_keeps_gil_disabled(module):
+    code = f"import sys, UniDeskCppExt.{module}; print(sys._is_gil_enabled())"
+    result = subprocess.run([sys.executable, "-c", code], capture_output=True, text=True, check=True)
+    assert result.stdout.strip() == "False"
+
+
+# Run body(index) on THREADS threads released together, re-raising the
+# first exception any of them hit.
+def run_together(body):
+    barrier = threading.Barrier(THREADS)
+    errors = []
+
+    def run(index):
+        barrier.wait()
+        try:
+            body(index)
+        except BaseException as error:  # noqa: BLE001
+            errors.append(error)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(THREADS)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    if errors:
+        raise errors[0]
+
+
+# Everything at once, each thread starting on a different call; the results
+# have to match a single-threaded run.
+def test_mixed_calls():
+    calls = [
+        lambda: UDTools.hashBytes(DATA, "sha256"),
+        lambda: UDTools.hashBytes(DATA, "xxh3"),
+        lambda: UDTools.htmlToText(HTML),
+        lambda: UDTools.htmlToTexts([HTML] * 50),
+        lambda: UDTools.platformInfo(),
+        lambda: len(UDTools.uuids(100)),
+    ]
+    results = [[None] * len(calls) for _ in range(THREADS)]
+
+    def body(index):
+        for step in range(len(calls) * 20):
+            call = (index + step) % len(calls)
+            results[index][call] = calls[call]()
+
+    run_together(body)
+    expected = [call() for call in calls]
+    assert results == [expected] * THREADS
+
+
+def test_uuids_unique_across_threads():
+    results = [None] * THREADS
+    run_together(lambda index: results.__setitem__(index, UDTools.uuids(5000)))
+    assert len({value for result in results for value in result}) == THREADS * 5000
+
+
+def test_shared_image():
+    np = pytest.importorskip("numpy")
+    pixels = np.random.default_rng(3).integers(0, 256, (480, 640, 4), dtype=np.uint8)
+    expected = (UDTools.imageAverageColor(pixels), UDTools.imageMainColor(pixels), UDTools.imagePalette(pixels))
+    results = [None] * THREADS
+
+    def body(index):
+        for _ in range(10):
+            results[index] = (
+                UDTools.imageAverageColor(pixels),
+                UDTools.imageMainColor(pixels),
+                UDTools.imagePalette(pixels),
+            )
+
+    run_together(body)
+    assert results == [expected] * THREADS
+
+
+def test_remove_trees(tmp_path):
+    roots = []
+    for index in range(THREADS):
+        root = tmp_path / str(index)
+        for directory in range(10):
+            (root / str(directory)).mkdir(parents=True)
+            for name in range(20):
+                (root / str(directory) / str(name)).write_bytes(b"x")
+        roots.append(root)
+    results = [None] * THREADS
+    run_together(lambda index: results.__setitem__(index, UDTools.removeTree(str(roots[index]))))
+    assert results == [True] * THREADS
+    assert not any(root.exists() for root in roots)
@@ -0,0 +1,56 @@
+import hashlib
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+DATA = bytes((i * 31 + 7) & 0xFF for i in range((1 << 20) + 17))
+
+
+@pytest.mark.parametrize("algorithm", ["md5", "sha256"])
+def test_bytes_match_hashlib(algorithm):
+    expected = hashlib.new(algorithm, DATA).hexdigest()
+    assert UDTools.hashBytes(DATA, algorithm) == expected
+    assert UDTools.hashBytes(bytearray(DATA), algorithm) == expected
+    assert UDTools.hashBytes(memoryview(DATA)[:1000], algorithm) == hashlib.new(algorithm, DATA[:1000]).hexdigest()
+
+
+def test_xxh3_matches_xxhash():
+    xxhash = pytest.importorskip("xxhash")
+    assert UDTools.hashBytes(DATA, "xxh3") == xxhash.xxh3_64_hexdigest(DATA)
+    assert UDTools.hashBytes(b"", "XXH3") == "2d06800538d394c2"
+
+
+def test_blake3_matches_reference():
+    blake3 = pytest.importorskip("blake3")
+    assert UDTools.hashBytes(DATA, "blake3") == blake3.blake3(DATA).hexdigest()
+
+
+def test_non_contiguous_buffer_is_rejected():
+    with pytest.raises(ValueError, match="C-contiguous"):
+        UDTools.hashBytes(memoryview(DATA)[::2], "md5")
+
+
+def test_unknown_algorithm():
+    with pytest.raises(ValueError, match="unknown hash algorithm"):
+        UDTools.hashBytes(b"", "crc32")
+
+
+def test_file_matches_bytes(tmp_path):
+    path = tmp_path / "data"
+    path.write_bytes(DATA)
+    for algorithm in ["md5", "sha256", "xxh3", "blake3"]:
+        assert UDTools.hashFile(str(path), algorithm) == UDTools.hashBytes(DATA, algorithm)
+
+
+def test_batch_keeps_order(tmp_path):
+    paths = []
+    for i in range(32):
+        path = tmp_path / str(i)
+        path.write_bytes(DATA[: i * 1021])
+        paths.append(str(path))
+    paths.append(str(tmp_path / "missing"))
+
+    digests = UDTools.hashFiles(paths, "sha256")
+    assert digests[:-1] == [hashlib.sha256(DATA[: i * 1021]).hexdigest() for i in range(32)]
+    assert digests[-1] == ""
@@ -0,0 +1,192 @@
+import os
+import sys
+import threading
+import time
+
+import pytest
+
+# Not built without QHotkey's dependencies (UNIDESK_HOTKEY=OFF).
+UDHotkey = pytest.importorskip("UniDeskCppExt.UDHotkey")
+
+# These need an X server (run under xvfb-run), a Qt application object from
+# PySide6 and python-xlib to type on the server through XTest.
+if not os.environ.get("DISPLAY"):
+    pytest.skip("needs an X display", allow_module_level=True)
+QtGui = pytest.importorskip("PySide6.QtGui")
+xlib_display = pytest.importorskip("Xlib.display")
+from Xlib import XK, X  # noqa: E402
+from Xlib.ext import xtest  # noqa: E402
+
+SHORTCUT = "Ctrl+Alt+F9"
+KEYS = ["Control_L", "Alt_L", "F9"]
+
+
+@pytest.fixture(scope="module")
+def app():
+    application = QtGui.QGuiApplication.instance() or QtGui.QGuiApplication([])
+    if application.platformName() != "xcb" or not UDHotkey.isSupported():
+        pytest.skip("global hotkeys need the xcb platform plugin")
+    return application
+
+
+@pytest.fixture(scope="module")
+def keyboard():
+    display = xlib_display.Display()
+    if not display.has_extension("XTEST"):
+        pytest.skip("the X server has no XTest extension")
+    codes = [display.keysym_to_keycode(XK.string_to_keysym(key)) for key in KEYS]
+
+    class Keyboard:
+        def press(self):
+            for code in codes:
+                xtest.fake_input(display, X.KeyPress, code)
+            display.sync()
+
+        def release(self):
+            for code in reversed(codes):
+                xtest.fake_input(display, X.KeyRelease, code)
+            display.sync()
+
+    yield Keyboard()
+    display.close()
+
+
+@pytest.fixture
+def hotkey(app):
+    ids = []
+
+    def register(activated=None, released=None):
+        ids.append(UDHotkey.register(SHORTCUT, activated, released))
+        return ids[-1]
+
+    yield register
+    UDHotkey.stop()
+    for hotkey_id in ids:
+        UDHotkey.unregister(hotkey_id)
+    UDHotkey.poll()
+
+
+def pump(app, done, timeout=2.0):
+    deadline = time.monotonic() + timeout
+    while not done():
+        if time.monotonic() > deadline:
+            return False
+        app.processEvents()
+        time.sleep(0.001)
+    return True
+
+
+def test_invalid_shortcut(app):
+    with pytest.raises(ValueError):
+        UDHotkey.register("")
+
+
+def test_unregister(app):
+    hotkey_id = UDHotkey.register(SHORTCUT)
+    assert UDHotkey.unregister(hotkey_id)
+    assert not UDHotkey.unregister(hotkey_id)
+
+
+def test_poll(app, keyboard, hotkey):
+    hotkey_id = hotkey()
+    start = time.monotonic_ns()
+    events = []
+    for presses in range(1, 4):
+        keyboard.press()
+        keyboard.release()
+        assert pump(app, lambda: events.extend(UDHotkey.poll()) or len(events) >= 2 * presses)
+
+    assert [(event_id, kind) for event_id, kind, _ in events] == [
+        (hotkey_id, UDHotkey.ACTIVATED),
+        (hotkey_id, UDHotkey.RELEASED),
+    ] * 3
+    timestamps = [timestamp for _, _, timestamp in events]
+    assert timestamps == sorted(timestamps)
+    assert start <= timestamps[0] and timestamps[-1] <= time.monotonic_ns()
+
+
+def test_wait_from_another_thread(app, keyboard, hotkey):
+    hotkey_id = hotkey()
+    result = []
+    waiter = threading.Thread(target=lambda: result.extend(UDHotkey.wait(5.0)))
+    waiter.start()
+    keyboard.press()
+    assert pump(app, lambda: not waiter.is_alive(), timeout=5.0)
+    assert result[0][:2] == (hotkey_id, UDHotkey.ACTIVATED)
+    # Let the release through before the next test registers the shortcut.
+    keyboard.release()
+    assert pump(app, lambda: (hotkey_id, UDHotkey.RELEASED) in [event[:2] for event in UDHotkey.poll()])
+
+
+def test_start_delivers_batches_and_callbacks(app, keyboard, hotkey):
+    calls = []
+    batches = []
+    hotkey_id = hotkey(lambda: calls.append("activated"), lambda: calls.append("released"))
+    UDHotkey.start(batches.append)
+    with pytest.raises(RuntimeError):
+        UDHotkey.poll()
+
+    for _ in range(2):
+        keyboard.press()
+        keyboard.release()
+        assert pump(app, lambda: calls[-1:] == ["released"])
+        calls.append("-")
+    UDHotkey.stop()
+
+    assert calls == ["activated", "released", "-"] * 2
+    events = [event for batch in batches for event in batch]
+    assert [(event_id, kind) for event_id, kind, _ in events] == [
+        (hotkey_id, UDHotkey.ACTIVATED),
+        (hotkey_id, UDHotkey.RELEASED),
+    ] * 2
+    assert UDHotkey.poll() == []
+
+
+# The callback runs on the dispatcher thread, which stop() then cannot join;
+# it has to stop it all the same, and start() has to work again afterwards.
+def test_stop_from_callback(app, keyboard, hotkey, monkeypatch):
+    reported = []
+    monkeypatch.setattr(sys, "unraisablehook", reported.append)
+    calls = []
+
+    def activated():
+        calls.append("activated")
+        if calls.count("activated") == 1:
+            UDHotkey.stop()
+
+    hotkey(activated, lambda: calls.append("released"))
+    UDHotkey.start()
+    keyboard.press()
+    assert pump(app, lambda: calls == ["activated"])
+    keyboard.release()
+    # Queued while stopped, delivered once dispatching starts again.
+    pump(app, lambda: False, timeout=0.2)
+    assert calls == ["activated"]
+    UDHotkey.start()
+    assert pump(app, lambda: calls[-1:] == ["released"])
+    keyboard.press()
+    keyboard.release()
+    assert pump(app, lambda: calls == ["activated", "released"] * 2)
+    UDHotkey.stop()
+
+    assert reported == []
+
+
+# A callback that raises is reported and does not stop the ones after it.
+def test_callback_exception(app, keyboard, hotkey, monkeypatch):
+    reported = []
+    monkeypatch.setattr(sys, "unraisablehook", reported.append)
+    released = []
+
+    def fail():
+        raise RuntimeError("from the callback")
+
+    hotkey(fail, lambda: released.append(True))
+    UDHotkey.start()
+    keyboard.press()
+    keyboard.release()
+    assert pump(app, lambda: released)
+    UDHotkey.stop()
+
+    assert len(reported) == 1
+    assert isinstance(reported[0].exc_value, RuntimeError)
@@ -0,0 +1,39 @@
+from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+
+@pytest.mark.parametrize(
+    ("html", "text"),
+    [
+        ("<b>Build</b> finished in <i>3 min</i>", "Build finished in 3 min"),
+        ("Tom &amp; Jerry &lt;3", "Tom & Jerry <3"),
+        ("caf&#233; &#128512; &euro;&nbsp;5", "café \U0001F600 € 5"),
+        ("<p>first</p><p>second</p>", "first\nsecond"),
+        ("line one<br>line two", "line one\nline two"),
+        ("<pre>keep   this\n  layout</pre>after", "keep   this\n  layout\nafter"),
+        ("before<script>var a = '<p>x</p>';</script>after", "beforeafter"),
+        ("<style>p{color:red}</style><p>shown</p>", "shown"),
+        ("", ""),
+    ],
+)
+def test_html_to_text(html, text):
+    assert UDTools.htmlToText(html) == text
+
+
+def test_batch_keeps_order():
+    htmls = [f"<p>Message <b>{i}</b></p><p>from &lt;user{i % 7}&gt;</p>" for i in range(2000)]
+    texts = UDTools.htmlToTexts(htmls)
+    assert texts == [UDTools.htmlToText(html) for html in htmls]
+    assert texts[42] == "Message 42\nfrom <user0>"
+
+
+def test_threads_agree():
+    # Both calls release the GIL, so these really run at the same time.
+    htmls = [f"<div>caf&eacute; {i}<br>&#128512;</div><script>x</script>" for i in range(500)]
+    expected = [UDTools.htmlToText(html) for html in htmls]
+    with ThreadPoolExecutor(8) as pool:
+        assert list(pool.map(UDTools.htmlToText, htmls)) == expected
+        assert all(result == expected for result in pool.map(lambda _: UDTools.htmlToTexts(htmls), range(8)))
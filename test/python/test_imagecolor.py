@@ -0,0 +1,148 @@
+from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+np = pytest.importorskip("numpy")
+
+
+def noise(height, width, channels, seed):
+    return np.random.default_rng(seed).integers(0, 256, (height, width, channels), dtype=np.uint8)
+
+
+# What UDImageColor computes: the truncated mean of every step-th pixel in both
+# directions, scaled by bright and clamped.
+def numpy_average(pixels, step=1, bright=1.0):
+    sampled = pixels[::step, ::step, :3].reshape(-1, 3)
+    if len(sampled) == 0:
+        return None
+    sums = sampled.sum(axis=0, dtype=np.uint64)
+    return tuple(min(max(int(bright * float(s) / len(sampled)), 0), 255) for s in sums)
+
+
+def write_ppm(path, pixels):
+    height, width, _ = pixels.shape
+    path.write_bytes(b"P6 %d %d 255\n" % (width, height) + np.ascontiguousarray(pixels[..., :3]).tobytes())
+
+
+@pytest.mark.parametrize("channels", [3, 4])
+@pytest.mark.parametrize(("height", "width"), [(1, 1), (7, 13), (480, 640), (1080, 1920)])
+@pytest.mark.parametrize("step", [1, 3, 20])
+def test_average_matches_numpy(channels, height, width, step):
+    pixels = noise(height, width, channels, height * width + channels)
+    assert UDTools.imageAverageColor(pixels, step) == numpy_average(pixels, step)
+
+
+@pytest.mark.parametrize("channels", [3, 4])
+def test_main_color_matches_numpy(channels):
+    pixels = noise(1080, 1920, channels, 7)
+    assert UDTools.imageMainColor(pixels) == numpy_average(pixels, 20)
+    assert UDTools.imageMainColor(pixels, 1.5) == numpy_average(pixels, 20, 1.5)
+
+
+def test_bright_clamps():
+    pixels = np.full((4, 4, 3), 200, dtype=np.uint8)
+    assert UDTools.imageAverageColor(pixels, bright=2.0) == (255, 255, 255)
+    assert UDTools.imageAverageColor(pixels, bright=0.5) == (100, 100, 100)
+
+
+def test_alpha_is_ignored():
+    pixels = noise(64, 64, 4, 3)
+    opaque = pixels.copy()
+    opaque[..., 3] = 255
+    assert UDTools.imageAverageColor(pixels) == UDTools.imageAverageColor(opaque)
+    assert UDTools.imageAverageColor(pixels) == UDTools.imageAverageColor(np.ascontiguousarray(pixels[..., :3]))
+
+
+# Rows may be padded: a column slice keeps packed pixels but lengthens the stride.
+def test_padded_rows():
+    pixels = noise(300, 401, 4, 5)
+    view = pixels[:, :399]
+    assert not view.flags.c_contiguous
+    assert UDTools.imageAverageColor(view, 2) == numpy_average(np.ascontiguousarray(view), 2)
+    assert UDTools.imagePalette(view) == UDTools.imagePalette(np.ascontiguousarray(view))
+
+
+# Nothing is copied, so a read-only array is as good as a writable one.
+def test_read_only_and_memoryview():
+    pixels = noise(120, 160, 3, 9)
+    expected = numpy_average(pixels, 4)
+    pixels.flags.writeable = False
+    assert UDTools.imageAverageColor(pixels, 4) == expected
+    assert UDTools.imageAverageColor(memoryview(pixels), 4) == expected
+
+
+def test_pillow_image():
+    image_module = pytest.importorskip("PIL.Image")
+    pixels = noise(90, 70, 4, 11)
+    image = image_module.fromarray(pixels, "RGBA")
+    assert UDTools.imageAverageColor(np.asarray(image)) == numpy_average(pixels)
+
+
+@pytest.mark.parametrize("shape", [(0, 10, 3), (10, 0, 4)])
+def test_empty(shape):
+    pixels = np.zeros(shape, dtype=np.uint8)
+    assert UDTools.imageAverageColor(pixels) is None
+    assert UDTools.imageMainColor(pixels) is None
+    assert UDTools.imagePalette(pixels) == []
+
+
+@pytest.mark.parametrize(
+    "pixels",
+    [
+        np.zeros((10, 10, 3), dtype=np.float32),
+        np.zeros((10, 10, 3), dtype=np.uint16),
+        np.zeros((10, 10), dtype=np.uint8),
+        np.zeros((10, 10, 2), dtype=np.uint8),
+        np.zeros((10, 10, 1, 3), dtype=np.uint8),
+    ],
+    ids=["float32", "uint16", "2d", "2-channels", "4d"],
+)
+def test_wrong_type_or_shape(pixels):
+    with pytest.raises(ValueError, match="uint8 buffer of shape"):
+        UDTools.imageAverageColor(pixels)
+    with pytest.raises(ValueError, match="uint8 buffer of shape"):
+        UDTools.imagePalette(pixels)
+
+
+@pytest.mark.parametrize(
+    "view",
+    [lambda a: a[:, ::2], lambda a: a[::-1], lambda a: a.transpose(1, 0, 2), lambda a: np.asfortranarray(a)],
+    ids=["column-stride", "reversed-rows", "transposed", "fortran"],
+)
+def test_non_contiguous(view):
+    pixels = view(noise(40, 40, 3, 1))
+    with pytest.raises(ValueError, match="C-contiguous"):
+        UDTools.imageAverageColor(pixels)
+
+
+def test_palette_matches_file(tmp_path):
+    pixels = noise(200, 300, 3, 4)
+    pixels[:100] = (200, 30, 30)
+    pixels[100:150] = (20, 60, 220)
+    path = tmp_path / "image.ppm"
+    write_ppm(path, pixels)
+    assert UDTools.imagePalette(pixels, 4) == UDTools.imagePalette(str(path), 4)
+
+
+def test_palette_weights():
+    pixels = np.zeros((100, 100, 3), dtype=np.uint8)
+    pixels[:75] = (250, 250, 250)
+    pixels[75:] = (0, 0, 250)
+    palette = UDTools.imagePalette(pixels, 5)
+    assert 1 <= len(palette) <= 5
+    assert sum(weight for _, weight in palette) == pytest.approx(1.0)
+    (first, first_weight), (second, second_weight) = palette[:2]
+    assert all(abs(a - b) <= 8 for a, b in zip(first, (250, 250, 250)))
+    assert all(abs(a - b) <= 8 for a, b in zip(second, (0, 0, 250)))
+    assert first_weight == pytest.approx(0.75, abs=0.02)
+    assert second_weight == pytest.approx(0.25, abs=0.02)
+
+
+# The GIL is released during the computation; threads still see right answers.
+def test_concurrent_calls():
+    images = [noise(540, 960, 3 + i % 2, i) for i in range(8)]
+    with ThreadPoolExecutor(4) as pool:
+        results = list(pool.map(lambda pixels: UDTools.imageAverageColor(pixels, 2), images))
+    assert results == [numpy_average(pixels, 2) for pixels in images]
@@ -0,0 +1,46 @@
+import pytest
+
+from UniDeskCppExt import UDTools
+
+np = pytest.importorskip("numpy")
+pytest.importorskip("pytest_benchmark")
+
+# A 4k RGBA frame, the size of the wallpapers these are run on.
+PIXELS = np.random.default_rng(1).integers(0, 256, (2160, 3840, 4), dtype=np.uint8)
+
+
+def numpy_average(pixels, step):
+    sampled = pixels[::step, ::step, :3].reshape(-1, 3)
+    sums = sampled.sum(axis=0, dtype=np.uint64)
+    return tuple(min(int(float(s) / len(sampled)), 255) for s in sums)
+
+
+# The usual numpy stand-in for a palette: the most common 5-bit colors.
+def numpy_palette(pixels, count):
+    quantized = pixels[..., :3].reshape(-1, 3) >> 3
+    keys = (quantized[:, 0].astype(np.int32) << 10) | (quantized[:, 1].astype(np.int32) << 5) | quantized[:, 2]
+    histogram = np.bincount(keys, minlength=1 << 15)
+    top = np.argsort(histogram)[::-1][:count]
+    return [(((k >> 10) << 3, ((k >> 5) & 31) << 3, (k & 31) << 3), histogram[k] / len(keys)) for k in top]
+
+
+@pytest.mark.parametrize("step", [1, 20])
+def test_average_numpy(benchmark, step):
+    benchmark.group = f"average step={step}"
+    assert benchmark(numpy_average, PIXELS, step) is not None
+
+
+@pytest.mark.parametrize("step", [1, 20])
+def test_average_native(benchmark, step):
+    benchmark.group = f"average step={step}"
+    assert benchmark(UDTools.imageAverageColor, PIXELS, step) == numpy_average(PIXELS, step)
+
+
+def test_palette_numpy(benchmark):
+    benchmark.group = "palette"
+    assert len(benchmark(numpy_palette, PIXELS, 5)) == 5
+
+
+def test_palette_native(benchmark):
+    benchmark.group = "palette"
+    assert len(benchmark(UDTools.imagePalette, PIXELS, 5)) == 5
@@ -0,0 +1,99 @@
+import ast
+import importlib.util
+import re
+import subprocess
+import sys
+
+import pytest
+
+import UniDeskCppExt
+
+# Microseconds `import UniDeskCppExt` may take in a fresh interpreter. It
+# imports no submodule, so this only grows if something eager sneaks back in.
+PACKAGE_IMPORT_BUDGET_US = 20_000
+
+QT_LIBRARIES = r"""
+import re
+maps = open("/proc/self/maps").read()
+print(sorted(set(re.findall(r"libQt6(\w+)\.so", maps))))
+"""
+
+linux_only = pytest.mark.skipif(not sys.platform.startswith("linux"), reason="reads /proc/self/maps")
+
+# UDHotkey is left out of builds without QHotkey's dependencies.
+HOTKEY = pytest.param(
+    "UDHotkey",
+    marks=pytest.mark.skipif(
+        importlib.util.find_spec("UniDeskCppExt.UDHotkey") is None, reason="built without global hotkeys"
+    ),
+)
+
+
+def run(code, *options):
+    return subprocess.run([sys.executable, *options, "-c", code], capture_output=True, text=True, check=True)
+
+
+def loaded_qt_libraries(imports):
+    return ast.literal_eval(run(imports + "\n" + QT_LIBRARIES).stdout)
+
+
+# Cumulative microseconds per module from -X importtime, best of runs.
+def import_times(statement, runs=3):
+    best = {}
+    for _ in range(runs):
+        stderr = run(statement, "-X", "importtime").stderr
+        for match in re.finditer(r"^import time:\s+\d+ \|\s+(\d+) \|\s+(\S+)\s*$", stderr, re.MULTILINE):
+            cumulative, module = int(match.group(1)), match.group(2)
+            best[module] = min(best.get(module, cumulative), cumulative)
+    return best
+
+
+def test_package_imports_no_submodule():
+    output = run("import sys, UniDeskCppExt; print(sorted(m for m in sys.modules if m.startswith('UniDeskCppExt')))")
+    assert ast.literal_eval(output.stdout) == ["UniDeskCppExt"]
+
+
+@linux_only
+def test_package_loads_no_qt():
+    assert loaded_qt_libraries("import UniDeskCppExt") == []
+
+
+# Each submodule loads only the Qt libraries of the components it links.
+@linux_only
+@pytest.mark.parametrize(
+    ("module", "unwanted"),
+    [
+        ("UDFrameless", {"Gui", "Widgets", "Quick", "Qml", "QuickControls2", "DBus", "Core5Compat"}),
+        pytest.param(
+            "UDHotkey", {"Widgets", "Quick", "Qml", "QuickControls2", "Core5Compat"}, marks=HOTKEY.marks
+        ),
+        ("UDTools", {"Widgets", "QuickControls2", "Core5Compat"}),
+    ],
+)
+def test_submodule_qt_libraries(module, unwanted):
+    loaded = set(loaded_qt_libraries(f"import UniDeskCppExt; UniDeskCppExt.{module}"))
+    assert not loaded & unwanted
+
+
+def test_attribute_access_imports_once():
+    first = UniDeskCppExt.UDTools
+    import UniDeskCppExt.UDTools as imported
+
+    assert UniDeskCppExt.UDTools is first is imported
+    assert "UDHotkey" in dir(UniDeskCppExt)
+    with pytest.raises(AttributeError):
+        UniDeskCppExt.UDNothing  # noqa: B018
+
+
+def test_import_time(record_testsuite_property):
+    times = import_times("import UniDeskCppExt")
+    record_testsuite_property("import_us.UniDeskCppExt", times["UniDeskCppExt"])
+    assert times["UniDeskCppExt"] < PACKAGE_IMPORT_BUDGET_US
+
+
+# Not budgeted, as they mostly measure the dynamic loader; recorded in the
+# JUnit report (--junitxml) so they can be followed over time.
+@pytest.mark.parametrize("module", ["UDFrameless", HOTKEY, "UDTools"])
+def test_submodule_import_time(record_testsuite_property, module):
+    times = import_times(f"import UniDeskCppExt.{module}")
+    record_testsuite_property(f"import_us.{module}", times[f"UniDeskCppExt.{module}"])
@@ -0,0 +1,34 @@
+import os
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+
+def test_regular_file(tmp_path):
+    path = tmp_path / "file"
+    data = bytes((i * 7) & 0xFF for i in range(100000))
+    path.write_bytes(data)
+    view = UDTools.mapFile(str(path))
+    assert view.readonly
+    assert view.tobytes() == data
+    assert len(view.obj) == len(data) and view.obj.path == str(path)
+
+
+# Size 0 could be a pseudo file with content, so it is never mapped.
+def test_empty_file(tmp_path):
+    path = tmp_path / "empty"
+    path.touch()
+    with pytest.raises(ValueError):
+        UDTools.mapFile(str(path))
+
+
+@pytest.mark.skipif(not os.path.exists("/proc/self/status"), reason="needs /proc")
+def test_proc_file():
+    with pytest.raises(ValueError):
+        UDTools.mapFile("/proc/self/status")
+
+
+def test_missing_file(tmp_path):
+    with pytest.raises(ValueError):
+        UDTools.mapFile(str(tmp_path / "missing"))
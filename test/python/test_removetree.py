@@ -0,0 +1,102 @@
+import os
+import time
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+
+def make_tree(root, depth, fanout, files):
+    """Returns the number of entries created below root."""
+    os.mkdir(root)
+    entries = 0
+    for f in range(files):
+        with open(os.path.join(root, f"file-{f}"), "wb") as file:
+            file.write(b"x")
+        entries += 1
+    if depth > 0:
+        for d in range(fanout):
+            entries += 1 + make_tree(os.path.join(root, f"dir-{d}"), depth - 1, fanout, files)
+    return entries
+
+
+def test_removes_tree_and_reports_final_count(tmp_path):
+    root = tmp_path / "tree"
+    entries = make_tree(root, 3, 6, 10)
+
+    reports = []
+    assert UDTools.removeTree(str(root), reports.append) is True
+    assert not root.exists()
+    # Counts only grow; the last report is the total, root included.
+    assert reports == sorted(reports)
+    assert reports[-1] == entries + 1
+
+
+def test_without_callback(tmp_path):
+    root = tmp_path / "tree"
+    make_tree(root, 2, 3, 3)
+    assert UDTools.removeTree(str(root)) is True
+    assert not root.exists()
+
+
+def test_returns_once_removal_ends(tmp_path):
+    # Not after the next 100 ms progress tick.
+    root = tmp_path / "tree"
+    make_tree(root, 1, 2, 2)
+    start = time.perf_counter()
+    assert UDTools.removeTree(str(root), lambda removed: None) is True
+    assert time.perf_counter() - start < 0.05
+    assert not root.exists()
+
+
+def test_symlinks_are_not_followed(tmp_path):
+    outside = tmp_path / "outside"
+    make_tree(outside, 1, 2, 2)
+    root = tmp_path / "tree"
+    root.mkdir()
+    (root / "link-to-dir").symlink_to(outside)
+    (root / "link-to-file").symlink_to(outside / "file-0")
+
+    assert UDTools.removeTree(str(root)) is True
+    assert not root.exists()
+    assert (outside / "dir-1" / "file-1").exists()
+    assert (outside / "file-0").exists()
+
+
+def test_non_directories_are_left_alone(tmp_path):
+    path = tmp_path / "file"
+    path.write_bytes(b"x")
+    assert UDTools.removeTree(str(path)) is True
+    assert path.exists()
+    assert UDTools.removeTree(str(tmp_path / "missing")) is True
+
+
+def test_false_from_callback_cancels(tmp_path):
+    root = tmp_path / "tree"
+    entries = make_tree(root, 2, 10, 100)
+
+    reports = []
+
+    def stop(removed):
+        reports.append(removed)
+        return False
+
+    ok = UDTools.removeTree(str(root), stop)
+    # The callback runs every 100ms; a fast disk may finish first.
+    if ok:
+        assert reports == [entries + 1]
+        assert not root.exists()
+    else:
+        assert root.exists()
+        assert reports[-1] < entries + 1
+
+
+def test_callback_exception_propagates(tmp_path):
+    root = tmp_path / "tree"
+    make_tree(root, 1, 2, 2)
+
+    def fail(removed):
+        raise ZeroDivisionError
+
+    with pytest.raises(ZeroDivisionError):
+        UDTools.removeTree(str(root), fail)
@@ -0,0 +1,46 @@
+import re
+import uuid
+
+import pytest
+
+from UniDeskCppExt import UDTools
+
+HEX = re.compile(r"[0-9a-f]{32}")
+
+
+def test_single():
+    value = UDTools.uuid()
+    assert HEX.fullmatch(value)
+    assert uuid.UUID(hex=value).version == 4
+
+
+def test_hex_batch():
+    values = UDTools.uuids(1000)
+    assert len(values) == 1000
+    for value in values:
+        assert isinstance(value, str)
+        assert HEX.fullmatch(value)
+        parsed = uuid.UUID(hex=value)
+        assert parsed.version == 4
+        assert parsed.variant == uuid.RFC_4122
+
+
+def test_raw_batch():
+    values = UDTools.uuids(1000, raw=True)
+    assert len(values) == 1000
+    for value in values:
+        assert isinstance(value, bytes)
+        parsed = uuid.UUID(bytes=value)
+        assert parsed.version == 4
+        assert parsed.variant == uuid.RFC_4122
+
+
+@pytest.mark.parametrize("count", [0, -3])
+def test_empty(count):
+    assert UDTools.uuids(count) == []
+    assert UDTools.uuids(count, raw=True) == []
+
+
+def test_unique():
+    values = UDTools.uuids(50000) + [UDTools.uuid() for _ in range(50000)]
+    assert len(set(values)) == 100000
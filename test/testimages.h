@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QRandomGenerator>
+
+// Images and reference results shared by the image tests and benchmarks.
+
+// LingmoTools::imageMainColor before the scanline engine replaced it. The
+// engine has to give the same color on every image this could handle.
+inline QColor previousMainColor(const QImage& image, double bright)
+{
+    int step = 20;
+    int t = 0;
+    int r = 0, g = 0, b = 0;
+    for (int i = 0; i < image.width(); i += step) {
+        for (int j = 0; j < image.height(); j += step) {
+            if (image.valid(i, j)) {
+                t++;
+                QColor c = image.pixel(i, j);
+                r += c.red();
+                b += c.blue();
+                g += c.green();
+            }
+        }
+    }
+    return QColor(int(bright * r / t) > 255 ? 255 : int(bright * r / t),
+        int(bright * g / t) > 255 ? 255 : int(bright * g / t),
+        int(bright * b / t) > 255 ? 255 : int(bright * b / t));
+}
+
+// Opaque noise, so every format holds the same colors.
+inline QImage noiseImage(int width, int height, QImage::Format format, quint32 seed)
+{
+    QImage image(width, height, QImage::Format_RGB32);
+    QRandomGenerator random(seed);
+    for (int y = 0; y < height; ++y) {
+        auto* row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            row[x] = 0xff000000u | (random.generate() & 0xffffff);
+        }
+    }
+    return image.convertToFormat(format);
+}
@@ -0,0 +1,175 @@
+#include <UDBase64.h>
+
+#include <QRandomGenerator>
+#include <QTest>
+
+namespace {
+
+QByteArray randomBytes(qsizetype size, quint32 seed)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    QRandomGenerator random(seed);
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] = char(random.generate());
+    }
+    return data;
+}
+
+// Line-wrapped at 76 characters, as MIME writes it.
+QByteArray wrapLines(const QByteArray& text)
+{
+    QByteArray wrapped;
+    for (qsizetype i = 0; i < text.size(); i += 76) {
+        wrapped += text.mid(i, 76);
+        wrapped += "\r\n";
+    }
+    return wrapped;
+}
+
+QByteArray encodeInChunks(const QByteArray& data, int chunk)
+{
+    QByteArray output;
+    Base64Encoder encoder;
+    for (qsizetype i = 0; i < data.size(); i += chunk) {
+        encoder.update(QByteArrayView(data).sliced(i, qMin<qsizetype>(chunk, data.size() - i)), output);
+    }
+    encoder.finish(output);
+    return output;
+}
+
+std::optional<QByteArray> decodeInChunks(const QByteArray& text, int chunk)
+{
+    QByteArray output;
+    Base64Decoder decoder;
+    for (qsizetype i = 0; i < text.size(); i += chunk) {
+        if (!decoder.update(QByteArrayView(text).sliced(i, qMin<qsizetype>(chunk, text.size() - i)), output)) {
+            return std::nullopt;
+        }
+    }
+    if (!decoder.finish(output)) {
+        return std::nullopt;
+    }
+    return output;
+}
+
+} // namespace
+
+class TestBase64 : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void rfc4648_data();
+    void rfc4648();
+    void matchesQt_data();
+    void matchesQt();
+    void chunked_data();
+    void chunked();
+    void whitespaceAndPadding();
+    void malformed_data();
+    void malformed();
+};
+
+void TestBase64::rfc4648_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("text");
+
+    QTest::newRow("empty") << QByteArray() << QByteArray();
+    QTest::newRow("f") << QByteArray("f") << QByteArray("Zg==");
+    QTest::newRow("fo") << QByteArray("fo") << QByteArray("Zm8=");
+    QTest::newRow("foo") << QByteArray("foo") << QByteArray("Zm9v");
+    QTest::newRow("foob") << QByteArray("foob") << QByteArray("Zm9vYg==");
+    QTest::newRow("fooba") << QByteArray("fooba") << QByteArray("Zm9vYmE=");
+    QTest::newRow("foobar") << QByteArray("foobar") << QByteArray("Zm9vYmFy");
+}
+
+void TestBase64::rfc4648()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, text);
+
+    QCOMPARE(base64Encode(data), text);
+    QCOMPARE(base64Decode(text).value_or("failed"), data);
+}
+
+void TestBase64::matchesQt_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    // Every tail length around the 12/24-byte SIMD blocks, then large inputs
+    // that are mostly SIMD.
+    for (int size = 0; size < 100; ++size) {
+        QTest::addRow("%d", size) << randomBytes(size, quint32(size));
+    }
+    QTest::newRow("64KiB+1") << randomBytes((64 << 10) + 1, 1000);
+    QTest::newRow("1MiB+2") << randomBytes((1 << 20) + 2, 1001);
+}
+
+void TestBase64::matchesQt()
+{
+    QFETCH(QByteArray, data);
+
+    const QByteArray text = data.toBase64();
+    QCOMPARE(base64Encode(data), text);
+    QCOMPARE(base64Decode(text).value_or("failed"), data);
+    // Binary survives, which the QString-based fromBase64() could not promise.
+    QCOMPARE(base64Decode(base64Encode(data))->size(), data.size());
+}
+
+void TestBase64::chunked_data()
+{
+    QTest::addColumn<int>("chunk");
+
+    for (int chunk : { 1, 2, 3, 4, 5, 16, 31, 32, 33, 1000 }) {
+        QTest::addRow("%d", chunk) << chunk;
+    }
+}
+
+void TestBase64::chunked()
+{
+    QFETCH(int, chunk);
+
+    const QByteArray data = randomBytes(10007, 7);
+    const QByteArray text = data.toBase64();
+    QCOMPARE(encodeInChunks(data, chunk), text);
+    QCOMPARE(decodeInChunks(text, chunk).value_or("failed"), data);
+    QCOMPARE(decodeInChunks(wrapLines(text), chunk).value_or("failed"), data);
+}
+
+void TestBase64::whitespaceAndPadding()
+{
+    QCOMPARE(base64Decode("Zm9v\nYmFy").value_or("failed"), QByteArray("foobar"));
+    QCOMPARE(base64Decode(" Zm9v\tYg== ").value_or("failed"), QByteArray("foob"));
+    // Padding is optional.
+    QCOMPARE(base64Decode("Zm9vYg").value_or("failed"), QByteArray("foob"));
+    QCOMPARE(base64Decode("Zm9vYmE").value_or("failed"), QByteArray("fooba"));
+
+    const QByteArray data = randomBytes(50000, 3);
+    QCOMPARE(base64Decode(wrapLines(data.toBase64())).value_or("failed"), data);
+}
+
+void TestBase64::malformed_data()
+{
+    QTest::addColumn<QByteArray>("text");
+
+    QTest::newRow("bad-character") << QByteArray("Zm9v!mFy");
+    QTest::newRow("url-alphabet") << QByteArray("Zm9v-_Fy");
+    QTest::newRow("early-padding") << QByteArray("Z===");
+    QTest::newRow("data-after-padding") << QByteArray("Zm9vYg==Zm9v");
+    QTest::newRow("single-character-tail") << QByteArray("Zm9vY");
+    // Inside what the SIMD kernel would otherwise take in one go.
+    QTest::newRow("bad-in-block") << QByteArray(QByteArray(40, 'A') + '*' + QByteArray(40, 'A'));
+}
+
+void TestBase64::malformed()
+{
+    QFETCH(QByteArray, text);
+
+    QVERIFY(!base64Decode(text));
+    for (int chunk : { 1, 3, 32 }) {
+        QVERIFY(!decodeInChunks(text, chunk));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestBase64)
+#include "tst_base64.moc"
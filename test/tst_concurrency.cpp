@@ -0,0 +1,199 @@
+#include <UDBase64.h>
+#include <UDHash.h>
+#include <UDHtmlText.h>
+#include <UDImageColor.h>
+#include <UDPlatform.h>
+#include <UDUuid.h>
+
+#include <QSet>
+#include <QTest>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// What the Python modules may call from many threads at once on a
+// free-threaded interpreter. The first test starts every thread together so
+// the lazy initialisation (platform snapshot, kernel selection) is raced;
+// run it in a -DUNIDESK_SANITIZE=thread build to have the races reported.
+class TestConcurrency : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void firstUse();
+    void hashing();
+    void base64();
+    void htmlText();
+    void imageColor();
+};
+
+static constexpr int threadCount = 16;
+
+// Run body(index) on threadCount threads, released at the same moment.
+static void runTogether(const std::function<void(int)>& body)
+{
+    std::atomic<int> ready { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            ++ready;
+            while (ready.load() < threadCount) {
+                std::this_thread::yield();
+            }
+            body(t);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+static QByteArray sampleData(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(i * 131 + 7);
+    }
+    return data;
+}
+
+static QImage sampleImage()
+{
+    QImage image(640, 480, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = qRgb(x % 256, y % 256, (x ^ y) % 256);
+        }
+    }
+    return image;
+}
+
+static const QString sampleHtml = QStringLiteral("<p>Hello <b>world</b> &amp; <i>everyone</i></p><br>second line");
+
+// Every entry point with a first-use cache, first called from all threads
+// at once. The results are compared with a serial run afterwards.
+void TestConcurrency::firstUse()
+{
+    const QByteArray data = sampleData(100000);
+    const QImage image = sampleImage();
+    std::vector<const PlatformInfo*> platforms(threadCount);
+    std::vector<QByteArray> sha256(threadCount), xxh3(threadCount), encoded(threadCount);
+    std::vector<QString> texts(threadCount);
+    std::vector<QColor> colors(threadCount);
+    std::vector<QString> ids(threadCount);
+
+    runTogether([&](int t) {
+        // Each thread starts somewhere else, so every cache sees contention.
+        for (int step = 0; step < 7; ++step) {
+            switch ((t + step) % 7) {
+            case 0:
+                platforms[t] = &platformInfo();
+                break;
+            case 1:
+                sha256[t] = hashBytes(data, HashAlgorithm::Sha256);
+                break;
+            case 2:
+                xxh3[t] = hashBytes(data, HashAlgorithm::Xxh3);
+                break;
+            case 3:
+                encoded[t] = base64Encode(data);
+                break;
+            case 4:
+                texts[t] = htmlToPlainText(sampleHtml);
+                break;
+            case 5:
+                colors[t] = averageImageColor(image, 1, 1);
+                break;
+            case 6:
+                ids[t] = uuidHex();
+                break;
+            }
+        }
+    });
+
+    for (int t = 0; t < threadCount; ++t) {
+        QCOMPARE(platforms[t], &platformInfo());
+        QCOMPARE(sha256[t], hashBytes(data, HashAlgorithm::Sha256));
+        QCOMPARE(xxh3[t], hashBytes(data, HashAlgorithm::Xxh3));
+        QCOMPARE(encoded[t], base64Encode(data));
+        QCOMPARE(texts[t], htmlToPlainText(sampleHtml));
+        QCOMPARE(colors[t], averageImageColor(image, 1, 1));
+    }
+    QCOMPARE(QSet<QString>(ids.begin(), ids.end()).size(), qsizetype(threadCount));
+}
+
+void TestConcurrency::hashing()
+{
+    const QByteArray data = sampleData(1 << 20);
+    const QByteArray expected = hashBytes(data, HashAlgorithm::Blake3);
+    std::atomic<int> mismatches { 0 };
+    runTogether([&](int) {
+        for (int i = 0; i < 20; ++i) {
+            if (hashBytes(data, HashAlgorithm::Blake3) != expected) {
+                ++mismatches;
+            }
+        }
+    });
+    QCOMPARE(mismatches.load(), 0);
+}
+
+void TestConcurrency::base64()
+{
+    std::atomic<int> mismatches { 0 };
+    runTogether([&](int t) {
+        for (int i = 0; i < 200; ++i) {
+            const QByteArray data = sampleData(1000 + t * 37 + i);
+            if (base64Decode(base64Encode(data)) != data) {
+                ++mismatches;
+            }
+        }
+    });
+    QCOMPARE(mismatches.load(), 0);
+}
+
+void TestConcurrency::htmlText()
+{
+    QStringList htmls;
+    for (int i = 0; i < 500; ++i) {
+        htmls << sampleHtml + QString::number(i);
+    }
+    const QStringList expected = htmlToPlainTexts(htmls);
+    std::atomic<int> mismatches { 0 };
+    runTogether([&](int t) {
+        for (int i = 0; i < 20; ++i) {
+            if (t % 2 ? htmlToPlainTexts(htmls) != expected : htmlToPlainText(htmls[i]) != expected[i]) {
+                ++mismatches;
+            }
+        }
+    });
+    QCOMPARE(mismatches.load(), 0);
+}
+
+// One shared image, as a numpy array shared between Python threads would be.
+void TestConcurrency::imageColor()
+{
+    const QImage image = sampleImage();
+    const QColor average = averageImageColor(image, 1, 1);
+    const QColor main = averageImageColor(image, mainColorStep, 1);
+    const QList<PaletteColor> palette = extractPalette(image, 5);
+    std::atomic<int> mismatches { 0 };
+    runTogether([&](int) {
+        for (int i = 0; i < 10; ++i) {
+            const QList<PaletteColor> colors = extractPalette(image, 5);
+            bool same = colors.size() == palette.size();
+            for (qsizetype c = 0; same && c < colors.size(); ++c) {
+                same = colors[c].color == palette[c].color && colors[c].weight == palette[c].weight;
+            }
+            if (!same || averageImageColor(image, 1, 1) != average
+                || averageImageColor(image, mainColorStep, 1) != main) {
+                ++mismatches;
+            }
+        }
+    });
+    QCOMPARE(mismatches.load(), 0);
+}
+
+QTEST_GUILESS_MAIN(TestConcurrency)
+#include "tst_concurrency.moc"
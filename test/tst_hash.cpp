@@ -0,0 +1,196 @@
+#include <UDHash.h>
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+Q_DECLARE_METATYPE(HashAlgorithm)
+
+namespace {
+
+// Bytes that repeat with a period no block size divides.
+QByteArray pattern(qsizetype size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] = char((i * 31 + 7) & 0xff);
+    }
+    return data;
+}
+
+QString writeFile(const QTemporaryDir& dir, const QString& name, const QByteArray& data)
+{
+    const QString path = dir.filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+        return {};
+    }
+    return path;
+}
+
+} // namespace
+
+class TestHash : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void knownDigests_data();
+    void knownDigests();
+    void streamingMatchesOneShot_data();
+    void streamingMatchesOneShot();
+    void fileMatchesBytes_data();
+    void fileMatchesBytes();
+    void unmappableFile();
+    void missingFile();
+    void batchKeepsOrder();
+    void algorithmNames();
+};
+
+void TestHash::knownDigests_data()
+{
+    QTest::addColumn<HashAlgorithm>("algorithm");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("digest");
+
+    // Reference values from hashlib, xxhash and blake3 for Python.
+    const QByteArray empty;
+    const QByteArray abc("abc");
+    const QByteArray chunk = pattern(1025);
+    const QByteArray large = pattern((1 << 20) + 17);
+
+    QTest::newRow("md5-empty") << HashAlgorithm::Md5 << empty << QByteArray("d41d8cd98f00b204e9800998ecf8427e");
+    QTest::newRow("md5-abc") << HashAlgorithm::Md5 << abc << QByteArray("900150983cd24fb0d6963f7d28e17f72");
+    QTest::newRow("sha256-abc") << HashAlgorithm::Sha256 << abc
+                                << QByteArray("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    QTest::newRow("sha256-large") << HashAlgorithm::Sha256 << large
+                                  << QByteArray("4127c61cb879e78b603e0b3e807c6a4127b1ec5a56630c8fb6a279043649e99a");
+    QTest::newRow("xxh3-empty") << HashAlgorithm::Xxh3 << empty << QByteArray("2d06800538d394c2");
+    QTest::newRow("xxh3-abc") << HashAlgorithm::Xxh3 << abc << QByteArray("78af5f94892f3950");
+    QTest::newRow("xxh3-1025") << HashAlgorithm::Xxh3 << chunk << QByteArray("c09fdfbc398c7d82");
+    QTest::newRow("xxh3-large") << HashAlgorithm::Xxh3 << large << QByteArray("c4a9e9d7c2dc6f86");
+    QTest::newRow("blake3-empty") << HashAlgorithm::Blake3 << empty
+                                  << QByteArray("af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262");
+    QTest::newRow("blake3-abc") << HashAlgorithm::Blake3 << abc
+                                << QByteArray("6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85");
+    QTest::newRow("blake3-1025") << HashAlgorithm::Blake3 << chunk
+                                 << QByteArray("b8c5c46b114817810a6ed499350cb4d2423cd23dd08d32c137b226d8559b8ab0");
+    QTest::newRow("blake3-large") << HashAlgorithm::Blake3 << large
+                                  << QByteArray("7f193158d8f8e8bad20b2f9ae34b781c0993cb03126a6ce610afa1fdfad78d1e");
+}
+
+void TestHash::knownDigests()
+{
+    QFETCH(HashAlgorithm, algorithm);
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, digest);
+
+    QCOMPARE(hashBytes(data, algorithm).toHex(), digest);
+}
+
+void TestHash::streamingMatchesOneShot_data()
+{
+    QTest::addColumn<HashAlgorithm>("algorithm");
+    QTest::addColumn<int>("piece");
+
+    const std::pair<const char*, HashAlgorithm> algorithms[] = {
+        { "md5", HashAlgorithm::Md5 },
+        { "sha256", HashAlgorithm::Sha256 },
+        { "xxh3", HashAlgorithm::Xxh3 },
+        { "blake3", HashAlgorithm::Blake3 },
+    };
+    // Pieces smaller than, equal to and straddling the XXH3 stripe and
+    // buffer and the BLAKE3 block and chunk.
+    for (const auto& [name, algorithm] : algorithms) {
+        for (int piece : { 1, 7, 64, 256, 1000, 1024, 4099 }) {
+            QTest::addRow("%s-%d", name, piece) << algorithm << piece;
+        }
+    }
+}
+
+void TestHash::streamingMatchesOneShot()
+{
+    QFETCH(HashAlgorithm, algorithm);
+    QFETCH(int, piece);
+
+    const QByteArray data = pattern(20000);
+    StreamHasher hasher(algorithm);
+    for (qsizetype offset = 0; offset < data.size(); offset += piece) {
+        hasher.addData(QByteArrayView(data).sliced(offset, qMin<qsizetype>(piece, data.size() - offset)));
+    }
+    QCOMPARE(hasher.result(), hashBytes(data, algorithm));
+}
+
+void TestHash::fileMatchesBytes_data()
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("empty") << 0;
+    QTest::newRow("small") << 1025;
+    QTest::newRow("chunk+1") << (1 << 20) + 1;
+    QTest::newRow("8MiB") << (8 << 20);
+}
+
+void TestHash::fileMatchesBytes()
+{
+    QFETCH(int, size);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray data = pattern(size);
+    const QString path = writeFile(dir, QStringLiteral("data"), data);
+    QVERIFY(!path.isEmpty());
+
+    for (HashAlgorithm algorithm : { HashAlgorithm::Md5, HashAlgorithm::Sha256, HashAlgorithm::Xxh3, HashAlgorithm::Blake3 }) {
+        QCOMPARE(hashFile(path, algorithm), hashBytes(data, algorithm));
+    }
+    QCOMPARE(hashFile(path, HashAlgorithm::Sha256), QCryptographicHash::hash(data, QCryptographicHash::Sha256));
+}
+
+void TestHash::unmappableFile()
+{
+    // procfs files report size 0 and cannot be mapped: the chunked read path.
+    const QString path = QStringLiteral("/proc/self/cmdline");
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        QSKIP("no procfs");
+    }
+    const QByteArray data = file.readAll();
+    QVERIFY(!data.isEmpty());
+    QCOMPARE(hashFile(path, HashAlgorithm::Xxh3), hashBytes(data, HashAlgorithm::Xxh3));
+}
+
+void TestHash::missingFile()
+{
+    QVERIFY(hashFile(QStringLiteral("/nonexistent/file"), HashAlgorithm::Sha256).isEmpty());
+}
+
+void TestHash::batchKeepsOrder()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QStringList paths;
+    for (int i = 0; i < 64; ++i) {
+        paths << writeFile(dir, QString::number(i), pattern(i * 997));
+    }
+    paths << dir.filePath(QStringLiteral("missing"));
+
+    const QList<QByteArray> digests = hashFiles(paths, HashAlgorithm::Blake3);
+    QCOMPARE(digests.size(), paths.size());
+    for (qsizetype i = 0; i < paths.size(); ++i) {
+        QCOMPARE(digests[i], hashFile(paths[i], HashAlgorithm::Blake3));
+    }
+    QVERIFY(digests.last().isEmpty());
+}
+
+void TestHash::algorithmNames()
+{
+    QVERIFY(hashAlgorithmFromName(u"md5") == HashAlgorithm::Md5);
+    QVERIFY(hashAlgorithmFromName(u"SHA256") == HashAlgorithm::Sha256);
+    QVERIFY(hashAlgorithmFromName(u"Xxh3") == HashAlgorithm::Xxh3);
+    QVERIFY(hashAlgorithmFromName(u"blake3") == HashAlgorithm::Blake3);
+    QVERIFY(!hashAlgorithmFromName(u"crc32"));
+}
+
+QTEST_GUILESS_MAIN(TestHash)
+#include "tst_hash.moc"
@@ -0,0 +1,113 @@
+#include <qhotkey.h>
+
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <memory>
+
+#include "xtest.h"
+
+// Keyboard layout switches with setxkbmap while hotkeys are grabbed. Between
+// "us" and "de" the Y and Z keys trade places, and "de" has an Ö key that
+// "us" lacks: a grab has to follow its key to the new keycode, and a hotkey
+// whose key is gone has to come back with the layout that has it.
+class TestHotkeyRemap : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void grabFollowsKey();
+    void lostHotkeyComesBack();
+
+private:
+    bool setLayout(const char* layout);
+    // Counts activations of hotkey while keys are pressed and released, on a
+    // connection opened after the last layout switch so it sees the new keymap.
+    int activationsFor(QHotkey* hotkey, std::initializer_list<KeySym> keys);
+
+    QString _setxkbmap;
+};
+
+static const Qt::KeyboardModifiers modifiers = Qt::ControlModifier | Qt::AltModifier;
+
+bool TestHotkeyRemap::setLayout(const char* layout)
+{
+    return QProcess::execute(_setxkbmap, { QStringLiteral("-layout"), QString::fromLatin1(layout) }) == 0;
+}
+
+int TestHotkeyRemap::activationsFor(QHotkey* hotkey, std::initializer_list<KeySym> keys)
+{
+    XTestKeyboard keyboard;
+    int activations = 0;
+    const QMetaObject::Connection connection = connect(hotkey, &QHotkey::activated, this, [&activations] { ++activations; });
+    keyboard.press(keys);
+    keyboard.release(keys);
+    processEventsUntil([&activations] { return activations > 0; }, 500);
+    disconnect(connection);
+    return activations;
+}
+
+void TestHotkeyRemap::initTestCase()
+{
+    if (!QHotkey::isPlatformSupported()) {
+        QSKIP("global hotkeys are not supported on this platform");
+    }
+    if (!XTestKeyboard().isValid()) {
+        QSKIP("no X display with the XTest extension");
+    }
+    _setxkbmap = QStandardPaths::findExecutable(QStringLiteral("setxkbmap"));
+    if (_setxkbmap.isEmpty()) {
+        QSKIP("setxkbmap is not installed");
+    }
+}
+
+void TestHotkeyRemap::cleanupTestCase()
+{
+    if (!_setxkbmap.isEmpty()) {
+        setLayout("us");
+    }
+}
+
+void TestHotkeyRemap::init()
+{
+    QVERIFY(setLayout("us"));
+    // Let the keymap change of an earlier test be handled first.
+    QTest::qWait(200);
+}
+
+void TestHotkeyRemap::grabFollowsKey()
+{
+    QHotkey hotkey(Qt::Key_Z, modifiers, true);
+    QVERIFY(hotkey.isRegistered());
+    const quint32 usKeycode = hotkey.currentNativeShortcut().key;
+    QCOMPARE(activationsFor(&hotkey, { XK_Control_L, XK_Alt_L, XK_z }), 1);
+
+    QVERIFY(setLayout("de"));
+    QTRY_VERIFY(hotkey.currentNativeShortcut().key != usKeycode);
+    QVERIFY(hotkey.isRegistered());
+    QCOMPARE(activationsFor(&hotkey, { XK_Control_L, XK_Alt_L, XK_z }), 1);
+    // The old keycode is Y now, which must not trigger it.
+    QCOMPARE(activationsFor(&hotkey, { XK_Control_L, XK_Alt_L, XK_y }), 0);
+}
+
+void TestHotkeyRemap::lostHotkeyComesBack()
+{
+    QVERIFY(setLayout("de"));
+    QTest::qWait(200);
+    QHotkey hotkey(Qt::Key_Odiaeresis, modifiers, true);
+    QVERIFY(hotkey.isRegistered());
+    QCOMPARE(activationsFor(&hotkey, { XK_Control_L, XK_Alt_L, XK_odiaeresis }), 1);
+
+    QVERIFY(setLayout("us"));
+    QTRY_VERIFY(!hotkey.isRegistered());
+
+    QVERIFY(setLayout("de"));
+    QTRY_VERIFY(hotkey.isRegistered());
+    QCOMPARE(activationsFor(&hotkey, { XK_Control_L, XK_Alt_L, XK_odiaeresis }), 1);
+}
+
+QTEST_MAIN(TestHotkeyRemap)
+#include "tst_hotkeyremap.moc"
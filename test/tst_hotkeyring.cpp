@@ -0,0 +1,295 @@
+#include <UDHotkey.h>
+
+#include <QElapsedTimer>
+#include <QTest>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// HotkeyEventRing on its own. The stress cases are meant to be run in a
+// -DUNIDESK_SANITIZE=thread build as well as a plain one.
+class TestHotkeyRing : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void fifo();
+    void capacity_data();
+    void capacity();
+    void drainMax();
+    void waitTimesOut();
+    void waitWakesOnPush();
+    void interruptIsSticky();
+    void stressOneConsumer();
+    void stressSleepingConsumers_data();
+    void stressSleepingConsumers();
+    void stressDropping();
+};
+
+static HotkeyEvent hotkeyEvent(int id, HotkeyEvent::Kind kind = HotkeyEvent::Activated)
+{
+    return { id, kind, id * 10 };
+}
+
+void TestHotkeyRing::fifo()
+{
+    HotkeyEventRing ring(8);
+    QVERIFY(ring.isEmpty());
+    QVERIFY(ring.push(hotkeyEvent(1)));
+    QVERIFY(ring.push(hotkeyEvent(2, HotkeyEvent::Released)));
+    QVERIFY(!ring.isEmpty());
+
+    std::vector<HotkeyEvent> out;
+    QCOMPARE(ring.drain(out), std::size_t(2));
+    QCOMPARE(out.size(), std::size_t(2));
+    QCOMPARE(out[0].id, 1);
+    QCOMPARE(int(out[0].kind), int(HotkeyEvent::Activated));
+    QCOMPARE(out[1].id, 2);
+    QCOMPARE(int(out[1].kind), int(HotkeyEvent::Released));
+    QCOMPARE(out[1].timestamp, qint64(20));
+    QVERIFY(ring.isEmpty());
+    QCOMPARE(ring.drain(out), std::size_t(0));
+}
+
+void TestHotkeyRing::capacity_data()
+{
+    QTest::addColumn<int>("requested");
+    QTest::addColumn<int>("holds");
+
+    QTest::newRow("0") << 0 << 2;
+    QTest::newRow("1") << 1 << 2;
+    QTest::newRow("5") << 5 << 8;
+    QTest::newRow("64") << 64 << 64;
+    QTest::newRow("1000") << 1000 << 1024;
+}
+
+// Full means full: the next push is dropped and counted, and draining
+// makes room again, also across the wrap of the indices.
+void TestHotkeyRing::capacity()
+{
+    QFETCH(int, requested);
+    QFETCH(int, holds);
+
+    HotkeyEventRing ring { std::size_t(requested) };
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < holds; ++i) {
+            QVERIFY(ring.push(hotkeyEvent(i)));
+        }
+        QVERIFY(!ring.push(hotkeyEvent(holds)));
+        QVERIFY(!ring.push(hotkeyEvent(holds + 1)));
+        QCOMPARE(ring.dropped(), quint64(2 * (round + 1)));
+
+        std::vector<HotkeyEvent> out;
+        QCOMPARE(ring.drain(out), std::size_t(holds));
+        QCOMPARE(out.back().id, holds - 1);
+    }
+}
+
+void TestHotkeyRing::drainMax()
+{
+    HotkeyEventRing ring(16);
+    for (int i = 0; i < 10; ++i) {
+        ring.push(hotkeyEvent(i));
+    }
+    std::vector<HotkeyEvent> out;
+    QCOMPARE(ring.drain(out, 4), std::size_t(4));
+    QCOMPARE(ring.drain(out, 4), std::size_t(4));
+    QCOMPARE(ring.drain(out, 4), std::size_t(2));
+    QCOMPARE(out.size(), std::size_t(10));
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(out[std::size_t(i)].id, i);
+    }
+}
+
+void TestHotkeyRing::waitTimesOut()
+{
+    HotkeyEventRing ring;
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!ring.wait(50));
+    QVERIFY(timer.elapsed() >= 45);
+    QVERIFY(!ring.wait(0));
+
+    ring.push(hotkeyEvent(1));
+    timer.restart();
+    QVERIFY(ring.wait(5000));
+    QVERIFY(ring.wait(-1));
+    QVERIFY(timer.elapsed() < 1000);
+}
+
+void TestHotkeyRing::waitWakesOnPush()
+{
+    HotkeyEventRing ring;
+    std::atomic<bool> woke { false };
+    std::thread consumer([&] { woke = ring.wait(-1); });
+    QTest::qSleep(20);
+    QVERIFY(!woke);
+    ring.push(hotkeyEvent(1));
+    consumer.join();
+    QVERIFY(woke);
+}
+
+void TestHotkeyRing::interruptIsSticky()
+{
+    HotkeyEventRing ring;
+    std::vector<std::thread> sleepers;
+    std::atomic<int> returned { 0 };
+    for (int i = 0; i < 4; ++i) {
+        sleepers.emplace_back([&] {
+            ring.wait(-1);
+            ++returned;
+        });
+    }
+    QTest::qSleep(20);
+    ring.interrupt();
+    for (std::thread& sleeper : sleepers) {
+        sleeper.join();
+    }
+    QCOMPARE(returned.load(), 4);
+
+    // Until resume(), a consumer that comes late does not sleep either.
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!ring.wait(-1));
+    QVERIFY(timer.elapsed() < 1000);
+
+    ring.resume();
+    QVERIFY(!ring.wait(20));
+    ring.push(hotkeyEvent(1));
+    QVERIFY(ring.wait(-1));
+}
+
+// A producer that never drops (it retries on a full ring) and one consumer
+// that sleeps whenever the ring is empty: every event arrives, in order.
+void TestHotkeyRing::stressOneConsumer()
+{
+    constexpr int eventCount = 200000;
+    HotkeyEventRing ring(64);
+    std::vector<int> received;
+    received.reserve(eventCount);
+
+    std::thread consumer([&] {
+        std::vector<HotkeyEvent> out;
+        while (received.size() < std::size_t(eventCount)) {
+            ring.wait(-1);
+            out.clear();
+            ring.drain(out);
+            for (const HotkeyEvent& each : out) {
+                received.push_back(each.id);
+            }
+        }
+    });
+    for (int i = 0; i < eventCount; ++i) {
+        while (!ring.push(hotkeyEvent(i))) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    QCOMPARE(received.size(), std::size_t(eventCount));
+    for (int i = 0; i < eventCount; ++i) {
+        QCOMPARE(received[std::size_t(i)], i);
+    }
+}
+
+void TestHotkeyRing::stressSleepingConsumers_data()
+{
+    QTest::addColumn<int>("consumers");
+
+    QTest::newRow("2") << 2;
+    QTest::newRow("4") << 4;
+    QTest::newRow("8") << 8;
+}
+
+// What the Python bindings do: several threads sleeping in wait() at once,
+// taking turns to drain under a mutex, then stopped with interrupt().
+void TestHotkeyRing::stressSleepingConsumers()
+{
+    QFETCH(int, consumers);
+
+    constexpr int rounds = 50;
+    constexpr int eventCount = 5000;
+    for (int round = 0; round < rounds; ++round) {
+        HotkeyEventRing ring(32);
+        std::mutex drainMutex;
+        std::vector<int> received;
+        std::atomic<bool> stop { false };
+
+        std::vector<std::thread> threads;
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c] {
+                std::vector<HotkeyEvent> out;
+                while (!stop) {
+                    // Mix sleeping forever with short timeouts.
+                    ring.wait(c % 2 ? -1 : 2);
+                    std::lock_guard<std::mutex> lock(drainMutex);
+                    out.clear();
+                    ring.drain(out);
+                    for (const HotkeyEvent& each : out) {
+                        received.push_back(each.id);
+                    }
+                }
+            });
+        }
+        for (int i = 0; i < eventCount; ++i) {
+            while (!ring.push(hotkeyEvent(i))) {
+                std::this_thread::yield();
+            }
+        }
+        while (!ring.isEmpty()) {
+            std::this_thread::yield();
+        }
+        stop = true;
+        ring.interrupt();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        QCOMPARE(received.size(), std::size_t(eventCount));
+        for (int i = 0; i < eventCount; ++i) {
+            QCOMPARE(received[std::size_t(i)], i);
+        }
+    }
+}
+
+// A producer that does not wait for room: whatever is not dropped arrives,
+// in order, and nothing is lost without being counted.
+void TestHotkeyRing::stressDropping()
+{
+    constexpr int eventCount = 200000;
+    HotkeyEventRing ring(16);
+    std::vector<int> received;
+    std::atomic<bool> done { false };
+
+    std::thread consumer([&] {
+        std::vector<HotkeyEvent> out;
+        for (;;) {
+            const bool finished = done;
+            ring.wait(1);
+            out.clear();
+            ring.drain(out);
+            for (const HotkeyEvent& each : out) {
+                received.push_back(each.id);
+            }
+            if (finished && ring.isEmpty()) {
+                break;
+            }
+        }
+    });
+    int pushed = 0;
+    for (int i = 0; i < eventCount; ++i) {
+        pushed += ring.push(hotkeyEvent(i)) ? 1 : 0;
+    }
+    done = true;
+    consumer.join();
+
+    QCOMPARE(received.size(), std::size_t(pushed));
+    QCOMPARE(quint64(pushed) + ring.dropped(), quint64(eventCount));
+    for (std::size_t i = 1; i < received.size(); ++i) {
+        QVERIFY(received[i - 1] < received[i]);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestHotkeyRing)
+#include "tst_hotkeyring.moc"
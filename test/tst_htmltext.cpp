@@ -0,0 +1,146 @@
+#include <UDHtmlText.h>
+
+#include <QTest>
+#include <QTextDocument>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// What LingmoTools::html2PlantText() returned before the streaming converter.
+QString documentText(const QString& html)
+{
+    QTextDocument document;
+    document.setHtml(html);
+    return document.toPlainText();
+}
+
+} // namespace
+
+class TestHtmlText : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void matchesQTextDocument_data();
+    void matchesQTextDocument();
+    void ownBehaviour_data();
+    void ownBehaviour();
+    void batchMatchesSerial();
+    void concurrentCalls();
+};
+
+// Notification-style markup on which both agree.
+void TestHtmlText::matchesQTextDocument_data()
+{
+    QTest::addColumn<QString>("html");
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("plain") << QStringLiteral("Hello, world") << QStringLiteral("Hello, world");
+    QTest::newRow("inline") << QStringLiteral("<b>Build</b> finished in <i>3 min</i>")
+                            << QStringLiteral("Build finished in 3 min");
+    QTest::newRow("entities") << QStringLiteral("Tom &amp; Jerry &lt;3 &quot;cats&quot; &gt;")
+                              << QStringLiteral("Tom & Jerry <3 \"cats\" >");
+    QTest::newRow("numeric") << QStringLiteral("caf&#233; &#x263A; &#128512; &euro;&nbsp;5")
+                             << QString::fromUtf8("café ☺ \U0001F600 € 5");
+    QTest::newRow("paragraphs") << QStringLiteral("<p>first</p><p>second</p>") << QStringLiteral("first\nsecond");
+    QTest::newRow("br") << QStringLiteral("line one<br>line two<br/>line three")
+                        << QStringLiteral("line one\nline two\nline three");
+    QTest::newRow("div") << QStringLiteral("<div>a</div><div>b</div>text") << QStringLiteral("a\nb\ntext");
+    QTest::newRow("list") << QStringLiteral("<ul><li>one</li><li>two</li></ul>") << QStringLiteral("one\ntwo");
+    QTest::newRow("heading") << QStringLiteral("<h1>Title</h1><p>body</p>") << QStringLiteral("Title\nbody");
+    QTest::newRow("blockquote") << QStringLiteral("<blockquote>quoted</blockquote>reply")
+                                << QStringLiteral("quoted\nreply");
+    QTest::newRow("whitespace") << QStringLiteral("a   b\n  c\td") << QStringLiteral("a b c d");
+    QTest::newRow("pre") << QStringLiteral("<pre>keep   this\n  layout</pre>after")
+                         << QStringLiteral("keep   this\n  layout\nafter");
+    QTest::newRow("document")
+        << QStringLiteral("<html><head><title>t</title><style>p{color:red}</style></head><body><p>shown</p></body></html>")
+        << QStringLiteral("shown");
+    QTest::newRow("comment") << QStringLiteral("a<!-- comment <p>hidden</p> -->b") << QStringLiteral("ab");
+    QTest::newRow("link") << QStringLiteral("<a href=\"https://example.com/?a=1&b=2\">link</a> text")
+                          << QStringLiteral("link text");
+    QTest::newRow("quoted-attribute") << QStringLiteral("<span title=\"a > b\">x</span>") << QStringLiteral("x");
+}
+
+void TestHtmlText::matchesQTextDocument()
+{
+    QFETCH(QString, html);
+    QFETCH(QString, text);
+
+    QCOMPARE(htmlToPlainText(html), text);
+    QCOMPARE(htmlToPlainText(html), documentText(html));
+}
+
+// Where the converter defines its own output, or QTextDocument's depends on
+// layout details (object replacement characters, table frames).
+void TestHtmlText::ownBehaviour_data()
+{
+    QTest::addColumn<QString>("html");
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("image") << QStringLiteral("<img src=\"icon.png\"> caption") << QStringLiteral("caption");
+    QTest::newRow("script") << QStringLiteral("before<script>var a = \"<p>x</p>\";</script>after")
+                            << QStringLiteral("beforeafter");
+    QTest::newRow("table") << QStringLiteral("<table><tr><td>a</td><td>b</td></tr><tr><td>c</td></tr></table>")
+                           << QStringLiteral("a\nb\nc");
+    QTest::newRow("edge-spaces") << QStringLiteral("<p>  leading and trailing  </p>")
+                                 << QStringLiteral("leading and trailing");
+    QTest::newRow("bare-angles") << QStringLiteral("5 < 6 and 7 > 3") << QStringLiteral("5 < 6 and 7 > 3");
+    QTest::newRow("bare-ampersands") << QStringLiteral("AT&T &unknown;") << QStringLiteral("AT&T &unknown;");
+    QTest::newRow("invalid-references") << QStringLiteral("&#0;&#xD800;&#99999999;")
+                                        << QString(3, QChar::ReplacementCharacter);
+    QTest::newRow("unterminated-comment") << QStringLiteral("<p>kept <!-- dropped") << QStringLiteral("kept");
+    QTest::newRow("unterminated-script") << QStringLiteral("kept<script>dropped") << QStringLiteral("kept");
+    QTest::newRow("empty") << QString() << QString();
+}
+
+void TestHtmlText::ownBehaviour()
+{
+    QFETCH(QString, html);
+    QFETCH(QString, text);
+
+    QCOMPARE(htmlToPlainText(html), text);
+}
+
+void TestHtmlText::batchMatchesSerial()
+{
+    QStringList htmls;
+    for (int i = 0; i < 2000; ++i) {
+        htmls << QStringLiteral("<p>Message <b>%1</b></p><p>from &lt;user%2&gt;</p>").arg(i).arg(i % 7);
+    }
+
+    const QStringList texts = htmlToPlainTexts(htmls);
+    QCOMPARE(texts.size(), htmls.size());
+    for (qsizetype i = 0; i < htmls.size(); ++i) {
+        QCOMPARE(texts[i], htmlToPlainText(htmls[i]));
+    }
+    QCOMPARE(texts[42], QStringLiteral("Message 42\nfrom <user0>"));
+}
+
+// No shared state: many threads converting at once get what one thread does.
+void TestHtmlText::concurrentCalls()
+{
+    const QString html = QStringLiteral("<div>caf&eacute;<br>&#128512;</div><script>x</script><p>end</p>");
+    const QString expected = htmlToPlainText(html);
+
+    std::atomic<int> mismatches { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) {
+                if (htmlToPlainText(html) != expected) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    QCOMPARE(mismatches.load(), 0);
+}
+
+QTEST_MAIN(TestHtmlText)
+#include "tst_htmltext.moc"
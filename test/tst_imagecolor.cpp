@@ -0,0 +1,233 @@
+#include "testimages.h"
+
+#include <UDImageColor.h>
+
+#include <QTest>
+
+namespace {
+
+// Channel sums of every step-th pixel, one QImage::pixel() call at a time.
+ImageColorSums pixelSums(const QImage& image, int step)
+{
+    ImageColorSums sums;
+    for (int y = 0; y < image.height(); y += step) {
+        for (int x = 0; x < image.width(); x += step) {
+            const QRgb pixel = image.pixel(x, y);
+            sums.red += qRed(pixel);
+            sums.green += qGreen(pixel);
+            sums.blue += qBlue(pixel);
+            ++sums.count;
+        }
+    }
+    return sums;
+}
+
+// Palette colors come back as the centre of their 5-bit histogram bin, so
+// these are reproduced exactly.
+const QColor red(252, 4, 4);
+const QColor green(4, 252, 4);
+const QColor blue(4, 4, 252);
+
+// Horizontal bands: half the rows red, a third green and a sixth blue.
+QImage bandsImage(QImage::Format format)
+{
+    QImage image(100, 120, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        const QColor& color = y < 60 ? red : y < 100 ? green : blue;
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixelColor(x, y, color);
+        }
+    }
+    return image.convertToFormat(format);
+}
+
+} // namespace
+
+class TestImageColor : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void matchesPreviousMainColor_data();
+    void matchesPreviousMainColor();
+    void sumsMatchPixelLoop_data();
+    void sumsMatchPixelLoop();
+    void sumsDoNotOverflow();
+    void nullImage();
+    void paletteOfBands_data();
+    void paletteOfBands();
+    void paletteWeights();
+    void paletteSkipsTransparent();
+    void paletteUnpremultiplies();
+    void emptyPalette();
+};
+
+void TestImageColor::matchesPreviousMainColor_data()
+{
+    QTest::addColumn<QImage>("image");
+    QTest::addColumn<double>("bright");
+
+    // Odd widths leave a tail after the SIMD blocks of every row.
+    QTest::newRow("rgb32") << noiseImage(641, 479, QImage::Format_RGB32, 1) << 1.0;
+    QTest::newRow("argb32") << noiseImage(333, 200, QImage::Format_ARGB32, 2) << 1.0;
+    QTest::newRow("argb32-premultiplied") << noiseImage(257, 129, QImage::Format_ARGB32_Premultiplied, 3) << 1.0;
+    QTest::newRow("rgbx8888") << noiseImage(300, 301, QImage::Format_RGBX8888, 4) << 1.0;
+    QTest::newRow("rgba8888") << noiseImage(123, 77, QImage::Format_RGBA8888, 5) << 1.0;
+    QTest::newRow("rgb888") << noiseImage(401, 99, QImage::Format_RGB888, 6) << 1.0;
+    QTest::newRow("converted") << noiseImage(150, 150, QImage::Format_RGB16, 7) << 1.0;
+    QTest::newRow("smaller-than-step") << noiseImage(7, 3, QImage::Format_RGB32, 8) << 1.0;
+    QTest::newRow("darker") << noiseImage(640, 480, QImage::Format_RGB32, 10) << 0.6;
+    QTest::newRow("clamped") << noiseImage(640, 480, QImage::Format_RGB32, 11) << 3.0;
+}
+
+void TestImageColor::matchesPreviousMainColor()
+{
+    QFETCH(QImage, image);
+    QFETCH(double, bright);
+
+    QCOMPARE(averageImageColor(image, mainColorStep, bright), previousMainColor(image, bright));
+}
+
+void TestImageColor::sumsMatchPixelLoop_data()
+{
+    QTest::addColumn<QImage>("image");
+    QTest::addColumn<int>("step");
+
+    QTest::newRow("every-pixel") << noiseImage(1001, 17, QImage::Format_RGB32, 20) << 1;
+    QTest::newRow("step-3") << noiseImage(1001, 301, QImage::Format_RGBA8888, 21) << 3;
+    QTest::newRow("rgb888-step-2") << noiseImage(999, 55, QImage::Format_RGB888, 22) << 2;
+    QTest::newRow("4k-parallel") << noiseImage(3840, 2160, QImage::Format_ARGB32, 23) << 1;
+}
+
+void TestImageColor::sumsMatchPixelLoop()
+{
+    QFETCH(QImage, image);
+    QFETCH(int, step);
+
+    const ImageColorSums expected = pixelSums(image, step);
+    const ImageColorSums actual = accumulateImageColor(image, step);
+    QCOMPARE(actual.count, expected.count);
+    QCOMPARE(actual.red, expected.red);
+    QCOMPARE(actual.green, expected.green);
+    QCOMPARE(actual.blue, expected.blue);
+}
+
+void TestImageColor::sumsDoNotOverflow()
+{
+    // 8K at every pixel: 33M samples of 255 do not fit the old int sums.
+    QImage image(7680, 4320, QImage::Format_RGB32);
+    image.fill(QColor(255, 128, 1));
+
+    const ImageColorSums sums = accumulateImageColor(image, 1);
+    QCOMPARE(sums.count, quint64(7680) * 4320);
+    QCOMPARE(sums.red, sums.count * 255);
+    QCOMPARE(averageColor(sums), QColor(255, 128, 1));
+}
+
+void TestImageColor::nullImage()
+{
+    QCOMPARE(accumulateImageColor(QImage(), mainColorStep).count, quint64(0));
+    QVERIFY(!averageImageColor(QImage(), mainColorStep).isValid());
+}
+
+void TestImageColor::paletteOfBands_data()
+{
+    QTest::addColumn<QImage>("image");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("rgb32") << bandsImage(QImage::Format_RGB32) << 3;
+    QTest::newRow("argb32") << bandsImage(QImage::Format_ARGB32) << 3;
+    QTest::newRow("rgba8888") << bandsImage(QImage::Format_RGBA8888) << 3;
+    QTest::newRow("rgb888") << bandsImage(QImage::Format_RGB888) << 3;
+    QTest::newRow("converted") << bandsImage(QImage::Format_RGB16) << 3;
+    // Nothing left to split after three colors.
+    QTest::newRow("more-than-colors") << bandsImage(QImage::Format_RGB32) << 8;
+}
+
+void TestImageColor::paletteOfBands()
+{
+    QFETCH(QImage, image);
+    QFETCH(int, count);
+
+    const QList<PaletteColor> palette = extractPalette(image, count);
+    QCOMPARE(palette.size(), qsizetype(3));
+    QCOMPARE(palette[0].color, red);
+    QCOMPARE(palette[0].weight, 6000.0 / 12000);
+    QCOMPARE(palette[1].color, green);
+    QCOMPARE(palette[1].weight, 4000.0 / 12000);
+    QCOMPARE(palette[2].color, blue);
+    QCOMPARE(palette[2].weight, 2000.0 / 12000);
+}
+
+void TestImageColor::paletteWeights()
+{
+    // 4K is sampled down, which must not change what the weights add up to.
+    const QList<PaletteColor> palette = extractPalette(noiseImage(3840, 2160, QImage::Format_RGB32, 30), 8);
+    QCOMPARE(palette.size(), qsizetype(8));
+    double total = 0;
+    for (qsizetype i = 0; i < palette.size(); ++i) {
+        QVERIFY(palette[i].color.isValid());
+        QVERIFY(palette[i].weight > 0);
+        if (i > 0) {
+            QVERIFY(palette[i].weight <= palette[i - 1].weight);
+        }
+        total += palette[i].weight;
+    }
+    QCOMPARE(total, 1.0);
+}
+
+void TestImageColor::paletteSkipsTransparent()
+{
+    // Transparent red over most of the image leaves only the opaque blue.
+    QImage image(64, 64, QImage::Format_ARGB32);
+    image.fill(QColor(252, 4, 4, 100));
+    for (int y = 48; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            image.setPixelColor(x, y, blue);
+        }
+    }
+
+    const QList<PaletteColor> palette = extractPalette(image, 4);
+    QCOMPARE(palette.size(), qsizetype(1));
+    QCOMPARE(palette[0].color, blue);
+    QCOMPARE(palette[0].weight, 1.0);
+}
+
+void TestImageColor::paletteUnpremultiplies()
+{
+    QImage image = bandsImage(QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            QColor color = image.pixelColor(x, y);
+            color.setAlpha(200);
+            image.setPixelColor(x, y, color);
+        }
+    }
+
+    const QList<PaletteColor> straight = extractPalette(image, 3);
+    const QList<PaletteColor> premultiplied = extractPalette(image.convertToFormat(QImage::Format_ARGB32_Premultiplied), 3);
+    QCOMPARE(premultiplied.size(), straight.size());
+    for (qsizetype i = 0; i < straight.size(); ++i) {
+        QCOMPARE(premultiplied[i].color, straight[i].color);
+        QCOMPARE(premultiplied[i].weight, straight[i].weight);
+    }
+    QCOMPARE(straight[0].color, red);
+}
+
+void TestImageColor::emptyPalette()
+{
+    QVERIFY(extractPalette(QImage(), 5).isEmpty());
+    QVERIFY(extractPalette(bandsImage(QImage::Format_RGB32), 0).isEmpty());
+    QImage transparent(32, 32, QImage::Format_ARGB32);
+    transparent.fill(Qt::transparent);
+    QVERIFY(extractPalette(transparent, 5).isEmpty());
+    QVERIFY(paletteToVariant({}).isEmpty());
+
+    const QVariantList variant = paletteToVariant(extractPalette(bandsImage(QImage::Format_RGB32), 1));
+    QCOMPARE(variant.size(), qsizetype(1));
+    const QVariantMap entry = variant.first().toMap();
+    QCOMPARE(entry.value(QStringLiteral("weight")).toDouble(), 1.0);
+    QVERIFY(entry.value(QStringLiteral("color")).value<QColor>().isValid());
+}
+
+QTEST_GUILESS_MAIN(TestImageColor)
+#include "tst_imagecolor.moc"
@@ -0,0 +1,83 @@
+#include <UDMappedFile.h>
+#include <UDTools.h>
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class TestMappedFile : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void regularFile();
+    void emptyFile();
+    void procFile();
+    void missingFile();
+};
+
+static QString writeFile(const QTemporaryDir& dir, const QByteArray& contents)
+{
+    const QString path = dir.filePath(QStringLiteral("file"));
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(contents);
+    }
+    return path;
+}
+
+void TestMappedFile::regularFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QByteArray contents;
+    for (int i = 0; i < 100000; ++i) {
+        contents += char(i * 7);
+    }
+    const QString path = writeFile(dir, contents);
+
+    const std::shared_ptr<const MappedFile> mapped = mapFile(path);
+    QVERIFY(mapped);
+    QCOMPARE(mapped->path(), path);
+    QCOMPARE(mapped->size(), contents.size());
+    QVERIFY(mapped->view() == contents);
+    QCOMPARE(mapped->bytes(), contents);
+    QCOMPARE(LingmoTools::getInstance()->readFileBytes(path), contents);
+}
+
+// Not mapped, so that the size-0 pseudo files below are read instead.
+void TestMappedFile::emptyFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir, QByteArray());
+    QVERIFY(QFileInfo::exists(path));
+
+    QVERIFY(!mapFile(path));
+    QVERIFY(LingmoTools::getInstance()->readFileBytes(path).isEmpty());
+}
+
+void TestMappedFile::procFile()
+{
+    const QString path = QStringLiteral("/proc/self/status");
+    if (!QFileInfo::exists(path)) {
+        QSKIP("needs /proc");
+    }
+    QCOMPARE(QFileInfo(path).size(), qint64(0));
+
+    QVERIFY(!mapFile(path));
+    const QByteArray status = LingmoTools::getInstance()->readFileBytes(path);
+    QVERIFY(status.startsWith("Name:"));
+    QVERIFY(status.contains("\nPid:"));
+}
+
+void TestMappedFile::missingFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("missing"));
+
+    QVERIFY(!mapFile(path));
+    QVERIFY(LingmoTools::getInstance()->readFileBytes(path).isEmpty());
+}
+
+QTEST_MAIN(TestMappedFile)
+#include "tst_mappedfile.moc"
@@ -0,0 +1,105 @@
+#include <UDPlatform.h>
+
+#include <QGuiApplication>
+#include <QSysInfo>
+#include <QTest>
+
+// platformInfo() as main() saw it before the application existed.
+static PlatformInfo beforeApplication;
+
+class TestPlatform : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void systemSnapshotWithoutApplication();
+    void fullSnapshotWithApplication();
+    void takenOnce();
+    void windowsVersionFlags();
+    void variantHasEveryField();
+};
+
+void TestPlatform::systemSnapshotWithoutApplication()
+{
+    QVERIFY(!beforeApplication.hasGui);
+    QCOMPARE(beforeApplication.os, QSysInfo::productType());
+    QCOMPARE(beforeApplication.kernelType, QSysInfo::kernelType());
+    QCOMPARE(beforeApplication.qtVersion, QString::fromLatin1(qVersion()));
+    QVERIFY(beforeApplication.platformName.isEmpty());
+    QVERIFY(beforeApplication.graphicsApi.isEmpty());
+    QVERIFY(!beforeApplication.isX11);
+    QVERIFY(!beforeApplication.isWayland);
+}
+
+void TestPlatform::fullSnapshotWithApplication()
+{
+    // The system-only snapshot taken before the application was not frozen.
+    const PlatformInfo& info = platformInfo();
+    QVERIFY(info.hasGui);
+    QCOMPARE(info.platformName, QGuiApplication::platformName());
+    QCOMPARE(info.platformName, QStringLiteral("offscreen"));
+    QVERIFY(!info.isX11);
+    QVERIFY(!info.isWayland);
+    QVERIFY(!info.graphicsApi.isEmpty());
+    if (info.isSoftware) {
+        QVERIFY(!info.supportsShaderEffects);
+    }
+
+    QCOMPARE(info.os, beforeApplication.os);
+    QCOMPARE(info.osVersion, beforeApplication.osVersion);
+    QCOMPARE(info.compositor, beforeApplication.compositor);
+    QCOMPARE(info.windowsBuildNumber, beforeApplication.windowsBuildNumber);
+}
+
+void TestPlatform::takenOnce()
+{
+    const PlatformInfo* info = &platformInfo();
+    QCOMPARE(&platformInfo(), info);
+
+    const QStringList version = info->qtVersion.split(QLatin1Char('.'));
+    QCOMPARE(version.size(), qsizetype(3));
+    QCOMPARE(info->qtMajor, version[0].toInt());
+    QCOMPARE(info->qtMinor, version[1].toInt());
+    QCOMPARE(info->qtPatch, version[2].toInt());
+    QCOMPARE(info->qtMajor, QT_VERSION_MAJOR);
+}
+
+void TestPlatform::windowsVersionFlags()
+{
+    const PlatformInfo& info = platformInfo();
+#if defined(Q_OS_WIN)
+    QVERIFY(info.windowsBuildNumber > 0);
+#else
+    QCOMPARE(info.windowsBuildNumber, -1);
+#endif
+    QCOMPARE(info.isWindows10OrGreater, info.windowsBuildNumber >= 10240);
+    QCOMPARE(info.isWindows11OrGreater, info.windowsBuildNumber >= 22000);
+    QCOMPARE(info.supportsAcrylic, info.windowsBuildNumber >= 17134);
+    QCOMPARE(info.supportsMica, info.isWindows11OrGreater);
+}
+
+void TestPlatform::variantHasEveryField()
+{
+    const PlatformInfo& info = platformInfo();
+    const QVariantMap map = platformInfoToVariant(info);
+    QCOMPARE(map.size(), qsizetype(21));
+    QCOMPARE(map.value(QStringLiteral("hasGui")).toBool(), info.hasGui);
+    QCOMPARE(map.value(QStringLiteral("os")).toString(), info.os);
+    QCOMPARE(map.value(QStringLiteral("qtMinor")).toInt(), info.qtMinor);
+    QCOMPARE(map.value(QStringLiteral("platformName")).toString(), info.platformName);
+    QCOMPARE(map.value(QStringLiteral("graphicsApi")).toString(), info.graphicsApi);
+    QCOMPARE(map.value(QStringLiteral("supportsShaderEffects")).toBool(), info.supportsShaderEffects);
+    QCOMPARE(map.value(QStringLiteral("windowsBuildNumber")).toInt(), info.windowsBuildNumber);
+    QCOMPARE(map.value(QStringLiteral("supportsMica")).toBool(), info.supportsMica);
+}
+
+// QTEST_MAIN, with one platformInfo() call before the application exists.
+int main(int argc, char** argv)
+{
+    beforeApplication = platformInfo();
+    QGuiApplication app(argc, argv);
+    TestPlatform test;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_platform.moc"
@@ -0,0 +1,196 @@
+#include <stdafx.h>
+
+#include <QMetaProperty>
+#include <QSignalSpy>
+#include <QTest>
+
+// One property per macro. The members are private to the class, so the
+// constructor initialises them directly rather than through the setters.
+class PropertyHolder : public QObject {
+    Q_OBJECT
+    Q_PROPERTY_AUTO(int, plain)
+    Q_PROPERTY_AUTO_DISTINCT(int, distinct)
+    Q_PROPERTY_AUTO_DISTINCT(QString, distinctText)
+    Q_PROPERTY_AUTO_P_DISTINCT(QObject*, distinctPointer)
+    Q_PROPERTY_READONLY_AUTO_DISTINCT(int, readonlyDistinct)
+    Q_PROPERTY_BINDABLE_AUTO(PropertyHolder, int, bindable)
+    Q_PROPERTY_READONLY_BINDABLE_AUTO(PropertyHolder, int, readonlyBindable)
+
+public:
+    PropertyHolder()
+    {
+        _plain = 0;
+        _distinct = 0;
+        _distinctPointer = nullptr;
+        _readonlyDistinct = 0;
+    }
+};
+
+class TestPropertyMacros : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void plainAlwaysNotifies();
+    void distinctNotifiesOnChange();
+    void distinctOtherTypes();
+    void bindableNotifiesOnChange();
+    void bindableFollowsBinding();
+    void setterRemovesBinding();
+    void metaProperties_data();
+    void metaProperties();
+};
+
+// The existing macro, unchanged: every C++ write notifies.
+void TestPropertyMacros::plainAlwaysNotifies()
+{
+    PropertyHolder holder;
+    QSignalSpy changed(&holder, &PropertyHolder::plainChanged);
+    holder.plain(5);
+    holder.plain(5);
+    QCOMPARE(changed.count(), 2);
+}
+
+void TestPropertyMacros::distinctNotifiesOnChange()
+{
+    PropertyHolder holder;
+    QSignalSpy changed(&holder, &PropertyHolder::distinctChanged);
+    QSignalSpy readonlyChanged(&holder, &PropertyHolder::readonlyDistinctChanged);
+
+    holder.distinct(0);
+    holder.readonlyDistinct(0);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(readonlyChanged.count(), 0);
+
+    holder.distinct(5);
+    holder.distinct(5);
+    holder.readonlyDistinct(5);
+    holder.readonlyDistinct(5);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(readonlyChanged.count(), 1);
+    QCOMPARE(holder.distinct(), 5);
+    QCOMPARE(holder.readonlyDistinct(), 5);
+
+    holder.distinct(6);
+    QCOMPARE(changed.count(), 2);
+    QCOMPARE(holder.distinct(), 6);
+}
+
+void TestPropertyMacros::distinctOtherTypes()
+{
+    PropertyHolder holder;
+    QSignalSpy textChanged(&holder, &PropertyHolder::distinctTextChanged);
+    QSignalSpy pointerChanged(&holder, &PropertyHolder::distinctPointerChanged);
+
+    holder.distinctText(QString());
+    holder.distinctText(QStringLiteral("panel"));
+    holder.distinctText(QStringLiteral("panel"));
+    QCOMPARE(textChanged.count(), 1);
+
+    QObject other;
+    holder.distinctPointer(nullptr);
+    holder.distinctPointer(&other);
+    holder.distinctPointer(&other);
+    QCOMPARE(pointerChanged.count(), 1);
+    QCOMPARE(holder.distinctPointer(), &other);
+}
+
+void TestPropertyMacros::bindableNotifiesOnChange()
+{
+    PropertyHolder holder;
+    QSignalSpy changed(&holder, &PropertyHolder::bindableChanged);
+    QSignalSpy readonlyChanged(&holder, &PropertyHolder::readonlyBindableChanged);
+
+    // A default-constructed QObjectBindableProperty holds int{}.
+    holder.bindable(0);
+    holder.readonlyBindable(0);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(readonlyChanged.count(), 0);
+
+    holder.bindable(5);
+    holder.bindable(5);
+    holder.readonlyBindable(5);
+    holder.readonlyBindable(5);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(readonlyChanged.count(), 1);
+    QCOMPARE(holder.bindable(), 5);
+    QCOMPARE(holder.readonlyBindable(), 5);
+}
+
+void TestPropertyMacros::bindableFollowsBinding()
+{
+    PropertyHolder holder;
+    QProperty<int> source(1);
+    int evaluations = 0;
+    holder.bindableBindable().setBinding([&] {
+        ++evaluations;
+        return source.value() * 2;
+    });
+    QCOMPARE(holder.bindable(), 2);
+
+    QSignalSpy changed(&holder, &PropertyHolder::bindableChanged);
+    source = 3;
+    QCOMPARE(holder.bindable(), 6);
+    QCOMPARE(changed.count(), 1);
+
+    // Writing the same source value again is not a change.
+    const int before = evaluations;
+    source = 3;
+    QCOMPARE(holder.bindable(), 6);
+    QCOMPARE(evaluations, before);
+    QCOMPARE(changed.count(), 1);
+
+    // Only the property's own value counts: a source change that gives
+    // the same result does not notify.
+    holder.bindableBindable().setBinding([&] { return source.value() / 10; });
+    changed.clear();
+    source = 4;
+    QCOMPARE(holder.bindable(), 0);
+    QCOMPARE(changed.count(), 0);
+}
+
+void TestPropertyMacros::setterRemovesBinding()
+{
+    PropertyHolder holder;
+    QProperty<int> source(1);
+    holder.bindableBindable().setBinding([&] { return source.value() * 2; });
+    QVERIFY(holder.bindableBindable().hasBinding());
+
+    holder.bindable(10);
+    QVERIFY(!holder.bindableBindable().hasBinding());
+    source = 4;
+    QCOMPARE(holder.bindable(), 10);
+}
+
+void TestPropertyMacros::metaProperties_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<bool>("writable");
+    QTest::addColumn<bool>("bindable");
+
+    QTest::newRow("plain") << QByteArray("plain") << true << false;
+    QTest::newRow("distinct") << QByteArray("distinct") << true << false;
+    QTest::newRow("distinctPointer") << QByteArray("distinctPointer") << true << false;
+    QTest::newRow("readonlyDistinct") << QByteArray("readonlyDistinct") << false << false;
+    QTest::newRow("bindable") << QByteArray("bindable") << true << true;
+    QTest::newRow("readonlyBindable") << QByteArray("readonlyBindable") << false << true;
+}
+
+// What QML sees: writability, bindability, and a NOTIFY signal on each.
+void TestPropertyMacros::metaProperties()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(bool, writable);
+    QFETCH(bool, bindable);
+
+    const QMetaObject& meta = PropertyHolder::staticMetaObject;
+    const int index = meta.indexOfProperty(name.constData());
+    QVERIFY(index >= 0);
+    const QMetaProperty property = meta.property(index);
+    QCOMPARE(property.isWritable(), writable);
+    QCOMPARE(property.isBindable(), bindable);
+    QVERIFY(property.hasNotifySignal());
+    QCOMPARE(property.notifySignal().name(), name + "Changed");
+}
+
+QTEST_GUILESS_MAIN(TestPropertyMacros)
+#include "tst_propertymacros.moc"
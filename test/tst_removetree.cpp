@@ -0,0 +1,251 @@
+#include <UDRemoveTree.h>
+#include <UDTools.h>
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+// depth levels of fanout subdirectories, each holding files plain files and
+// a hidden one. Returns the number of entries below root.
+qint64 makeTree(const QString& root, int depth, int fanout, int files)
+{
+    qint64 entries = 0;
+    for (int f = 0; f < files; ++f) {
+        QFile file(QStringLiteral("%1/file-%2").arg(root).arg(f));
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write("x");
+            ++entries;
+        }
+    }
+    QFile hidden(root + QStringLiteral("/.hidden"));
+    if (hidden.open(QIODevice::WriteOnly)) {
+        ++entries;
+    }
+    if (depth == 0) {
+        return entries;
+    }
+    for (int d = 0; d < fanout; ++d) {
+        const QString dir = QStringLiteral("%1/dir-%2").arg(root).arg(d);
+        if (QDir().mkdir(dir)) {
+            entries += 1 + makeTree(dir, depth - 1, fanout, files);
+        }
+    }
+    return entries;
+}
+
+} // namespace
+
+class TestRemoveTree : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void removesTree_data();
+    void removesTree();
+    void symlinksAreNotFollowed();
+    void leavesNonDirectoriesAlone();
+    void cancelledBeforeStart();
+    void cancelledWhileRunning();
+    void reportsFailures();
+    void asyncProgressAndFinish();
+    void asyncCancel();
+};
+
+void TestRemoveTree::removesTree_data()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("fanout");
+    QTest::addColumn<int>("files");
+
+    QTest::newRow("single") << 0 << 0 << 0;
+    QTest::newRow("flat") << 0 << 0 << 2000;
+    QTest::newRow("deep") << 60 << 1 << 3;
+    QTest::newRow("wide") << 3 << 8 << 20;
+}
+
+void TestRemoveTree::removesTree()
+{
+    QFETCH(int, depth);
+    QFETCH(int, fanout);
+    QFETCH(int, files);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    const qint64 entries = makeTree(root, depth, fanout, files);
+
+    RemoveTreeState state;
+    QVERIFY(removeTree(root, state));
+    QVERIFY(!QFileInfo::exists(root));
+    // Everything below root, and root itself.
+    QCOMPARE(state.removed.load(), entries + 1);
+    QCOMPARE(state.failed.load(), qint64(0));
+}
+
+void TestRemoveTree::symlinksAreNotFollowed()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString outside = dir.filePath(QStringLiteral("outside"));
+    QVERIFY(QDir().mkdir(outside));
+    makeTree(outside, 1, 2, 2);
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    QVERIFY(QFile::link(outside, root + QStringLiteral("/link-to-dir")));
+    QVERIFY(QFile::link(outside + QStringLiteral("/file-0"), root + QStringLiteral("/link-to-file")));
+
+    RemoveTreeState state;
+    QVERIFY(removeTree(root, state));
+    QVERIFY(!QFileInfo::exists(root));
+    QVERIFY(QFileInfo::exists(outside + QStringLiteral("/dir-1/file-1")));
+    QVERIFY(QFileInfo::exists(outside + QStringLiteral("/file-0")));
+
+    // Nor is a symlink given as the path itself.
+    const QString link = dir.filePath(QStringLiteral("link"));
+    QVERIFY(QFile::link(outside, link));
+    QVERIFY(removeTree(link, state));
+    QVERIFY(QFileInfo(link).isSymLink());
+    QVERIFY(QFileInfo::exists(outside + QStringLiteral("/dir-1/file-1")));
+}
+
+void TestRemoveTree::leavesNonDirectoriesAlone()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("file"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    RemoveTreeState state;
+    QVERIFY(removeTree(path, state));
+    QVERIFY(QFileInfo::exists(path));
+    QVERIFY(removeTree(dir.filePath(QStringLiteral("missing")), state));
+    QCOMPARE(state.removed.load(), qint64(0));
+}
+
+void TestRemoveTree::cancelledBeforeStart()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    makeTree(root, 2, 3, 5);
+
+    RemoveTreeState state;
+    state.cancelled = true;
+    QVERIFY(!removeTree(root, state));
+    QVERIFY(QFileInfo::exists(root + QStringLiteral("/dir-2/dir-2/file-4")));
+    QCOMPARE(state.removed.load(), qint64(0));
+}
+
+void TestRemoveTree::cancelledWhileRunning()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    const qint64 entries = makeTree(root, 3, 10, 20);
+
+    RemoveTreeState state;
+    bool ok = true;
+    std::thread remover([&] { ok = removeTree(root, state); });
+    QTRY_VERIFY(state.removed > 0 || !QFileInfo::exists(root));
+    state.cancelled = true;
+    remover.join();
+
+    // Either it won the race and finished, or it stopped part way and left
+    // the root and its remaining entries in place.
+    if (state.removed < entries + 1) {
+        QVERIFY(!ok);
+        QVERIFY(QFileInfo::exists(root));
+    }
+    // What is left can still be removed.
+    RemoveTreeState rest;
+    QVERIFY(removeTree(root, rest));
+    QCOMPARE(state.removed + rest.removed, entries + 1);
+}
+
+void TestRemoveTree::reportsFailures()
+{
+    if (::geteuid() == 0) {
+        QSKIP("root ignores directory permissions");
+    }
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    makeTree(root, 1, 2, 3);
+    const QString locked = root + QStringLiteral("/dir-1");
+    QVERIFY(QFile::setPermissions(locked, QFileDevice::ReadOwner | QFileDevice::ExeOwner));
+
+    RemoveTreeState state;
+    QVERIFY(!removeTree(root, state));
+    QVERIFY(state.failed > 0);
+    QVERIFY(QFileInfo::exists(locked + QStringLiteral("/file-0")));
+    // The rest of the tree is gone.
+    QVERIFY(!QFileInfo::exists(root + QStringLiteral("/dir-0")));
+    QVERIFY(QFile::setPermissions(locked, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner));
+}
+
+void TestRemoveTree::asyncProgressAndFinish()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    const qint64 entries = makeTree(root, 2, 10, 50);
+
+    LingmoTools* tools = LingmoTools::getInstance();
+    QSignalSpy progress(tools, &LingmoTools::removeDirProgress);
+    QSignalSpy finished(tools, &LingmoTools::removeDirFinished);
+    const int id = tools->removeDirAsync(root);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 30000);
+    QCOMPARE(finished.at(0).at(0).toInt(), id);
+    QVERIFY(finished.at(0).at(1).toBool());
+    QVERIFY(!QFileInfo::exists(root));
+
+    // Progress only ever grows, and the last report, sent just before
+    // removeDirFinished, has the final count.
+    QVERIFY(!progress.isEmpty());
+    qint64 previous = 0;
+    for (const QList<QVariant>& report : std::as_const(progress)) {
+        QCOMPARE(report.at(0).toInt(), id);
+        QVERIFY(report.at(1).toLongLong() >= previous);
+        previous = report.at(1).toLongLong();
+    }
+    QCOMPARE(previous, entries + 1);
+}
+
+void TestRemoveTree::asyncCancel()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString root = dir.filePath(QStringLiteral("tree"));
+    QVERIFY(QDir().mkdir(root));
+    makeTree(root, 3, 10, 20);
+
+    LingmoTools* tools = LingmoTools::getInstance();
+    QSignalSpy finished(tools, &LingmoTools::removeDirFinished);
+    const int id = tools->removeDirAsync(root);
+    tools->cancelRemoveDir(id);
+    QTRY_COMPARE_WITH_TIMEOUT(finished.count(), 1, 30000);
+    QCOMPARE(finished.at(0).at(0).toInt(), id);
+    // Cancelled before or during the walk; the root outlives either.
+    QVERIFY(!finished.at(0).at(1).toBool());
+    QVERIFY(QFileInfo::exists(root));
+    // Unknown and finished ids are ignored.
+    tools->cancelRemoveDir(id);
+    tools->cancelRemoveDir(-1);
+}
+
+QTEST_MAIN(TestRemoveTree)
+#include "tst_removetree.moc"
@@ -0,0 +1,150 @@
+#include <UDTools.h>
+
+#include <QCursor>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QScreen>
+#include <QSignalSpy>
+#include <QTest>
+#include <qpa/qplatformnativeinterface.h>
+
+namespace {
+
+QJsonObject screenConfig(const QString& name, const QRect& geometry)
+{
+    return {
+        { QStringLiteral("name"), name },
+        { QStringLiteral("x"), geometry.x() },
+        { QStringLiteral("y"), geometry.y() },
+        { QStringLiteral("width"), geometry.width() },
+        { QStringLiteral("height"), geometry.height() },
+        { QStringLiteral("logicalDpi"), 96 },
+        { QStringLiteral("logicalBaseDpi"), 96 },
+        { QStringLiteral("dpr"), 1 },
+    };
+}
+
+} // namespace
+
+// LingmoTools' screen properties on the offscreen platform plugin, whose
+// screens are added, moved and removed through its native interface.
+class TestScreenModel : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void layout();
+    void cursorScreen();
+    void notifiesOnlyOnChange();
+    void addAndRemove();
+
+private:
+    void setScreens(const QList<QPair<QString, QRect>>& screens);
+
+    using SetConfiguration = void (*)(const QJsonObject&, void*);
+    SetConfiguration _setConfiguration = nullptr;
+    void* _integration = nullptr;
+};
+
+void TestScreenModel::initTestCase()
+{
+    if (QGuiApplication::platformName() != QLatin1String("offscreen")) {
+        QSKIP("needs QT_QPA_PLATFORM=offscreen");
+    }
+    QPlatformNativeInterface* native = QGuiApplication::platformNativeInterface();
+    QVERIFY(native);
+    QFunctionPointer function = native->platformFunction("setConfiguration");
+    if (!function) {
+        function = native->nativeResourceFunctionForIntegration("setConfiguration");
+    }
+    if (!function) {
+        QSKIP("this offscreen plugin cannot change its screens");
+    }
+    _setConfiguration = reinterpret_cast<SetConfiguration>(function);
+    _integration = native->nativeResourceForIntegration("QOffscreenIntegration");
+}
+
+void TestScreenModel::init()
+{
+    setScreens({ { QStringLiteral("left"), { 0, 0, 1920, 1080 } }, { QStringLiteral("right"), { 1920, 0, 1280, 1024 } } });
+}
+
+void TestScreenModel::setScreens(const QList<QPair<QString, QRect>>& screens)
+{
+    QJsonArray array;
+    for (const auto& [name, geometry] : screens) {
+        array.append(screenConfig(name, geometry));
+    }
+    _setConfiguration({ { QStringLiteral("screens"), array } }, _integration);
+    QTRY_COMPARE(QGuiApplication::screens().size(), screens.size());
+    for (qsizetype i = 0; i < screens.size(); ++i) {
+        QTRY_COMPARE(QGuiApplication::screens().at(i)->geometry(), screens[i].second);
+    }
+}
+
+void TestScreenModel::layout()
+{
+    LingmoTools* tools = LingmoTools::getInstance();
+    QTRY_COMPARE(tools->screenCount(), 2);
+    QCOMPARE(tools->screenGeometries(), (QVariantList { QRect(0, 0, 1920, 1080), QRect(1920, 0, 1280, 1024) }));
+    QCOMPARE(tools->availableGeometries().size(), qsizetype(2));
+    QCOMPARE(tools->getVirtualGeometry(), QGuiApplication::primaryScreen()->virtualGeometry());
+}
+
+void TestScreenModel::cursorScreen()
+{
+    LingmoTools* tools = LingmoTools::getInstance();
+    QTRY_COMPARE(tools->screenCount(), 2);
+
+    QCursor::setPos(100, 100);
+    QCOMPARE(tools->cursorScreenIndex(), 0);
+    QCursor::setPos(2000, 500);
+    QCOMPARE(tools->cursorScreenIndex(), 1);
+    // Below the shorter right screen: no screen, so the first.
+    QCursor::setPos(2000, 1050);
+    QCOMPARE(tools->cursorScreenIndex(), 0);
+}
+
+void TestScreenModel::notifiesOnlyOnChange()
+{
+    LingmoTools* tools = LingmoTools::getInstance();
+    QTRY_COMPARE(tools->screenCount(), 2);
+    QSignalSpy changed(tools, &LingmoTools::screensChanged);
+
+    // The same layout again changes nothing.
+    init();
+    QTest::qWait(100);
+    QCOMPARE(changed.count(), 0);
+
+    // One move is one notification, although geometryChanged and
+    // availableGeometryChanged both fire for it.
+    setScreens({ { QStringLiteral("left"), { 0, 0, 1920, 1080 } }, { QStringLiteral("right"), { 1920, 56, 1280, 1024 } } });
+    QTRY_COMPARE(changed.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(tools->screenGeometries().at(1).toRect(), QRect(1920, 56, 1280, 1024));
+}
+
+void TestScreenModel::addAndRemove()
+{
+    LingmoTools* tools = LingmoTools::getInstance();
+    QTRY_COMPARE(tools->screenCount(), 2);
+    QSignalSpy changed(tools, &LingmoTools::screensChanged);
+
+    setScreens({ { QStringLiteral("left"), { 0, 0, 1920, 1080 } }, { QStringLiteral("right"), { 1920, 0, 1280, 1024 } },
+        { QStringLiteral("top"), { 0, -900, 1600, 900 } } });
+    QTRY_COMPARE(tools->screenCount(), 3);
+    QVERIFY(tools->screenGeometries().contains(QRect(0, -900, 1600, 900)));
+    QCursor::setPos(800, -10);
+    QCOMPARE(tools->cursorScreenIndex(), int(tools->screenGeometries().indexOf(QRect(0, -900, 1600, 900))));
+
+    init();
+    QTRY_COMPARE(tools->screenCount(), 2);
+    QVERIFY(!tools->screenGeometries().contains(QRect(0, -900, 1600, 900)));
+    QVERIFY(changed.count() >= 2);
+}
+
+QTEST_MAIN(TestScreenModel)
+#include "tst_screenmodel.moc"
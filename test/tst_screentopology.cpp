@@ -0,0 +1,137 @@
+#include <UDScreenTopology.h>
+
+#include <QRandomGenerator>
+#include <QTest>
+
+namespace {
+
+// What cursorScreenIndex() used to do: the first screen containing pos.
+int linearIndexAt(const QList<QRect>& geometries, const QPoint& pos)
+{
+    for (int i = 0; i < geometries.size(); ++i) {
+        if (geometries[i].contains(pos)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ScreenTopology topologyOf(const QList<QRect>& geometries)
+{
+    QRect virtualGeometry;
+    for (const QRect& rect : geometries) {
+        virtualGeometry |= rect;
+    }
+    return ScreenTopology(geometries, geometries, virtualGeometry);
+}
+
+} // namespace
+
+class TestScreenTopology : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void layouts_data();
+    void layouts();
+    void randomLayouts();
+    void edges();
+    void empty();
+    void equality();
+};
+
+void TestScreenTopology::layouts_data()
+{
+    QTest::addColumn<QList<QRect>>("geometries");
+
+    QTest::newRow("single") << QList<QRect> { { 0, 0, 1920, 1080 } };
+    QTest::newRow("side-by-side") << QList<QRect> { { 0, 0, 1920, 1080 }, { 1920, 0, 2560, 1440 } };
+    // A laptop below and left of a taller monitor: the gaps belong to nobody.
+    QTest::newRow("staggered") << QList<QRect> { { 0, 600, 1366, 768 }, { 1366, 0, 1440, 2560 } };
+    QTest::newRow("negative") << QList<QRect> { { -1920, -200, 1920, 1080 }, { 0, 0, 1920, 1080 } };
+    // Mirrored outputs and a smaller screen inside a larger one: first wins.
+    QTest::newRow("mirrored") << QList<QRect> { { 0, 0, 1920, 1080 }, { 0, 0, 1920, 1080 } };
+    QTest::newRow("nested") << QList<QRect> { { 100, 100, 800, 600 }, { 0, 0, 1920, 1080 } };
+    QTest::newRow("grid") << QList<QRect> { { 0, 0, 1000, 1000 }, { 1000, 0, 1000, 1000 }, { 0, 1000, 1000, 1000 },
+        { 1000, 1000, 1000, 1000 } };
+    QTest::newRow("with-empty") << QList<QRect> { { 0, 0, 1920, 1080 }, {}, { 1920, 0, 1920, 1080 } };
+}
+
+// Every point on a grid over and around the screens, plus every corner and
+// the points just outside each edge.
+void TestScreenTopology::layouts()
+{
+    QFETCH(QList<QRect>, geometries);
+
+    const ScreenTopology topology = topologyOf(geometries);
+    QCOMPARE(topology.count(), int(geometries.size()));
+    const QRect bounds = topology.virtualGeometry().adjusted(-50, -50, 50, 50);
+    for (int y = bounds.top(); y <= bounds.bottom(); y += 37) {
+        for (int x = bounds.left(); x <= bounds.right(); x += 41) {
+            const QPoint pos(x, y);
+            QCOMPARE(topology.indexAt(pos), linearIndexAt(geometries, pos));
+        }
+    }
+    for (const QRect& rect : geometries) {
+        for (int dx : { -1, 0, 1 }) {
+            for (int dy : { -1, 0, 1 }) {
+                for (const QPoint& corner : { rect.topLeft(), rect.topRight(), rect.bottomLeft(), rect.bottomRight() }) {
+                    const QPoint pos = corner + QPoint(dx, dy);
+                    QCOMPARE(topology.indexAt(pos), linearIndexAt(geometries, pos));
+                }
+            }
+        }
+    }
+}
+
+void TestScreenTopology::randomLayouts()
+{
+    QRandomGenerator random(13);
+    for (int round = 0; round < 200; ++round) {
+        QList<QRect> geometries;
+        const int count = random.bounded(1, 9);
+        for (int i = 0; i < count; ++i) {
+            geometries.append(QRect(random.bounded(-3000, 3000), random.bounded(-2000, 2000), random.bounded(0, 3000),
+                random.bounded(0, 2000)));
+        }
+        const ScreenTopology topology = topologyOf(geometries);
+        for (int probe = 0; probe < 500; ++probe) {
+            const QPoint pos(random.bounded(-3500, 6500), random.bounded(-2500, 4500));
+            QCOMPARE(topology.indexAt(pos), linearIndexAt(geometries, pos));
+        }
+    }
+}
+
+void TestScreenTopology::edges()
+{
+    const ScreenTopology topology = topologyOf({ { 0, 0, 1920, 1080 }, { 1920, 0, 1920, 1080 } });
+
+    QCOMPARE(topology.indexAt({ 0, 0 }), 0);
+    QCOMPARE(topology.indexAt({ 1919, 1079 }), 0);
+    QCOMPARE(topology.indexAt({ 1920, 0 }), 1);
+    QCOMPARE(topology.indexAt({ 3839, 1079 }), 1);
+    QCOMPARE(topology.indexAt({ 3840, 0 }), -1);
+    QCOMPARE(topology.indexAt({ 0, 1080 }), -1);
+    QCOMPARE(topology.indexAt({ -1, 0 }), -1);
+}
+
+void TestScreenTopology::empty()
+{
+    const ScreenTopology topology;
+    QCOMPARE(topology.count(), 0);
+    QCOMPARE(topology.indexAt({ 0, 0 }), -1);
+    QCOMPARE(topologyOf({ {} }).indexAt({ 0, 0 }), -1);
+}
+
+void TestScreenTopology::equality()
+{
+    const QList<QRect> geometries { { 0, 0, 1920, 1080 }, { 1920, 0, 1920, 1080 } };
+    QVERIFY(topologyOf(geometries) == topologyOf(geometries));
+    QVERIFY(topologyOf(geometries) != topologyOf({ { 0, 0, 1920, 1080 } }));
+
+    // Same geometries, different available areas (a panel appeared).
+    const QList<QRect> available { { 0, 0, 1920, 1040 }, { 1920, 0, 1920, 1080 } };
+    QVERIFY(ScreenTopology(geometries, geometries, {}) != ScreenTopology(geometries, available, {}));
+}
+
+QTEST_GUILESS_MAIN(TestScreenTopology)
+#include "tst_screentopology.moc"
@@ -0,0 +1,133 @@
+#include <singleton.h>
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTest>
+#include <QThread>
+
+#include <atomic>
+
+// What the services below did, in order, as "A+" for construction and "A-"
+// for destruction.
+static QStringList events;
+static std::atomic<QThread*> warmUpThread { nullptr };
+
+class ServiceA : public QObject {
+    Q_OBJECT
+    SINGLETON(ServiceA)
+
+private:
+    ServiceA() { events << QStringLiteral("A+"); }
+
+public:
+    ~ServiceA() override { events << QStringLiteral("A-"); }
+};
+
+class ServiceB : public QObject {
+    Q_OBJECT
+    SINGLETON(ServiceB)
+
+private:
+    // Needs A, so A is always the older of the two.
+    ServiceB()
+    {
+        ServiceA::getInstance();
+        events << QStringLiteral("B+");
+    }
+
+public:
+    ~ServiceB() override { events << QStringLiteral("B-"); }
+};
+
+class WarmedService : public QObject {
+    Q_OBJECT
+    SINGLETON(WarmedService)
+
+private:
+    WarmedService() { warmUpThread.store(QThread::currentThread()); }
+};
+
+class TestServiceRegistry : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void lazyConstruction();
+    void shutdownNewestFirst();
+    void recreatedAfterShutdown();
+    void warmUpMovesToAppThread();
+};
+
+static const ServiceRegistry::Timing* findTiming(const QList<ServiceRegistry::Timing>& timings, const char* name)
+{
+    for (const ServiceRegistry::Timing& timing : timings) {
+        if (timing.name == QLatin1String(name)) {
+            return &timing;
+        }
+    }
+    return nullptr;
+}
+
+void TestServiceRegistry::init()
+{
+    ServiceRegistry::instance().shutdown();
+    events.clear();
+}
+
+void TestServiceRegistry::lazyConstruction()
+{
+    QVERIFY(!findTiming(ServiceRegistry::instance().timings(), "ServiceA"));
+    QVERIFY(events.isEmpty());
+
+    ServiceA* service = ServiceA::getInstance();
+    QCOMPARE(ServiceA::getInstance(), service);
+    QCOMPARE(events, QStringList { QStringLiteral("A+") });
+
+    const QList<ServiceRegistry::Timing> timings = ServiceRegistry::instance().timings();
+    QCOMPARE(timings.size(), qsizetype(1));
+    QVERIFY(findTiming(timings, "ServiceA"));
+    QVERIFY(timings.first().mainThread);
+    QVERIFY(timings.first().nanoseconds >= 0);
+}
+
+void TestServiceRegistry::shutdownNewestFirst()
+{
+    ServiceB::getInstance();
+    QCOMPARE(events, (QStringList { QStringLiteral("A+"), QStringLiteral("B+") }));
+
+    ServiceRegistry::instance().shutdown();
+    QCOMPARE(events, (QStringList { QStringLiteral("A+"), QStringLiteral("B+"), QStringLiteral("B-"), QStringLiteral("A-") }));
+    QVERIFY(ServiceRegistry::instance().timings().isEmpty());
+}
+
+void TestServiceRegistry::recreatedAfterShutdown()
+{
+    ServiceA::getInstance();
+    ServiceRegistry::instance().shutdown();
+    QCOMPARE(events, (QStringList { QStringLiteral("A+"), QStringLiteral("A-") }));
+
+    QVERIFY(ServiceA::getInstance());
+    QCOMPARE(events, (QStringList { QStringLiteral("A+"), QStringLiteral("A-"), QStringLiteral("A+") }));
+    QVERIFY(findTiming(ServiceRegistry::instance().timings(), "ServiceA"));
+}
+
+void TestServiceRegistry::warmUpMovesToAppThread()
+{
+    ServiceRegistry::instance().warmUp<WarmedService>();
+    ServiceRegistry::instance().startWarmUp();
+    QTRY_VERIFY(findTiming(ServiceRegistry::instance().timings(), "WarmedService"));
+
+    QVERIFY(warmUpThread.load());
+    QVERIFY(warmUpThread.load() != QThread::currentThread());
+    QVERIFY(!findTiming(ServiceRegistry::instance().timings(), "WarmedService")->mainThread);
+
+    // Handed over to the application thread, so its queued calls run here.
+    WarmedService* service = WarmedService::getInstance();
+    QCOMPARE(service->thread(), QCoreApplication::instance()->thread());
+    QThread* calledOn = nullptr;
+    QMetaObject::invokeMethod(service, [&calledOn] { calledOn = QThread::currentThread(); }, Qt::QueuedConnection);
+    QTRY_COMPARE(calledOn, QThread::currentThread());
+}
+
+QTEST_GUILESS_MAIN(TestServiceRegistry)
+#include "tst_serviceregistry.moc"
@@ -0,0 +1,166 @@
+#include <UDStringSwitch.h>
+
+#include <QString>
+#include <QTest>
+
+// "cmd-0", "cmd-1", ... for tables too large to spell out. The text and the
+// pointers into it live in separate static objects, so the pointers stay
+// constant expressions.
+template <std::size_t N>
+struct KeyText {
+    char text[N][12] {};
+};
+
+template <std::size_t N>
+constexpr KeyText<N> keyText()
+{
+    KeyText<N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+        char digits[8] {};
+        std::size_t count = 0;
+        for (std::size_t value = i; count == 0 || value > 0; value /= 10) {
+            digits[count++] = char('0' + value % 10);
+        }
+        char* out = result.text[i];
+        for (const char c : { 'c', 'm', 'd', '-' }) {
+            *out++ = c;
+        }
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+    }
+    return result;
+}
+
+template <std::size_t N>
+struct KeyList {
+    const char* keys[N] {};
+};
+
+template <std::size_t N>
+constexpr KeyList<N> keyList(const KeyText<N>& text)
+{
+    KeyList<N> result;
+    for (std::size_t i = 0; i < N; ++i) {
+        result.keys[i] = text.text[i];
+    }
+    return result;
+}
+
+static constexpr KeyText<35> text35 = keyText<35>();
+static constexpr KeyList<35> list35 = keyList(text35);
+static constexpr KeyText<100> text100 = keyText<100>();
+static constexpr KeyList<100> list100 = keyList(text100);
+static constexpr KeyText<500> text500 = keyText<500>();
+static constexpr KeyList<500> list500 = keyList(text500);
+
+// Built at compile time, as the switches in the library are.
+static constexpr StringSwitch small { { "open", "close", "grüße", "日本語", "😀" } };
+static constexpr StringSwitch one { { "only" } };
+static constexpr StringSwitch switch35 { list35.keys };
+static constexpr StringSwitch switch100 { list100.keys };
+static constexpr StringSwitch switch500 { list500.keys };
+
+static_assert(small.caseOf("open") == 0 && small.caseOf("😀") == 4);
+static_assert(small("opened") == StringSwitch<5>::notFound);
+static_assert(switch500.caseOf("cmd-499") == 499);
+
+class TestStringSwitch : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void caseOf();
+    void hitsAndMisses();
+    void largeTables();
+    void utf16HashMatchesUtf8_data();
+    void utf16HashMatchesUtf8();
+};
+
+// Case labels are the key indices, in declaration order.
+void TestStringSwitch::caseOf()
+{
+    QCOMPARE(small.caseOf("open"), 0);
+    QCOMPARE(small.caseOf("close"), 1);
+    QCOMPARE(small.caseOf("grüße"), 2);
+    QCOMPARE(small.caseOf("日本語"), 3);
+    QCOMPARE(small.caseOf("😀"), 4);
+    QCOMPARE(one.caseOf("only"), 0);
+    for (int i = 0; i < int(small.size()); ++i) {
+        QCOMPARE(small.caseOf(small.key(i)), i);
+    }
+
+    int matched = -1;
+    switch (small(std::string_view("close"))) {
+    case small.caseOf("open"):
+        matched = 0;
+        break;
+    case small.caseOf("close"):
+        matched = 1;
+        break;
+    case StringSwitch<5>::notFound:
+        break;
+    }
+    QCOMPARE(matched, 1);
+}
+
+void TestStringSwitch::hitsAndMisses()
+{
+    for (int i = 0; i < int(small.size()); ++i) {
+        const std::string_view key = small.key(i);
+        QCOMPARE(small(key), i);
+        QCOMPARE(small(QStringView(QString::fromUtf8(key.data(), qsizetype(key.size())))), i);
+    }
+    for (const char* miss : { "", "ope", "opens", "Open", "close ", "gruße", "日本", "😁" }) {
+        QCOMPARE(small(std::string_view(miss)), StringSwitch<5>::notFound);
+        QCOMPARE(small(QStringView(QString::fromUtf8(miss))), StringSwitch<5>::notFound);
+    }
+    QCOMPARE(one(std::string_view("only")), 0);
+    QCOMPARE(one(std::string_view("other")), StringSwitch<1>::notFound);
+    QCOMPARE(one(QStringView(u"other")), StringSwitch<1>::notFound);
+}
+
+// Key counts a single hash seed could not lay out.
+void TestStringSwitch::largeTables()
+{
+    for (int i = 0; i < 35; ++i) {
+        QCOMPARE(switch35(std::string_view(list35.keys[i])), i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(switch100(std::string_view(list100.keys[i])), i);
+        QCOMPARE(switch100(QStringView(QString::fromLatin1(list100.keys[i]))), i);
+    }
+    for (int i = 0; i < 500; ++i) {
+        QCOMPARE(switch500(std::string_view(list500.keys[i])), i);
+    }
+    for (const char* miss : { "cmd-100", "cmd-", "cmd-0 ", "cmd-01", "dmc-1" }) {
+        QCOMPARE(switch100(std::string_view(miss)), StringSwitch<100>::notFound);
+    }
+    QCOMPARE(switch500(std::string_view("cmd-500")), StringSwitch<500>::notFound);
+}
+
+void TestStringSwitch::utf16HashMatchesUtf8_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QByteArray>("utf8");
+
+    QTest::newRow("ascii") << QStringLiteral("open") << QByteArray("open");
+    QTest::newRow("empty") << QString() << QByteArray();
+    QTest::newRow("latin-1") << QStringLiteral("grüße") << QByteArray("gr\xC3\xBC\xC3\x9F" "e");
+    QTest::newRow("cjk") << QStringLiteral("日本語") << QByteArray("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E");
+    QTest::newRow("surrogate pair") << QStringLiteral("😀") << QByteArray("\xF0\x9F\x98\x80");
+    // Unpaired surrogates encode as U+FFFD, as QString::toUtf8() does.
+    QTest::newRow("lone high surrogate") << QString(QChar(0xD83D)) << QByteArray("\xEF\xBF\xBD");
+    QTest::newRow("lone low surrogate") << (QStringLiteral("a") + QChar(0xDE00)) << QByteArray("a\xEF\xBF\xBD");
+}
+
+void TestStringSwitch::utf16HashMatchesUtf8()
+{
+    QFETCH(QString, text);
+    QFETCH(QByteArray, utf8);
+
+    QCOMPARE(text.toUtf8(), utf8);
+    QCOMPARE(hash_(QStringView(text)), hash_(std::string_view(utf8.constData(), std::size_t(utf8.size()))));
+}
+
+QTEST_GUILESS_MAIN(TestStringSwitch)
+#include "tst_stringswitch.moc"
@@ -0,0 +1,163 @@
+#include <UDUuid.h>
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QTest>
+#include <QUuid>
+
+#include <thread>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+class TestUuid : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void hexFormat();
+    void batchSizes_data();
+    void batchSizes();
+    void versionAndVariant();
+    void unique();
+    void uniqueAcrossThreads();
+    void freshAfterFork();
+};
+
+void TestUuid::hexFormat()
+{
+    const QRegularExpression shape(QStringLiteral("^[0-9a-f]{32}$"));
+    const QString hex = uuidHex();
+    QVERIFY2(shape.match(hex).hasMatch(), qPrintable(hex));
+    // The same value QUuid would print for these bytes.
+    const QUuid uuid = QUuid::fromRfc4122(QByteArray::fromHex(hex.toLatin1()));
+    QCOMPARE(uuid.toString(QUuid::Id128), hex);
+    for (const QString& each : uuidHexes(100)) {
+        QVERIFY2(shape.match(each).hasMatch(), qPrintable(each));
+    }
+    // The formatter the Python bindings share.
+    const QByteArray bytes = QByteArray::fromHex(hex.toLatin1());
+    char formatted[32];
+    uuidToHex(reinterpret_cast<const uchar*>(bytes.constData()), formatted);
+    QCOMPARE(QLatin1String(formatted, 32), hex);
+}
+
+void TestUuid::batchSizes_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("none") << 0;
+    QTest::newRow("negative") << -5;
+    QTest::newRow("one") << 1;
+    // One past what a single refill of the per-thread buffer holds.
+    QTest::newRow("buffer+1") << 257;
+    QTest::newRow("many") << 10000;
+}
+
+void TestUuid::batchSizes()
+{
+    QFETCH(int, count);
+
+    const qsizetype expected = qMax(count, 0);
+    QCOMPARE(uuidHexes(count).size(), expected);
+    QCOMPARE(uuidBytes(count).size(), expected * 16);
+}
+
+void TestUuid::versionAndVariant()
+{
+    const QByteArray bytes = uuidBytes(1000);
+    for (qsizetype offset = 0; offset < bytes.size(); offset += 16) {
+        const QUuid uuid = QUuid::fromRfc4122(bytes.mid(offset, 16));
+        QCOMPARE(uuid.version(), QUuid::Random);
+        QCOMPARE(uuid.variant(), QUuid::DCE);
+    }
+    for (const QString& hex : uuidHexes(1000)) {
+        const QUuid uuid = QUuid::fromRfc4122(QByteArray::fromHex(hex.toLatin1()));
+        QCOMPARE(uuid.version(), QUuid::Random);
+        QCOMPARE(uuid.variant(), QUuid::DCE);
+    }
+}
+
+void TestUuid::unique()
+{
+    QSet<QString> seen;
+    for (const QString& hex : uuidHexes(50000)) {
+        seen.insert(hex);
+    }
+    for (int i = 0; i < 50000; ++i) {
+        seen.insert(uuidHex());
+    }
+    QCOMPARE(seen.size(), qsizetype(100000));
+}
+
+// Each thread has its own buffer; none of them may repeat another's bytes.
+void TestUuid::uniqueAcrossThreads()
+{
+    constexpr int threadCount = 8;
+    constexpr int perThread = 20000;
+    std::vector<QStringList> results(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&results, t] {
+            for (int i = 0; i < perThread / 2; ++i) {
+                results[t] << uuidHex();
+            }
+            results[t] << uuidHexes(perThread / 2);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    QSet<QString> seen;
+    for (const QStringList& result : results) {
+        QCOMPARE(result.size(), qsizetype(perThread));
+        for (const QString& hex : result) {
+            seen.insert(hex);
+        }
+    }
+    QCOMPARE(seen.size(), qsizetype(threadCount * perThread));
+}
+
+// A forked child inherits the parent's half-used buffer; it must not hand
+// out the UUIDs the parent is about to.
+void TestUuid::freshAfterFork()
+{
+#if defined(Q_OS_UNIX)
+    QVERIFY(!uuidHex().isEmpty());
+    int fds[2];
+    QVERIFY(::pipe(fds) == 0);
+    const pid_t child = ::fork();
+    QVERIFY(child >= 0);
+    if (child == 0) {
+        ::close(fds[0]);
+        const QByteArray hex = uuidHex().toLatin1();
+        const bool written = ::write(fds[1], hex.constData(), size_t(hex.size())) == hex.size();
+        ::_exit(written ? 0 : 1);
+    }
+    ::close(fds[1]);
+    const QString parent = uuidHex();
+    char buffer[32];
+    qsizetype received = 0;
+    while (received < 32) {
+        const ssize_t n = ::read(fds[0], buffer + received, size_t(32 - received));
+        if (n <= 0) {
+            break;
+        }
+        received += n;
+    }
+    ::close(fds[0]);
+    int status = 0;
+    QCOMPARE(::waitpid(child, &status, 0), child);
+    QVERIFY(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    QCOMPARE(received, qsizetype(32));
+    QVERIFY(QLatin1String(buffer, 32) != parent);
+#else
+    QSKIP("no fork() here");
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestUuid)
+#include "tst_uuid.moc"
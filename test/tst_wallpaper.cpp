@@ -0,0 +1,183 @@
+#include <UDTools.h>
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QTest>
+
+// Answers the call LingmoTools makes on Plasma, on the private session bus.
+class PlasmaShellStandIn : public QObject, protected QDBusContext {
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.PlasmaShell")
+
+public:
+    QString image;
+    bool hang = false;
+    int calls = 0;
+
+public Q_SLOTS:
+    QVariantMap wallpaper(uint screen)
+    {
+        Q_UNUSED(screen)
+        ++calls;
+        if (hang) {
+            // Never answered: only the caller's timeout ends the call.
+            setDelayedReply(true);
+            return {};
+        }
+        return { { QStringLiteral("Image"), image } };
+    }
+};
+
+class TestWallpaper : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void resolvesFromService();
+    void hungServiceTimesOut();
+    void missingService();
+    void changesSkipEmptyReplies();
+
+private:
+    void announceChange();
+
+    QProcess _bus;
+    QString _address;
+    PlasmaShellStandIn _plasma;
+};
+
+void TestWallpaper::initTestCase()
+{
+    const QString product = QSysInfo::productType();
+    if (product == QLatin1String("uos") || product == QLatin1String("lingmo")) {
+        QSKIP("this system asks its own desktop service instead of Plasma");
+    }
+    const QString daemon = QStandardPaths::findExecutable(QStringLiteral("dbus-daemon"));
+    if (daemon.isEmpty()) {
+        QSKIP("dbus-daemon is not installed");
+    }
+
+    _bus.start(daemon, { QStringLiteral("--session"), QStringLiteral("--nofork"), QStringLiteral("--print-address") });
+    QVERIFY(_bus.waitForReadyRead(5000));
+    _address = QString::fromUtf8(_bus.readLine().trimmed());
+    QVERIFY(!_address.isEmpty());
+
+    // Read on first use of the session bus, which nothing has touched yet.
+    qputenv("DBUS_SESSION_BUS_ADDRESS", _address.toUtf8());
+    qputenv("XDG_CURRENT_DESKTOP", "KDE");
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+}
+
+void TestWallpaper::cleanupTestCase()
+{
+    QDBusConnection::disconnectFromBus(QStringLiteral("standin"));
+    _bus.kill();
+    _bus.waitForFinished();
+}
+
+void TestWallpaper::init()
+{
+    // A connection of its own, so the stand-in answers like another process.
+    QDBusConnection connection = QDBusConnection::connectToBus(_address, QStringLiteral("standin"));
+    QVERIFY(connection.isConnected());
+    if (!connection.objectRegisteredAt(QStringLiteral("/PlasmaShell"))) {
+        QVERIFY(connection.registerObject(QStringLiteral("/PlasmaShell"), &_plasma, QDBusConnection::ExportAllSlots));
+    }
+    QVERIFY(connection.registerService(QStringLiteral("org.kde.plasmashell")));
+    _plasma.image = QStringLiteral("/usr/share/wallpapers/Next/contents/images/1920x1080.png");
+    _plasma.hang = false;
+    _plasma.calls = 0;
+}
+
+void TestWallpaper::resolvesFromService()
+{
+    LingmoTools* tools = LingmoTools::getInstance();
+    QSignalSpy resolved(tools, &LingmoTools::wallpaperPathResolved);
+
+    QFuture<QString> future = tools->wallpaperFilePathAsync(2000);
+    QVERIFY(!future.isFinished());
+    QTRY_COMPARE(resolved.count(), 1);
+    QCOMPARE(resolved.at(0).at(0).toString(), _plasma.image);
+    QVERIFY(future.isFinished());
+    QCOMPARE(future.result(), _plasma.image);
+    QCOMPARE(_plasma.calls, 1);
+}
+
+void TestWallpaper::hungServiceTimesOut()
+{
+    _plasma.hang = true;
+    LingmoTools* tools = LingmoTools::getInstance();
+    QSignalSpy resolved(tools, &LingmoTools::wallpaperPathResolved);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Failed to query wallpaper:")));
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    QFuture<QString> future = tools->wallpaperFilePathAsync(300);
+    // Returns at once; the event loop keeps running while the call is out.
+    QVERIFY(elapsed.elapsed() < 100);
+    QTRY_COMPARE_WITH_TIMEOUT(resolved.count(), 1, 5000);
+    QVERIFY(elapsed.elapsed() >= 300);
+    QVERIFY(elapsed.elapsed() < 5000);
+    QCOMPARE(future.result(), QString());
+    QCOMPARE(_plasma.calls, 1);
+}
+
+void TestWallpaper::missingService()
+{
+    QDBusConnection connection(QStringLiteral("standin"));
+    QVERIFY(connection.unregisterService(QStringLiteral("org.kde.plasmashell")));
+
+    LingmoTools* tools = LingmoTools::getInstance();
+    QSignalSpy resolved(tools, &LingmoTools::wallpaperPathResolved);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("^Failed to query wallpaper:")));
+
+    QFuture<QString> future = tools->wallpaperFilePathAsync(2000);
+    QTRY_COMPARE(resolved.count(), 1);
+    QCOMPARE(future.result(), QString());
+    QCOMPARE(_plasma.calls, 0);
+}
+
+void TestWallpaper::announceChange()
+{
+    QDBusConnection connection(QStringLiteral("standin"));
+    QVERIFY(connection.send(QDBusMessage::createSignal(
+        QStringLiteral("/PlasmaShell"), QStringLiteral("org.kde.PlasmaShell"), QStringLiteral("wallpaperChanged"))));
+}
+
+// Last: the first connection to wallpaperChanged starts the watch for good.
+void TestWallpaper::changesSkipEmptyReplies()
+{
+    LingmoTools* tools = LingmoTools::getInstance();
+    QSignalSpy changed(tools, &LingmoTools::wallpaperChanged);
+
+    // The initial query only seeds the current path.
+    QTRY_COMPARE(_plasma.calls, 1);
+    QTest::qWait(100);
+    QCOMPARE(changed.count(), 0);
+
+    // A reply without an image is not a change to an empty wallpaper.
+    _plasma.image.clear();
+    announceChange();
+    QTRY_COMPARE(_plasma.calls, 2);
+    QTest::qWait(100);
+    QCOMPARE(changed.count(), 0);
+
+    _plasma.image = QStringLiteral("/usr/share/wallpapers/Kay/contents/images/1920x1080.png");
+    announceChange();
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).toString(), _plasma.image);
+    QCOMPARE(_plasma.calls, 3);
+}
+
+QTEST_MAIN(TestWallpaper)
+#include "tst_wallpaper.moc"
@@ -0,0 +1,160 @@
+#include "testimages.h"
+
+#include <UDImageColor.h>
+#include <UDWallpaperCache.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImageReader>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+class TestWallpaperCache : public QObject {
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void hitsAndMisses();
+    void mtimeInvalidates();
+    void palettePerCount_data();
+    void palettePerCount();
+    void evictsLeastRecentlyUsed();
+
+private:
+    QString writeImage(const QString& name, const QImage& image);
+
+    QTemporaryDir _dir;
+    LingmoWallpaperCache* _cache = nullptr;
+};
+
+static QImage filledImage(const QColor& color, int size = 64)
+{
+    QImage image(size, size, QImage::Format_RGB32);
+    image.fill(color);
+    return image;
+}
+
+QString TestWallpaperCache::writeImage(const QString& name, const QImage& image)
+{
+    const QString path = _dir.filePath(name);
+    if (!image.save(path, "PNG")) {
+        return {};
+    }
+    return path;
+}
+
+void TestWallpaperCache::initTestCase()
+{
+    // Keeps the cache out of the user's own cache directory.
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(_dir.isValid());
+    _cache = LingmoWallpaperCache::getInstance();
+}
+
+void TestWallpaperCache::init()
+{
+    _cache->clear();
+}
+
+void TestWallpaperCache::hitsAndMisses()
+{
+    const QString path = writeImage(QStringLiteral("red.png"), filledImage(Qt::red));
+    QVERIFY(!path.isEmpty());
+    QSignalSpy hitsChanged(_cache, &LingmoWallpaperCache::hitsChanged);
+    const int hits = _cache->hits();
+    const int misses = _cache->misses();
+
+    QCOMPARE(_cache->mainColor(path), QColor(Qt::red));
+    QCOMPARE(_cache->misses(), misses + 1);
+    QCOMPARE(_cache->hits(), hits);
+
+    QCOMPARE(_cache->mainColor(path), QColor(Qt::red));
+    const QUrl thumbnail = _cache->thumbnail(path);
+    QCOMPARE(_cache->misses(), misses + 1);
+    QCOMPARE(_cache->hits(), hits + 2);
+    QCOMPARE(hitsChanged.count(), 2);
+    QVERIFY(QFile::exists(thumbnail.toLocalFile()));
+    QVERIFY(!QImage(thumbnail.toLocalFile()).isNull());
+
+    // Nothing to look up, so neither counter moves.
+    QVERIFY(!_cache->mainColor(_dir.filePath(QStringLiteral("missing.png"))).isValid());
+    QCOMPARE(_cache->misses(), misses + 1);
+    QCOMPARE(_cache->hits(), hits + 2);
+}
+
+void TestWallpaperCache::mtimeInvalidates()
+{
+    const QString path = writeImage(QStringLiteral("changing.png"), filledImage(Qt::red));
+    QVERIFY(!path.isEmpty());
+    QCOMPARE(_cache->mainColor(path), QColor(Qt::red));
+
+    // Same size on disk, so only the modification time tells them apart.
+    QVERIFY(!writeImage(QStringLiteral("changing.png"), filledImage(Qt::blue)).isEmpty());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+    file.close();
+
+    const int misses = _cache->misses();
+    QCOMPARE(_cache->mainColor(path), QColor(Qt::blue));
+    QCOMPARE(_cache->misses(), misses + 1);
+}
+
+void TestWallpaperCache::palettePerCount_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("5") << 5;
+    QTest::newRow("3") << 3;
+    QTest::newRow("8") << 8;
+}
+
+void TestWallpaperCache::palettePerCount()
+{
+    QFETCH(int, count);
+    const QString path = writeImage(QStringLiteral("noise.png"), noiseImage(1280, 800, QImage::Format_RGB32, 7));
+    QVERIFY(!path.isEmpty());
+    // The palette of the full image, not of the thumbnail.
+    const QVariantList expected = paletteToVariant(extractPalette(QImageReader(path).read(), count));
+
+    QCOMPARE(_cache->palette(path, count), expected);
+    const int misses = _cache->misses();
+    QCOMPARE(_cache->palette(path, count), expected);
+    QCOMPARE(_cache->palette(path, 5), paletteToVariant(extractPalette(QImageReader(path).read(), 5)));
+    QCOMPARE(_cache->misses(), misses);
+}
+
+void TestWallpaperCache::evictsLeastRecentlyUsed()
+{
+    const int count = LingmoWallpaperCache::maxEntries + 1;
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        paths << writeImage(QStringLiteral("%1.png").arg(i), filledImage(QColor::fromRgb(i, 255 - i, (i * 7) % 256), 8));
+        QVERIFY(!paths.last().isEmpty());
+    }
+    // Apart by a few milliseconds each, so every entry was used at a
+    // different time.
+    for (int i = 0; i < count - 1; ++i) {
+        QVERIFY(_cache->mainColor(paths[i]).isValid());
+        QTest::qSleep(2);
+    }
+    QVERIFY(_cache->mainColor(paths[0]).isValid());
+    QTest::qSleep(2);
+    QVERIFY(_cache->mainColor(paths[count - 1]).isValid());
+
+    const QStringList thumbnails = QDir(_cache->cacheDir()).entryList({ QStringLiteral("*.png") }, QDir::Files);
+    QCOMPARE(thumbnails.size(), qsizetype(LingmoWallpaperCache::maxEntries));
+
+    // The first one was used again, so the second is the one that went.
+    const int misses = _cache->misses();
+    QVERIFY(_cache->mainColor(paths[0]).isValid());
+    QCOMPARE(_cache->misses(), misses);
+    QVERIFY(_cache->mainColor(paths[1]).isValid());
+    QCOMPARE(_cache->misses(), misses + 1);
+}
+
+QTEST_MAIN(TestWallpaperCache)
+#include "tst_wallpapercache.moc"
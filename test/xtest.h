@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+
+#include <initializer_list>
+#include <iterator>
+
+// Xlib's macros (None, Bool, KeyPress...) clash with Qt names, so this comes
+// after every Qt header in the files that include it.
+#include <X11/Xlib.h>
+#include <X11/extensions/XTest.h>
+#include <X11/keysym.h>
+
+// Key presses injected through the XTest extension, for the tests that run
+// under xvfb-run. Uses its own connection to the display Qt is on.
+class XTestKeyboard {
+public:
+    XTestKeyboard()
+        : _display(XOpenDisplay(nullptr))
+    {
+        int event = 0, error = 0, major = 0, minor = 0;
+        _valid = _display && XTestQueryExtension(_display, &event, &error, &major, &minor);
+    }
+    ~XTestKeyboard()
+    {
+        if (_display) {
+            XCloseDisplay(_display);
+        }
+    }
+    XTestKeyboard(const XTestKeyboard&) = delete;
+    XTestKeyboard& operator=(const XTestKeyboard&) = delete;
+
+    bool isValid() const { return _valid; }
+
+    // Press keys in order, or release them in reverse order, and send the
+    // events to the server at once.
+    void press(std::initializer_list<KeySym> keys)
+    {
+        for (const KeySym key : keys) {
+            XTestFakeKeyEvent(_display, XKeysymToKeycode(_display, key), True, CurrentTime);
+        }
+        XFlush(_display);
+    }
+    void release(std::initializer_list<KeySym> keys)
+    {
+        for (auto it = std::rbegin(keys); it != std::rend(keys); ++it) {
+            XTestFakeKeyEvent(_display, XKeysymToKeycode(_display, *it), False, CurrentTime);
+        }
+        XFlush(_display);
+    }
+
+private:
+    Display* _display = nullptr;
+    bool _valid = false;
+};
+
+// Process Qt events until done() returns true or timeoutMs passes.
+template <typename Done>
+bool processEventsUntil(Done done, int timeoutMs = 2000)
+{
+    const QDeadlineTimer deadline(timeoutMs);
+    while (!done()) {
+        if (deadline.hasExpired()) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    return true;
+}